@@ -0,0 +1,142 @@
+#ifndef AGGREGATE_HPP
+#define AGGREGATE_HPP
+
+#include <array>
+#include <cstddef>
+#include <limits>
+
+#include "Data.hpp"
+
+using namespace std;
+
+/**
+ * @brief Klasa przechowująca zagregowane wartości (sumy, wartości skrajne i liczbę rekordów) dla fragmentu danych.
+ *
+ * Każdy rok, miesiąc, dzień i kubełek ma swój agregat obejmujący wszystkie jego rekordy.
+ * Agregaty są aktualizowane przy każdym wstawieniu lub zmianie rekordu, więc zapytania
+ * o sumy i średnie mogą korzystać z nich dla węzłów leżących w całości w przedziale,
+ * zamiast odwiedzać pojedyncze rekordy. Wartości minimalne i maksymalne pełnią rolę mapy
+ * stref (zone map): wyszukiwanie pomija węzły, których zakres wartości nie obejmuje szukanej.
+ */
+class Aggregate {
+public:
+    /**
+     * @brief Dodaje rekord do agregatu.
+     *
+     * @param data Rekord do dodania.
+     */
+    void Add(const Data& data);
+
+    /**
+     * @brief Zastępuje w agregacie rekord dodany wcześniej nowym rekordem.
+     *
+     * Sumy są zmieniane o różnicę wartości, a wartości skrajne rozszerzane o nowy rekord.
+     * Wartości skrajnej równej wartości zastąpionej nie da się poprawić bez pozostałych
+     * rekordów - wtedy trzeba ją złożyć na nowo (`SetExtremes`).
+     *
+     * @param previous Zastępowany rekord.
+     * @param current Nowy rekord.
+     * @return `true`, jeśli zastąpiona wartość była wartością skrajną i wartości skrajne mogą być nieaktualne.
+     */
+    bool Replace(const Data& previous, const Data& current);
+
+    /**
+     * @brief Przepisuje wartości skrajne z innego agregatu, nie zmieniając sum ani liczby rekordów.
+     *
+     * @param source Agregat złożony na nowo z rekordów lub agregatów elementów podrzędnych.
+     */
+    void SetExtremes(const Aggregate& source);
+
+    /**
+     * @brief Sprawdza, czy agregaty mają te same wartości skrajne wszystkich wielkości.
+     *
+     * @param other Agregat do porównania.
+     * @return `true`, jeśli wartości minimalne i maksymalne są równe.
+     */
+    [[nodiscard]] bool HasSameExtremes(const Aggregate& other) const;
+
+    /**
+     * @brief Zeruje agregat.
+     */
+    void Clear();
+
+    /**
+     * @brief Dodaje do agregatu wszystkie wartości innego agregatu.
+     *
+     * @param other Agregat do dołączenia.
+     */
+    void Merge(const Aggregate& other);
+
+    /**
+     * @brief Zwraca sumę wartości wskazanej wielkości.
+     *
+     * @param metric Wielkość.
+     * @return Suma wartości (w watach [W]).
+     */
+    [[nodiscard]] long double GetSum(Metric metric) const;
+
+    /**
+     * @brief Zwraca najmniejszą wartość wielkości.
+     *
+     * @param metric Wielkość.
+     * @return Wartość minimalna (nieskończoność dodatnia dla pustego agregatu).
+     */
+    [[nodiscard]] double GetMin(Metric metric) const;
+
+    /**
+     * @brief Zwraca największą wartość wielkości.
+     *
+     * @param metric Wielkość.
+     * @return Wartość maksymalna (nieskończoność ujemna dla pustego agregatu).
+     */
+    [[nodiscard]] double GetMax(Metric metric) const;
+
+    /**
+     * @brief Sprawdza, czy agregat może zawierać rekord z wartością wielkości w przedziale [low, high].
+     *
+     * @param metric Wielkość.
+     * @param low Dolna granica przedziału.
+     * @param high Górna granica przedziału.
+     * @return `false`, jeśli żaden rekord agregatu nie ma wartości w przedziale.
+     */
+    [[nodiscard]] bool MayContain(Metric metric, long double low, long double high) const;
+
+    /**
+     * @brief Zwraca liczbę rekordów w agregacie.
+     *
+     * @return Liczba rekordów.
+     */
+    [[nodiscard]] size_t GetCount() const;
+
+private:
+    /**
+     * @brief Sumy wartości kolejnych wielkości (indeksowane wartością `Metric`).
+     */
+    array<long double, MetricCount> _sums{};
+    /**
+     * @brief Wartości minimalne wielkości (indeksowane wartością `Metric`).
+     */
+    array<double, MetricCount> _min = MakeFilled(numeric_limits<double>::infinity());
+    /**
+     * @brief Wartości maksymalne wielkości (indeksowane wartością `Metric`).
+     */
+    array<double, MetricCount> _max = MakeFilled(-numeric_limits<double>::infinity());
+    /**
+     * @brief Liczba rekordów.
+     */
+    size_t _count = 0;
+
+    /**
+     * @brief Tworzy tablicę wypełnioną jedną wartością.
+     *
+     * @param value Wartość elementów.
+     * @return Tablica wartości.
+     */
+    static constexpr array<double, MetricCount> MakeFilled(const double value) {
+        array<double, MetricCount> result{};
+        result.fill(value);
+        return result;
+    }
+};
+
+#endif //AGGREGATE_HPP
@@ -0,0 +1,131 @@
+#ifndef AGGREGATECUBE_HPP
+#define AGGREGATECUBE_HPP
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "Aggregate.hpp"
+#include "DateTime.hpp"
+#include "Day.hpp"
+
+using namespace std;
+
+/**
+ * @brief Kostka agregatów (rok × miesiąc × dzień tygodnia × 15-minutowy slot doby).
+ *
+ * Każda komórka kostki jest agregatem (sumy, wartości skrajne i liczba odczytów wszystkich
+ * wielkości) odczytów z jednego slotu doby we wszystkich dniach danego tygodnia danego miesiąca
+ * danego roku. Komórki roku są gęstą tablicą 12 × 7 × 96 agregatów tworzoną przy pierwszym
+ * odczycie z tego roku, a kostka jest aktualizowana przy każdym wstawieniu odczytu (patrz
+ * `EnergyAnalyzer::InsertData`).
+ *
+ * Zapytania (`RollUp`) wycinają z kostki komórki spełniające filtr i łączą je według jednego
+ * wymiaru - ich koszt zależy tylko od liczby lat, a nie od liczby odczytów.
+ *
+ * Odczyty z godziny powtarzanej przy zmianie czasu trafiają do slotów tej godziny.
+ */
+class AggregateCube {
+public:
+    /**
+     * @brief Wymiar, według którego łączone są komórki kostki.
+     */
+    enum class Dimension {
+        /** Rok (klucz RRRR). */
+        Year,
+        /** Miesiąc (klucz 1-12). */
+        Month,
+        /** Dzień tygodnia (klucz 0 - poniedziałek, ..., 6 - niedziela). */
+        DayOfWeek,
+        /** Godzina doby (klucz 0-23). */
+        Hour,
+        /** 15-minutowy slot doby (klucz 0-95). */
+        Slot
+    };
+
+    /**
+     * @brief Zbiór dni tygodnia (bit `1 << dzień`, 0 - poniedziałek).
+     */
+    using WeekdaySet = uint8_t;
+
+    /**
+     * @brief Wszystkie dni tygodnia.
+     */
+    static constexpr WeekdaySet AllWeekdays = 0x7F;
+
+    /**
+     * @brief Dni robocze (od poniedziałku do piątku).
+     */
+    static constexpr WeekdaySet WorkingDays = 0x1F;
+
+    /**
+     * @brief Sobota i niedziela.
+     */
+    static constexpr WeekdaySet Weekend = 0x60;
+
+    /**
+     * @brief Wycinek kostki.
+     */
+    struct Filter {
+        /**
+         * @brief Rok (0 - wszystkie lata).
+         */
+        int Year = 0;
+        /**
+         * @brief Miesiąc 1-12 (0 - wszystkie miesiące).
+         */
+        int Month = 0;
+        /**
+         * @brief Dni tygodnia.
+         */
+        WeekdaySet Weekdays = AllWeekdays;
+    };
+
+    /**
+     * @brief Dodaje odczyt do komórki kostki.
+     *
+     * @param dateTime Data i godzina odczytu.
+     * @param data Odczyt.
+     */
+    void Add(const DateTime& dateTime, const Data& data);
+
+    /**
+     * @brief Zwraca komórkę kostki, tworząc w razie potrzeby komórki roku.
+     *
+     * @param dateTime Data i godzina wyznaczająca komórkę.
+     * @return Referencja do agregatu komórki.
+     */
+    Aggregate& GetCell(const DateTime& dateTime);
+
+    /**
+     * @brief Łączy komórki wycinka kostki według wymiaru.
+     *
+     * @param by Wymiar, według którego łączone są komórki.
+     * @param filter Wycinek kostki.
+     * @return Niepuste agregaty uporządkowane rosnąco według klucza wymiaru.
+     */
+    [[nodiscard]] map<int, Aggregate> RollUp(Dimension by, const Filter& filter) const;
+
+private:
+    /**
+     * @brief Liczba komórek jednego roku.
+     */
+    static constexpr int CellsPerYear = 12 * 7 * Day::SlotsPerDay;
+
+    /**
+     * @brief Komórki kolejnych lat (indeks komórki - patrz `GetCellIndex`).
+     */
+    map<int, vector<Aggregate>> _years;
+
+    /**
+     * @brief Wyznacza indeks komórki w tablicy roku.
+     *
+     * @param month Miesiąc (1-12).
+     * @param weekday Dzień tygodnia (0-6).
+     * @param slot Slot doby (0-95).
+     * @return Indeks komórki.
+     */
+    static int GetCellIndex(int month, int weekday, int slot);
+};
+
+#endif //AGGREGATECUBE_HPP
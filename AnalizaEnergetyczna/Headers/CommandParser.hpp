@@ -1,6 +1,7 @@
 #ifndef COMMANDPARSER_HPP
 #define COMMANDPARSER_HPP
 
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -41,11 +42,19 @@ public:
      */
     void ParseAndExecute(const string &command);
 
-private:
     /**
-     * @brief Referencja do obiektu `EnergyAnalyzer`, na którym będą wykonywane operacje.
+     * @brief Wyznacza przedział czasowy obejmujący wszystkie daty występujące w komendzie.
+     *
+     * Pozwala wczytać przed wykonaniem komendy tylko potrzebną część danych
+     * (patrz `EnergyAnalyzer::ExecuteIndexedCommand`). Daty są szukane po słowach kluczowych
+     * `OD` i `DO`, więc dla komendy `POROWNAJ` przedział obejmuje oba porównywane przedziały.
+     *
+     * @param command Komenda.
+     * @param start Najwcześniejsza data w komendzie (ustawiana tylko przy powodzeniu).
+     * @param end Najpóźniejsza data w komendzie (ustawiana tylko przy powodzeniu).
+     * @return true, jeśli komenda zawiera co najmniej jedną poprawną datę, false w przeciwnym razie.
      */
-    EnergyAnalyzer &_analyzer;
+    static bool GetCommandRange(const string &command, DateTime &start, DateTime &end);
 
     /**
      * @brief Dzieli łańcuch znaków na tokeny na podstawie podanego separatora.
@@ -68,6 +77,50 @@ private:
      */
     static DateTime *ParseDateTime(const vector<string> &tokens, size_t &index);
 
+    /**
+     * @brief Zamienia nazwę typu danych z komendy (np. `IMPORT`, `POBOR`) na wielkość.
+     *
+     * @param type Nazwa typu danych.
+     * @return Wielkość lub `nullopt`, jeśli nazwa jest nieznana.
+     */
+    [[nodiscard]] static optional<Metric> ParseMetric(const string &type);
+
+    /**
+     * @brief Wypisuje wynik komendy `SUMA`.
+     *
+     * @param metric Wielkość.
+     * @param sum Suma wartości w przedziale [W].
+     */
+    static void PrintSum(Metric metric, long double sum);
+
+    /**
+     * @brief Wypisuje wynik komendy `SREDNIA`.
+     *
+     * @param metric Wielkość.
+     * @param average Średnia wartości w przedziale [W].
+     */
+    static void PrintAverage(Metric metric, long double average);
+
+    /**
+     * @brief Wypisuje wynik komendy `POROWNAJ` - który przedział ma większą sumę i o ile.
+     *
+     * @param metric Wielkość.
+     * @param start1 Początek pierwszego przedziału.
+     * @param end1 Koniec pierwszego przedziału.
+     * @param sum1 Suma wartości w pierwszym przedziale [W].
+     * @param start2 Początek drugiego przedziału.
+     * @param end2 Koniec drugiego przedziału.
+     * @param sum2 Suma wartości w drugim przedziale [W].
+     */
+    static void PrintComparison(Metric metric, const DateTime &start1, const DateTime &end1, long double sum1,
+                                const DateTime &start2, const DateTime &end2, long double sum2);
+
+private:
+    /**
+     * @brief Referencja do obiektu `EnergyAnalyzer`, na którym będą wykonywane operacje.
+     */
+    EnergyAnalyzer &_analyzer;
+
     /**
      * @brief Wykonuje komendę `SUMA`.
      *
@@ -83,6 +136,7 @@ private:
      *
      * Parsuje argumenty komendy i wywołuje odpowiednie metody `EnergyAnalyzer`
      * w celu obliczenia średniej dla zadanego typu danych i przedziału czasowego.
+     * Opcjonalne słowo `POKRYCIE` na końcu komendy dopisuje pokrycie przedziału odczytami.
      *
      * @param tokens Wektor tokenów reprezentujących komendę.
      */
@@ -117,6 +171,164 @@ private:
      * @param tokens Wektor tokenów reprezentujących komendę.
      */
     void ExecutePrint(const vector<string> &tokens) const;
+
+    /**
+     * @brief Wykonuje komendę `BRAKI`.
+     *
+     * Parsuje argumenty komendy i wypisuje przedziały brakujących 15-minutowych odczytów
+     * w zadanym przedziale czasowym oraz pokrycie przedziału odczytami.
+     *
+     * @param tokens Wektor tokenów reprezentujących komendę.
+     */
+    void ExecuteMissing(const vector<string> &tokens) const;
+
+    /**
+     * @brief Wykonuje komendę `MAKS` lub `MIN`.
+     *
+     * Parsuje argumenty komendy i wypisuje największą lub najmniejszą wartość zadanego typu danych
+     * w przedziale czasowym wraz z datą i godziną odczytu, w którym wystąpiła.
+     *
+     * @param tokens Wektor tokenów reprezentujących komendę.
+     * @param maximum true dla komendy `MAKS`, false dla komendy `MIN`.
+     */
+    void ExecuteExtremum(const vector<string> &tokens, bool maximum) const;
+
+    /**
+     * @brief Wykonuje komendę `NAJWIEKSZE`.
+     *
+     * Parsuje argumenty komendy (`NAJWIEKSZE <N> <typ> OD ... DO ...`) i wypisuje N odczytów
+     * o największych wartościach zadanego typu danych w przedziale czasowym.
+     *
+     * @param tokens Wektor tokenów reprezentujących komendę.
+     */
+    void ExecuteTop(const vector<string> &tokens) const;
+
+    /**
+     * @brief Wykonuje komendę `PERCENTYL`.
+     *
+     * Parsuje argumenty komendy (`PERCENTYL <p> <typ> OD ... DO ... [DOKLADNIE]`) i wypisuje
+     * p-ty percentyl (0-100) wartości zadanego typu danych w przedziale czasowym - szacowany
+     * ze szkiców (`EnergyAnalyzer::EstimatePercentileInRange`) lub, z opcją `DOKLADNIE`,
+     * obliczony dokładnie (`EnergyAnalyzer::CalculatePercentileInRange`).
+     *
+     * @param tokens Wektor tokenów reprezentujących komendę.
+     */
+    void ExecutePercentile(const vector<string> &tokens) const;
+
+    /**
+     * @brief Wykonuje komendę `HISTOGRAM`.
+     *
+     * Parsuje argumenty komendy (`HISTOGRAM <N> <typ> OD ... DO ...`) i wypisuje liczby odczytów
+     * zadanego typu danych w N przedziałach wartości równej szerokości, od wartości najmniejszej
+     * do największej w przedziale czasowym.
+     *
+     * @param tokens Wektor tokenów reprezentujących komendę.
+     */
+    void ExecuteHistogram(const vector<string> &tokens) const;
+
+    /**
+     * @brief Wykonuje komendę `KRZYWA_TRWANIA`.
+     *
+     * Parsuje argumenty komendy (`KRZYWA_TRWANIA <N> <typ> OD ... DO ...`) i wypisuje N punktów
+     * krzywej trwania (wartości zadanego typu danych uporządkowanych malejąco) w przedziale czasowym.
+     *
+     * @param tokens Wektor tokenów reprezentujących komendę.
+     */
+    void ExecuteDurationCurve(const vector<string> &tokens) const;
+
+    /**
+     * @brief Wykonuje komendę `OKNO`.
+     *
+     * Parsuje argumenty komendy (`OKNO <typ> <szerokość> OD ... DO ... [PLIK <ścieżka>]`, szerokość
+     * np. `15M`, `1H`, `24H`, `7D`) i dla każdego odczytu z przedziału czasowego wypisuje sumę,
+     * średnią, wartości skrajne i liczbę odczytów zadanego typu danych w oknie kroczącym kończącym
+     * się tym odczytem. Z opcją `PLIK` okna są zapisywane na bieżąco do pliku CSV.
+     *
+     * @param tokens Wektor tokenów reprezentujących komendę.
+     */
+    void ExecuteWindow(const vector<string> &tokens) const;
+
+    /**
+     * @brief Wykonuje komendę `GRUPUJ`.
+     *
+     * Parsuje argumenty komendy (`GRUPUJ <typ> PO GODZINA|DZIEN_TYGODNIA|DZIEN|MIESIAC OD ... DO ...`)
+     * i wypisuje sumę, średnią, wartości skrajne i liczbę odczytów zadanego typu danych w każdej grupie.
+     *
+     * @param tokens Wektor tokenów reprezentujących komendę.
+     */
+    void ExecuteGroup(const vector<string> &tokens) const;
+
+    /**
+     * @brief Wykonuje komendę `KOSTKA`.
+     *
+     * Parsuje argumenty komendy (`KOSTKA <typ> PO ROK|MIESIAC|DZIEN_TYGODNIA|GODZINA|KWADRANS`
+     * z opcjonalnymi filtrami `ROK <rok>`, `MIESIAC <1-12>` i `DNI ROBOCZE|WEEKEND`) i wypisuje
+     * wycinek kostki agregatów (`EnergyAnalyzer::RollUpCube`) zwinięty według wymiaru.
+     *
+     * @param tokens Wektor tokenów reprezentujących komendę.
+     */
+    void ExecuteCube(const vector<string> &tokens) const;
+
+    /**
+     * @brief Parsuje nieujemną liczbę całkowitą z argumentu komendy (np. liczbę odczytów).
+     *
+     * Przy błędzie wypisuje komunikat z opisem argumentu.
+     *
+     * @param token Argument komendy.
+     * @param description Opis argumentu w komunikacie błędu.
+     * @return Liczba lub `nullopt`, jeśli argument nie jest poprawną liczbą.
+     */
+    [[nodiscard]] static optional<size_t> ParseCount(const string &token, const string &description);
+
+    /**
+     * @brief Parsuje szerokość okna kroczącego (liczba z jednostką `M` - minuty, `H` - godziny, `D` - dni).
+     *
+     * Przy błędzie wypisuje komunikat.
+     *
+     * @param token Argument komendy.
+     * @return Szerokość w minutach lub `nullopt`, jeśli argument jest niepoprawny lub przekracza
+     *         `EnergyAnalyzer::MaxWindowMinutes`.
+     */
+    [[nodiscard]] static optional<int> ParseWindowWidth(const string &token);
+
+    /**
+     * @brief Wypisuje sumę, średnią, wartości skrajne i liczbę odczytów wielkości w grupie.
+     *
+     * @param label Etykieta grupy.
+     * @param totals Agregat grupy.
+     * @param metric Wielkość.
+     */
+    static void PrintTotals(const string &label, const Aggregate &totals, Metric metric);
+
+    /**
+     * @brief Opisy wielkości w wynikach komend `SUMA`, `SREDNIA` i `POROWNAJ`.
+     */
+    struct MetricLabels {
+        /** Etykieta sumy. */
+        const char *Sum;
+        /** Etykieta średniej. */
+        const char *Average;
+        /** Nazwa wielkości w zdaniu porównania ("ma większe ... energii"). */
+        const char *Comparison;
+    };
+
+    /**
+     * @brief Opisy kolejnych wielkości (indeksowane wartością `Metric`).
+     */
+    static constexpr MetricLabels Labels[] = {
+        {"Suma autokonsumpcji", "Średnia autokonsumpcja", "zużycie"},
+        {"Suma eksportu", "Średnia eksportu", "eksportowanie"},
+        {"Suma importu", "Średnia importu", "importowanie"},
+        {"Suma poboru", "Średnia poboru", "zużycie"},
+        {"Suma produkcji", "Średnia produkcji", "generowanie"}
+    };
+
+    /**
+     * @brief Nazwy dni tygodnia (0 - poniedziałek).
+     */
+    static constexpr const char *Weekdays[] = {
+        "Poniedziałek", "Wtorek", "Środa", "Czwartek", "Piątek", "Sobota", "Niedziela"
+    };
 };
 
 #endif //COMMANDPARSER_HPP
@@ -0,0 +1,69 @@
+#ifndef COMPRESSEDBLOCK_HPP
+#define COMPRESSEDBLOCK_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Aggregate.hpp"
+#include "Data.hpp"
+
+using namespace std;
+
+/**
+ * @brief Skompresowany blok danych pomiarowych jednego dnia (kolumnowy, w stylu Gorilla).
+ *
+ * Znaczniki czasu są zapisywane jako różnice drugiego rzędu (delta-of-delta) - przy stałym
+ * 15-minutowym odstępie każdy kolejny odczyt zajmuje jeden bit. Każda z wielkości jest
+ * osobną kolumną, w której wartość zapisywana jest jako XOR z poprzednią: powtarzające się
+ * wartości (np. zerowa produkcja w nocy) zajmują jeden bit, a podobne - tylko bity znaczące.
+ *
+ * Nagłówek bloku przechowuje liczbę rekordów, sumy oraz wartości minimalne i maksymalne
+ * każdej wielkości, więc zapytania agregujące nie muszą rozpakowywać bloku.
+ */
+class CompressedBlock {
+public:
+    /**
+     * @brief Konstruktor klasy CompressedBlock.
+     *
+     * @param data Rekordy dnia w porządku chronologicznym.
+     */
+    explicit CompressedBlock(const vector<Data>& data);
+
+    /**
+     * @brief Rozpakowuje blok.
+     *
+     * @return Rekordy dnia w porządku chronologicznym.
+     */
+    [[nodiscard]] vector<Data> Decode() const;
+
+    /**
+     * @brief Zwraca agregat (sumy, wartości skrajne i liczbę rekordów) z nagłówka bloku.
+     *
+     * @return Referencja do agregatu.
+     */
+    [[nodiscard]] const Aggregate& GetAggregate() const;
+
+    /**
+     * @brief Zwraca rozmiar skompresowanych danych w bajtach (bez nagłówka).
+     *
+     * @return Rozmiar w bajtach.
+     */
+    [[nodiscard]] size_t GetSizeInBytes() const;
+
+private:
+    /**
+     * @brief Sumy, wartości skrajne i liczba rekordów bloku.
+     */
+    Aggregate _aggregate;
+    /**
+     * @brief Godzina powtarzana przy zmianie czasu zawarta w bloku lub -1.
+     */
+    int _repeatedHour = -1;
+    /**
+     * @brief Strumień bitów: znaczniki czasu, a po nich kolejne kolumny wartości.
+     */
+    vector<uint64_t> _bits;
+};
+
+#endif //COMPRESSEDBLOCK_HPP
@@ -0,0 +1,166 @@
+#ifndef COMPRESSEDINPUT_HPP
+#define COMPRESSEDINPUT_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+
+using namespace std;
+
+/**
+ * @brief Klasa czytająca linie ze skompresowanego pliku (gzip lub zstd) bez rozpakowywania go na dysk.
+ *
+ * Dekompresja odbywa się w osobnym wątku, który wypełnia ograniczoną kolejkę bloków
+ * rozpakowanych danych - parsowanie linii (`ReadLine`) przebiega równolegle z dekompresją
+ * kolejnych bloków. Linie mieszczące się w jednym bloku są zwracane jako widok na blok, bez kopiowania.
+ *
+ * Obsługa formatów zależy od bibliotek dostępnych przy budowaniu (`ENERGY_HAVE_ZLIB`,
+ * `ENERGY_HAVE_ZSTD`); otwarcie pliku w nieobsługiwanym formacie zgłasza wyjątek.
+ */
+class CompressedInput {
+public:
+    /**
+     * @brief Format kompresji pliku.
+     */
+    enum class Format {
+        /** Plik nieskompresowany. */
+        None,
+        /** Plik gzip (także wieloczłonowy, np. po `cat a.gz b.gz`). */
+        Gzip,
+        /** Plik zstd. */
+        Zstd
+    };
+
+    /**
+     * @brief Rozpoznaje format pliku po jego pierwszych bajtach.
+     *
+     * @param filepath Ścieżka do pliku.
+     * @return Format pliku (`Format::None` także wtedy, gdy pliku nie można otworzyć).
+     */
+    [[nodiscard]] static Format DetectFormat(const string& filepath);
+
+    /**
+     * @brief Otwiera plik i uruchamia wątek dekompresji.
+     *
+     * @param filepath Ścieżka do pliku.
+     * @param format Format pliku (inny niż `Format::None`).
+     * @throws std::runtime_error Jeśli nie można otworzyć pliku lub format nie jest obsługiwany.
+     */
+    CompressedInput(const string& filepath, Format format);
+
+    /**
+     * @brief Zatrzymuje wątek dekompresji i czeka na jego zakończenie.
+     */
+    ~CompressedInput();
+
+    CompressedInput(const CompressedInput&) = delete;
+    CompressedInput& operator=(const CompressedInput&) = delete;
+
+    /**
+     * @brief Odczytuje kolejną linię rozpakowanych danych (bez znaku końca linii).
+     *
+     * @param line Widok na linię, ważny do następnego wywołania.
+     * @return true, jeśli odczytano linię, false na końcu danych.
+     * @throws std::runtime_error Jeśli plik jest uszkodzony.
+     */
+    bool ReadLine(string_view& line);
+
+private:
+    /**
+     * @brief Rozmiar bloku odczytywanego z pliku i bloku rozpakowanych danych (w bajtach).
+     */
+    static constexpr size_t ChunkSize = 256 * 1024;
+
+    /**
+     * @brief Największa liczba rozpakowanych bloków czekających na parsowanie.
+     */
+    static constexpr size_t MaxQueuedChunks = 8;
+
+    /**
+     * @brief Ścieżka do pliku.
+     */
+    string _filepath;
+
+    /**
+     * @brief Rozpakowane bloki czekające na parsowanie.
+     */
+    deque<string> _chunks;
+
+    /**
+     * @brief Czy wątek dekompresji zakończył pracę.
+     */
+    bool _finished = false;
+
+    /**
+     * @brief Błąd zgłoszony przez wątek dekompresji.
+     */
+    exception_ptr _error;
+
+    /**
+     * @brief Blokada kolejki bloków.
+     */
+    mutex _mutex;
+
+    /**
+     * @brief Powiadamia o zmianie stanu kolejki bloków.
+     */
+    condition_variable_any _changed;
+
+    /**
+     * @brief Blok, z którego są aktualnie odczytywane linie.
+     */
+    string _current;
+
+    /**
+     * @brief Pozycja w bloku `_current`, od której zaczyna się kolejna linia.
+     */
+    size_t _position = 0;
+
+    /**
+     * @brief Linia rozciągająca się na kilka bloków, składana przed zwróceniem.
+     */
+    string _line;
+
+    /**
+     * @brief Wątek dekompresji.
+     */
+    jthread _thread;
+
+    /**
+     * @brief Przekazuje rozpakowany blok do kolejki, czekając, aż zwolni się w niej miejsce.
+     *
+     * @param token Token zatrzymania wątku dekompresji.
+     * @param chunk Rozpakowany blok.
+     * @return false, jeśli zażądano zatrzymania wątku, true w przeciwnym razie.
+     */
+    bool Push(const stop_token& token, string&& chunk);
+
+    /**
+     * @brief Pobiera z kolejki następny blok rozpakowanych danych do `_current`.
+     *
+     * @return false, jeśli dane się skończyły, true w przeciwnym razie.
+     */
+    bool NextChunk();
+
+    /**
+     * @brief Rozpakowuje plik gzip (wykonywane w wątku dekompresji).
+     *
+     * @param token Token zatrzymania wątku.
+     */
+    void DecompressGzip(const stop_token& token);
+
+    /**
+     * @brief Rozpakowuje plik zstd (wykonywane w wątku dekompresji).
+     *
+     * @param token Token zatrzymania wątku.
+     */
+    void DecompressZstd(const stop_token& token);
+};
+
+#endif //COMPRESSEDINPUT_HPP
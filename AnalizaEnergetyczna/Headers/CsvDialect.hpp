@@ -0,0 +1,79 @@
+#ifndef CSVDIALECT_HPP
+#define CSVDIALECT_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Układ daty i godziny w pierwszej kolumnie pliku CSV.
+ */
+enum class DateLayout {
+    /** `DD.MM.RRRR GG:MM` (eksport falownika). */
+    DayMonthYear,
+    /** `RRRR-MM-DD GG:MM[:SS]` lub `RRRR-MM-DDTGG:MM[:SS]` (ISO 8601, sekundy są pomijane). */
+    Iso
+};
+
+/**
+ * @brief Opis odmiany (dialektu) pliku CSV z pomiarami energii.
+ *
+ * Kolejność kolumn jest we wszystkich odmianach taka sama: data i godzina, autokonsumpcja,
+ * eksport, import, zużycie i produkcja. Odmiany różnią się separatorem pól, cudzysłowami
+ * wokół wartości, separatorem dziesiętnym i układem daty.
+ */
+struct CsvDialect {
+    /**
+     * @brief Znak oddzielający pola (`,`, `;` lub tabulator).
+     */
+    char Separator;
+    /**
+     * @brief Czy pola mogą być ujęte w cudzysłowy (wtedy separator może wystąpić wewnątrz pola).
+     */
+    bool Quoted;
+    /**
+     * @brief Separator dziesiętny (`.` lub `,`).
+     */
+    char Decimal;
+    /**
+     * @brief Układ daty i godziny.
+     */
+    DateLayout Layout;
+
+    /**
+     * @brief Liczba pierwszych linii danych, na podstawie których rozpoznawana jest odmiana pliku.
+     */
+    static constexpr size_t SampleLines = 32;
+
+    /**
+     * @brief Rozpoznaje odmianę pliku na podstawie nagłówka i pierwszych linii danych.
+     *
+     * Separatorem pól jest najczęstszy z kandydatów (`,`, `;`, tabulator) w nagłówku, a układ daty
+     * wynika z pozycji pierwszego myślnika w pierwszym polu pierwszej linii. Separatorem
+     * dziesiętnym jest przecinek, jeśli występuje w którejś z wartości, a kropka - jeśli występuje
+     * kropka. Gdy wszystkie wartości są całkowite (np. same zera o północy), przecinek dziesiętny
+     * jest przyjmowany dla separatora pól `;`, a kropka dla pozostałych.
+     *
+     * @param header Nagłówek pliku.
+     * @param lines Pierwsze linie danych (może być pusty - wtedy przyjmowane są ustawienia eksportu falownika).
+     * @return Rozpoznana odmiana.
+     */
+    [[nodiscard]] static CsvDialect Detect(string_view header, const vector<string_view>& lines);
+
+    /**
+     * @brief Rozpoznaje odmianę pliku (także skompresowanego) na podstawie nagłówka i `SampleLines` pierwszych linii danych.
+     *
+     * @param filepath Ścieżka do pliku CSV.
+     * @return Rozpoznana odmiana (ustawienia eksportu falownika, jeśli pliku nie można odczytać).
+     */
+    [[nodiscard]] static CsvDialect DetectFile(const string& filepath);
+};
+
+/**
+ * @brief Odmiana pliku eksportowanego przez falownik: `DD.MM.RRRR GG:MM,"wartość",...` z kropką dziesiętną.
+ */
+constexpr CsvDialect ExporterDialect{',', true, '.', DateLayout::DayMonthYear};
+
+#endif //CSVDIALECT_HPP
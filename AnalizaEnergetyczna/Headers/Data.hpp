@@ -3,6 +3,29 @@
 
 #include "Time.hpp"
 
+/**
+ * @brief Wielkości mierzone w każdym rekordzie danych.
+ *
+ * Pozwala odwoływać się do wartości rekordu w sposób ogólny, np. w agregatach.
+ */
+enum class Metric {
+    /** Autokonsumpcja energii. */
+    AutoConsumption,
+    /** Eksport energii. */
+    Export,
+    /** Import energii. */
+    Import,
+    /** Zużycie energii (pobór). */
+    Consumption,
+    /** Produkcja energii. */
+    Generation
+};
+
+/**
+ * @brief Liczba wielkości mierzonych w rekordzie (elementów `Metric`).
+ */
+constexpr int MetricCount = 5;
+
 /**
  * @brief Klasa reprezentująca pojedynczy rekord danych z pomiarów energii.
  *
@@ -16,28 +39,21 @@ public:
      *
      * Tworzy obiekt Data z podanymi wartościami.
      *
-     * @param time Wskaźnik do obiektu Time reprezentującego czas pomiaru.
+     * @param time Czas pomiaru.
      * @param autoConsumption Wartość autokonsumpcji energii (w watach [W]).
      * @param exportW Wartość eksportu energii (w watach [W]).
      * @param importW Wartość importu energii (w watach [W]).
      * @param consumption Wartość zużycia energii (poboru) (w watach [W]).
      * @param generation Wartość produkcji energii (w watach [W]).
      */
-    Data(Time* time, double autoConsumption, double exportW, double importW, double consumption, double generation);
-
-    /**
-     * @brief Destruktor klasy Data.
-     *
-     * Zwalnia pamięć zaalokowaną dla obiektu Time.
-     */
-    ~Data();
+    Data(const Time& time, double autoConsumption, double exportW, double importW, double consumption, double generation);
 
     /**
      * @brief Zwraca referencję do obiektu Time reprezentującego czas pomiaru.
      *
      * @return Referencja do obiektu Time.
      */
-    [[nodiscard]] Time& GetTime() const;
+    [[nodiscard]] const Time& GetTime() const;
 
     /**
      * @brief Zwraca wartość autokonsumpcji energii.
@@ -74,11 +90,21 @@ public:
      */
     [[nodiscard]] double GetGeneration() const;
 
+    /**
+     * @brief Zwraca wartość wskazanej wielkości.
+     *
+     * @param metric Wielkość, której wartość należy zwrócić.
+     * @return Wartość wielkości (w watach [W]).
+     */
+    [[nodiscard]] double GetValue(Metric metric) const;
+
 private:
     /**
-     * @brief Wskaźnik do obiektu Time reprezentującego czas pomiaru.
+     * @brief Czas pomiaru.
+     *
+     * Przechowywany przez wartość, aby rekord nie wymagał dodatkowej alokacji.
      */
-    Time* _time;
+    Time _time;
     /**
      * @brief Wartość autokonsumpcji energii (w watach [W]).
      */
@@ -0,0 +1,239 @@
+#ifndef DATAVALIDATOR_HPP
+#define DATAVALIDATOR_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "EnergyData.hpp"
+
+using namespace std;
+
+/**
+ * @brief Reguła poprawności rekordu sprawdzana przy wczytywaniu.
+ */
+enum class ValidationRule {
+    /** Data nieistniejąca w kalendarzu lub godzina spoza doby (np. 31.02, miesiąc 13, godzina 24); zawsze odrzuca rekord. */
+    InvalidTimestamp,
+    /** Ujemna wartość którejś z wielkości. */
+    NegativeValue,
+    /** Zużycie różne od sumy importu i autokonsumpcji. */
+    ConsumptionBalance,
+    /** Produkcja różna od sumy autokonsumpcji i eksportu. */
+    GenerationBalance,
+    /** Produkcja w nocy (patrz `DataValidator::NightStartHour`, `DataValidator::NightEndHour`). */
+    NightGeneration
+};
+
+/**
+ * @brief Liczba reguł poprawności.
+ */
+constexpr int ValidationRuleCount = 5;
+
+/**
+ * @brief Zbiór reguł poprawności (bit `1 << ValidationRule` dla każdej reguły).
+ */
+using RuleSet = uint8_t;
+
+/**
+ * @brief Zwraca zbiór zawierający jedną regułę.
+ *
+ * @param rule Reguła.
+ * @return Zbiór reguł.
+ */
+constexpr RuleSet RuleOf(const ValidationRule rule) {
+    return static_cast<RuleSet>(1 << static_cast<int>(rule));
+}
+
+/**
+ * @brief Pusty zbiór reguł.
+ */
+constexpr RuleSet NoRules = 0;
+
+/**
+ * @brief Zbiór wszystkich reguł.
+ */
+constexpr RuleSet AllRules = (1 << ValidationRuleCount) - 1;
+
+/**
+ * @brief Reguły, których naruszenie domyślnie odrzuca rekord.
+ *
+ * Reguły bilansowe i produkcja w nocy są domyślnie tylko zliczane - eksporty falowników
+ * zaokrąglają wartości i potrafią raportować produkcję po zmroku.
+ */
+constexpr RuleSet DefaultRejectedRules = RuleOf(ValidationRule::InvalidTimestamp) |
+                                         RuleOf(ValidationRule::NegativeValue);
+
+/**
+ * @brief Rekord odrzucony przy wczytywaniu wraz z naruszonymi regułami.
+ */
+struct QuarantinedRecord {
+    /**
+     * @brief Odrzucony rekord.
+     */
+    EnergyData Record;
+    /**
+     * @brief Wszystkie reguły naruszone przez rekord.
+     */
+    RuleSet Violations;
+};
+
+/**
+ * @brief Etap wczytywania sprawdzający fizyczną spójność rekordów.
+ *
+ * Rekordy są sprawdzane partiami: wartości partii są przepisywane do osobnych tablic dla każdej
+ * wielkości, a każda reguła to jedna pętla bez rozgałęzień wyznaczająca bity naruszeń dla
+ * wszystkich rekordów partii - kompilator może ją zwektoryzować. Naruszenia każdej reguły są
+ * zliczane, a rekordy naruszające reguły odrzucane trafiają do kwarantanny zamiast do struktury danych.
+ *
+ * Wartości kolumn niewczytanych (NaN, patrz `ColumnSet`) nie naruszają żadnej reguły.
+ * Liczniki i kwarantanna są chronione blokadą - partie mogą pochodzić z wątku śledzącego plik.
+ */
+class DataValidator {
+public:
+    /**
+     * @brief Zalecana liczba rekordów sprawdzanych jedną partią.
+     */
+    static constexpr size_t BatchSize = 1024;
+
+    /**
+     * @brief Dopuszczalna bezwzględna różnica w regułach bilansowych (w watach [W]).
+     */
+    static constexpr double BalanceTolerance = 1.0;
+
+    /**
+     * @brief Dopuszczalna względna różnica w regułach bilansowych (część wartości bilansowanej).
+     */
+    static constexpr double BalanceRelativeTolerance = 0.01;
+
+    /**
+     * @brief Pierwsza godzina nocy (włącznie).
+     */
+    static constexpr int NightStartHour = 22;
+
+    /**
+     * @brief Godzina końca nocy (wyłącznie).
+     */
+    static constexpr int NightEndHour = 4;
+
+    /**
+     * @brief Największa produkcja w nocy niebędąca naruszeniem (pobór falownika w stanie czuwania) (w watach [W]).
+     */
+    static constexpr double NightGenerationLimit = 1.0;
+
+    /**
+     * @brief Największa liczba rekordów przechowywanych w kwarantannie; kolejne odrzucone rekordy są tylko zliczane.
+     */
+    static constexpr size_t QuarantineLimit = 10000;
+
+    /**
+     * @brief Konstruktor klasy DataValidator.
+     *
+     * Niepoprawny znacznik czasu odrzuca rekord zawsze - taki rekord nie ma miejsca w strukturze danych.
+     *
+     * @param rejected Reguły, których naruszenie odrzuca rekord (pozostałe są tylko zliczane).
+     */
+    explicit DataValidator(RuleSet rejected = DefaultRejectedRules);
+
+    /**
+     * @brief Zmienia reguły, których naruszenie odrzuca rekord (dotyczy kolejnych partii).
+     *
+     * Reguła `InvalidTimestamp` pozostaje zawsze włączona.
+     *
+     * @param rejected Reguły, których naruszenie odrzuca rekord.
+     */
+    void SetRejectedRules(RuleSet rejected);
+
+    /**
+     * @brief Sprawdza partię rekordów i usuwa z niej rekordy odrzucone.
+     *
+     * Kolejność pozostałych rekordów nie zmienia się.
+     *
+     * @param records Partia rekordów (odrzucone rekordy są przenoszone do kwarantanny).
+     * @return Liczba odrzuconych rekordów.
+     */
+    size_t Validate(vector<EnergyData>& records);
+
+    /**
+     * @brief Zwraca reguły, których naruszenie odrzuca rekord.
+     *
+     * @return Zbiór reguł.
+     */
+    [[nodiscard]] RuleSet GetRejectedRules() const;
+
+    /**
+     * @brief Zwraca liczbę sprawdzonych rekordów.
+     *
+     * @return Liczba rekordów.
+     */
+    [[nodiscard]] size_t GetCheckedCount() const;
+
+    /**
+     * @brief Zwraca liczbę rekordów naruszających regułę (także tych, które nie zostały odrzucone).
+     *
+     * @param rule Reguła.
+     * @return Liczba naruszeń.
+     */
+    [[nodiscard]] size_t GetViolationCount(ValidationRule rule) const;
+
+    /**
+     * @brief Zwraca liczbę odrzuconych rekordów.
+     *
+     * @return Liczba rekordów.
+     */
+    [[nodiscard]] size_t GetRejectedCount() const;
+
+    /**
+     * @brief Zwraca kopię rekordów z kwarantanny (najwyżej `QuarantineLimit` pierwszych odrzuconych).
+     *
+     * @return Odrzucone rekordy.
+     */
+    [[nodiscard]] vector<QuarantinedRecord> GetQuarantine() const;
+
+    /**
+     * @brief Zwraca nazwę reguły.
+     *
+     * @param rule Reguła.
+     * @return Nazwa reguły.
+     */
+    [[nodiscard]] static const char* GetRuleName(ValidationRule rule);
+
+private:
+    /**
+     * @brief Reguły, których naruszenie odrzuca rekord.
+     */
+    RuleSet _rejected;
+    /**
+     * @brief Liczba sprawdzonych rekordów.
+     */
+    size_t _checked = 0;
+    /**
+     * @brief Liczba naruszeń każdej reguły.
+     */
+    array<size_t, ValidationRuleCount> _violations{};
+    /**
+     * @brief Liczba odrzuconych rekordów.
+     */
+    size_t _rejectedCount = 0;
+    /**
+     * @brief Odrzucone rekordy.
+     */
+    vector<QuarantinedRecord> _quarantine;
+    /**
+     * @brief Blokada liczników i kwarantanny.
+     */
+    mutable mutex _mutex;
+
+    /**
+     * @brief Wyznacza bity naruszonych reguł dla fragmentu partii (najwyżej `BatchSize` rekordów).
+     *
+     * @param records Rekordy fragmentu.
+     * @param count Liczba rekordów fragmentu.
+     * @param violations Tablica na bity naruszeń (`count` elementów).
+     */
+    static void Check(const EnergyData* records, size_t count, RuleSet* violations);
+};
+
+#endif //DATAVALIDATOR_HPP
@@ -2,16 +2,24 @@
 #define DATE_TIME_HPP
 
 #include <string>
+#include <cstdint>
 
 using namespace std;
 
 /**
  * @brief Klasa reprezentująca datę i godzinę.
  *
- * Przechowuje informacje o dniu, miesiącu, roku, godzinie i minucie.
+ * Przechowuje informacje o dniu, miesiącu, roku, godzinie i minucie. Dla godziny powtarzanej
+ * przy zmianie czasu z letniego na zimowy przechowuje też znacznik drugiego wystąpienia,
+ * dzięki któremu oba odczyty z tą samą godziną lokalną pozostają odrębnymi chwilami.
  */
 class DateTime {
 public:
+    /**
+     * @brief Godzina, która w dniu zmiany czasu z letniego na zimowy występuje dwukrotnie (02:00 - 02:59).
+     */
+    static constexpr int FallBackHour = 2;
+
     /**
      * @brief Konstruktor klasy DateTime.
      *
@@ -22,8 +30,9 @@ public:
      * @param year Rok.
      * @param hour Godzina (0-23).
      * @param minute Minuta (0-59).
+     * @param repeated `true` dla drugiego wystąpienia godziny powtarzanej przy zmianie czasu.
      */
-    DateTime(int day, int month, int year, int hour, int minute);
+    DateTime(int day, int month, int year, int hour, int minute, bool repeated = false);
 
     /**
      * @brief Zwraca dzień.
@@ -60,6 +69,34 @@ public:
      */
     [[nodiscard]] int GetMinute() const;
 
+    /**
+     * @brief Sprawdza, czy jest to drugie wystąpienie godziny powtarzanej przy zmianie czasu.
+     *
+     * @return `true` dla drugiego wystąpienia, `false` w przeciwnym razie.
+     */
+    [[nodiscard]] bool IsRepeated() const;
+
+    /**
+     * @brief Sprawdza, czy data istnieje w kalendarzu (np. nie 31.02 ani 5.13), a godzina i minuta mieszczą się w dobie.
+     *
+     * @return `true` dla poprawnej daty i godziny, `false` w przeciwnym razie.
+     */
+    [[nodiscard]] bool IsValid() const;
+
+    /**
+     * @brief Zwraca dzień tygodnia.
+     *
+     * @return Dzień tygodnia (0 - poniedziałek, ..., 6 - niedziela).
+     */
+    [[nodiscard]] int GetDayOfWeek() const;
+
+    /**
+     * @brief Sprawdza, czy data jest dniem zmiany czasu z letniego na zimowy (ostatnia niedziela października).
+     *
+     * @return `true`, jeśli w tym dniu godzina `FallBackHour` występuje dwukrotnie.
+     */
+    [[nodiscard]] bool IsFallBackDay() const;
+
     /**
      * @brief Zwraca tekstową reprezentację daty i godziny w formacie RRRR-MM-DD GG:MM.
      *
@@ -67,6 +104,26 @@ public:
      */
     [[nodiscard]] string ToString() const;
 
+    /**
+     * @brief Zwraca spakowany znacznik czasu, którego porządek liczbowy odpowiada porządkowi chronologicznemu.
+     *
+     * Poszczególne pola zajmują kolejne grupy bitów (od najmłodszych): minuta (6 bitów),
+     * znacznik powtórzonej godziny (1 bit), godzina (5 bitów), dzień (5 bitów), miesiąc (4 bity)
+     * i rok (pozostałe bity). Drugie wystąpienie godziny powtarzanej trafia więc między
+     * pierwsze wystąpienie a następną godzinę.
+     *
+     * @return Klucz sortowania.
+     */
+    [[nodiscard]] uint64_t GetSortKey() const;
+
+    /**
+     * @brief Odtwarza datę i godzinę ze spakowanego znacznika czasu.
+     *
+     * @param key Klucz zwrócony wcześniej przez `GetSortKey`.
+     * @return Data i godzina zapisana w kluczu.
+     */
+    [[nodiscard]] static DateTime FromSortKey(uint64_t key);
+
 private:
     /**
      * @brief Dzień (1-31).
@@ -88,6 +145,10 @@ private:
      * @brief Minuta (0-59).
      */
     int _minute;
+    /**
+     * @brief Znacznik drugiego wystąpienia godziny powtarzanej przy zmianie czasu.
+     */
+    bool _repeated;
 };
 
 #endif //DATE_TIME_HPP
@@ -2,30 +2,60 @@
 #define DAY_HPP
 
 #include <array>
+#include <cstdint>
+#include <vector>
 
 #include "Quarter.hpp"
+#include "QuantileSketch.hpp"
+#include "CompressedBlock.hpp"
 
 /**
  * @brief Klasa reprezentująca dzień.
  *
- * Przechowuje informacje o numerze dnia oraz o czterech kwadransach (6-godzinnych okresach) tego dnia.
+ * Przechowuje informacje o numerze dnia oraz o kubełkach (przedziałach czasowych) tego dnia.
+ * Szerokość kubełka jest ustalana przy tworzeniu dnia (np. 15 minut, 1 godzina, 6 godzin),
+ * a kubełek dla danej minuty wyznaczany jest bezpośrednio z jej numeru.
+ *
+ * Dzień z danymi historycznymi można skompresować (`Compress`): kubełki są wtedy zastępowane
+ * jednym blokiem `CompressedBlock`, a agregat dnia pozostaje bez zmian.
+ *
+ * Dzień przechowuje też mapę bitową obecności odczytów w 15-minutowych slotach siatki dnia
+ * (bit `i` - slot zaczynający się w minucie `i * Quarter::SlotMinutes`). Mapa pozwala wyszukiwać
+ * braki danych bez odwiedzania kubełków i nie zmienia się przy kompresji.
  */
 class Day {
 public:
+    /**
+     * @brief Domyślna szerokość kubełka w minutach (cztery 6-godzinne okresy dnia).
+     */
+    static constexpr int DefaultBucketMinutes = 6 * 60;
+
+    /**
+     * @brief Liczba slotów w siatce dnia (bez slotów godziny powtarzanej przy zmianie czasu).
+     */
+    static constexpr int SlotsPerDay = 24 * 60 / Quarter::SlotMinutes;
+
+    /**
+     * @brief Liczba 64-bitowych słów mapy obecności.
+     */
+    static constexpr int PresenceWords = (SlotsPerDay + 63) / 64;
+
     /**
      * @brief Konstruktor klasy Day.
      *
      * Tworzy obiekt Day z podanym numerem dnia.
-     * Inicjalizuje tablicę kwadransów.
+     * Inicjalizuje wektor kubełków o podanej szerokości.
      *
      * @param day Numer dnia (1-31).
+     * @param bucketMinutes Szerokość kubełka w minutach.
+     * @throws std::invalid_argument Jeśli szerokość kubełka nie jest poprawna (patrz `IsValidBucketMinutes`).
      */
-    explicit Day(int day);
+    explicit Day(int day, int bucketMinutes = DefaultBucketMinutes);
 
     /**
      * @brief Destruktor klasy Day.
      *
-     * Zwalnia pamięć zaalokowaną dla obiektów Quarter.
+     * Zwalnia pamięć zaalokowaną dla obiektów Quarter oraz agregatu.
      */
     ~Day();
 
@@ -37,11 +67,111 @@ public:
     [[nodiscard]] int GetDay() const;
 
     /**
-     * @brief Zwraca tablicę wskaźników do obiektów Quarter reprezentujących kwadranse dnia.
+     * @brief Zwraca szerokość kubełka w minutach.
+     *
+     * @return Szerokość kubełka w minutach.
+     */
+    [[nodiscard]] int GetBucketMinutes() const;
+
+    /**
+     * @brief Zwraca slot na dane pomiarowe o podanym czasie.
+     *
+     * Kubełek jest wybierany bezpośrednio na podstawie minuty dnia, bez przeszukiwania
+     * wszystkich kubełków dnia.
+     *
+     * @param time Czas pomiaru.
+     * @return Wskaźnik do slotu lub `nullptr`, jeśli czas jest niepoprawny.
+     */
+    [[nodiscard]] optional<Data>* GetSlot(const Time& time) const;
+
+    /**
+     * @brief Zwraca kubełek przechowujący dane pomiarowe o podanym czasie.
+     *
+     * @param time Czas pomiaru.
+     * @return Wskaźnik do kubełka lub `nullptr`, jeśli czas jest niepoprawny.
+     */
+    [[nodiscard]] Quarter* GetQuarter(const Time& time) const;
+
+    /**
+     * @brief Zwraca wektor wskaźników do obiektów Quarter reprezentujących kubełki dnia.
+     *
+     * @return Referencja do wektora wskaźników do obiektów Quarter, uporządkowanego w czasie
+     *         (pustego, jeśli dzień jest skompresowany).
+     */
+    [[nodiscard]] const vector<Quarter*>& GetQuarters() const;
+
+    /**
+     * @brief Zwraca agregat (sumy i liczbę rekordów) wszystkich danych dnia.
+     *
+     * Agregat jest aktualizowany przy każdym wstawieniu lub zastąpieniu rekordu.
+     *
+     * @return Referencja do agregatu.
+     */
+    [[nodiscard]] Aggregate& GetAggregate() const;
+
+    /**
+     * @brief Zwraca szkic rozkładu wartości wszystkich danych dnia.
+     *
+     * Szkic jest aktualizowany przy każdym wstawieniu lub zastąpieniu rekordu i nie zmienia się przy kompresji.
+     *
+     * @return Referencja do szkicu.
+     */
+    [[nodiscard]] QuantileSketch& GetSketch() const;
+
+    /**
+     * @brief Sprawdza, czy podana szerokość kubełka może zostać użyta.
+     *
+     * Szerokość musi być wielokrotnością `Quarter::SlotMinutes` i dzielić dobę bez reszty.
      *
-     * @return Tablica wskaźników do obiektów Quarter.
+     * @param bucketMinutes Szerokość kubełka w minutach.
+     * @return `true`, jeśli szerokość jest poprawna, `false` w przeciwnym razie.
      */
-    [[nodiscard]] array<Quarter*, 4> GetQuarters() const;
+    [[nodiscard]] static bool IsValidBucketMinutes(int bucketMinutes);
+
+    /**
+     * @brief Kompresuje dane dnia - kubełki są zwalniane i zastępowane blokiem skompresowanym.
+     *
+     * Nie robi nic, jeśli dzień jest już skompresowany.
+     */
+    void Compress();
+
+    /**
+     * @brief Rozpakowuje dane dnia z powrotem do kubełków (np. przed wstawieniem nowego odczytu).
+     *
+     * Nie robi nic, jeśli dzień nie jest skompresowany.
+     */
+    void Decompress();
+
+    /**
+     * @brief Sprawdza, czy dane dnia są skompresowane.
+     *
+     * @return `true`, jeśli dzień jest skompresowany, `false` w przeciwnym razie.
+     */
+    [[nodiscard]] bool IsCompressed() const;
+
+    /**
+     * @brief Zwraca blok skompresowanych danych dnia.
+     *
+     * @return Wskaźnik do bloku lub `nullptr`, jeśli dzień nie jest skompresowany.
+     */
+    [[nodiscard]] const CompressedBlock* GetBlock() const;
+
+    /**
+     * @brief Zaznacza w mapie obecności slot odczytu o podanym czasie.
+     *
+     * Odczyty z godziny powtarzanej przy zmianie czasu nie należą do siatki dnia i są pomijane.
+     *
+     * @param time Czas odczytu.
+     */
+    void MarkPresent(const Time& time);
+
+    /**
+     * @brief Zwraca słowo mapy obecności.
+     *
+     * @param index Numer słowa (0 - `PresenceWords - 1`); słowo obejmuje sloty od `64 * index`.
+     * @return Bity obecności slotów.
+     */
+    [[nodiscard]] uint64_t GetPresenceWord(int index) const;
 
 private:
     /**
@@ -49,15 +179,37 @@ private:
      */
     int _day;
     /**
-     * @brief Tablica wskaźników do obiektów Quarter reprezentujących kwadranse dnia.
+     * @brief Szerokość kubełka w minutach.
+     */
+    int _bucketMinutes;
+    /**
+     * @brief Wektor wskaźników do obiektów Quarter reprezentujących kubełki dnia.
      *
-     * Indeksy tablicy odpowiadają kolejnym kwadransom:
-     *  - 0: 00:00 - 05:45
-     *  - 1: 06:00 - 11:45
-     *  - 2: 12:00 - 17:45
-     *  - 3: 18:00 - 23:45
+     * Kubełek o indeksie `i` obejmuje minuty dnia od `i * _bucketMinutes`
+     * do `(i + 1) * _bucketMinutes - 1`.
+     */
+    vector<Quarter *> _quarters;
+    /**
+     * @brief Wskaźnik do agregatu danych dnia.
+     */
+    Aggregate* _aggregate;
+    /**
+     * @brief Wskaźnik do szkicu rozkładu wartości danych dnia.
+     */
+    QuantileSketch* _sketch;
+    /**
+     * @brief Wskaźnik do bloku skompresowanych danych lub `nullptr`, jeśli dane są w kubełkach.
+     */
+    CompressedBlock* _block = nullptr;
+    /**
+     * @brief Mapa bitowa obecności odczytów w slotach siatki dnia.
+     */
+    array<uint64_t, PresenceWords> _presence{};
+
+    /**
+     * @brief Tworzy puste kubełki dnia.
      */
-    array<Quarter *, 4> _quarters{};
+    void CreateQuarters();
 };
 
 #endif
@@ -0,0 +1,96 @@
+#ifndef DUPLICATERESOLVER_HPP
+#define DUPLICATERESOLVER_HPP
+
+#include <functional>
+#include <optional>
+
+#include "EnergyData.hpp"
+
+using namespace std;
+
+/**
+ * @brief Sposób rozstrzygania odczytów o tym samym znaczniku czasu.
+ */
+enum class DuplicatePolicy {
+    /** Zachowaj pierwszy odczyt (w kolejności z pliku). */
+    KeepFirst,
+    /** Zachowaj ostatni odczyt (w kolejności z pliku). */
+    KeepLast,
+    /** Zastąp odczyty ich średnią arytmetyczną. */
+    Average
+};
+
+/**
+ * @brief Etap wczytywania usuwający powtórzone znaczniki czasu z uporządkowanego strumienia rekordów.
+ *
+ * W uporządkowanym strumieniu rekordy o tym samym znaczniku czasu sąsiadują ze sobą, więc
+ * wystarczy pamiętać jeden oczekujący rekord - etap działa w czasie liniowym i stałej pamięci.
+ * Drugie wystąpienie godziny powtarzanej przy zmianie czasu ma inny znacznik czasu
+ * (`DateTime::IsRepeated`), więc nie jest traktowane jako duplikat.
+ */
+class DuplicateResolver {
+public:
+    /**
+     * @brief Konstruktor klasy DuplicateResolver.
+     *
+     * @param policy Sposób rozstrzygania duplikatów.
+     * @param consumer Odbiorca rekordów wynikowych; dostaje rekord i liczbę odczytów, z których powstał.
+     */
+    DuplicateResolver(DuplicatePolicy policy, function<void(EnergyData &&, int)> consumer);
+
+    /**
+     * @brief Przekazuje kolejny rekord uporządkowanego strumienia.
+     *
+     * @param record Rekord do przetworzenia.
+     */
+    void Push(EnergyData &&record);
+
+    /**
+     * @brief Przekazuje odbiorcy oczekujący rekord. Należy wywołać po ostatnim rekordzie strumienia.
+     */
+    void Flush();
+
+    /**
+     * @brief Zwraca liczbę odczytów odrzuconych lub uśrednionych jako duplikaty.
+     *
+     * @return Liczba duplikatów.
+     */
+    [[nodiscard]] size_t GetDuplicateCount() const;
+
+    /**
+     * @brief Łączy dwa odczyty o tym samym znaczniku czasu zgodnie z podaną polityką.
+     *
+     * @param policy Sposób rozstrzygania duplikatów.
+     * @param existing Odczyt wcześniejszy.
+     * @param existingSamples Liczba odczytów, z których powstał `existing`.
+     * @param incoming Odczyt późniejszy.
+     * @param incomingSamples Liczba odczytów, z których powstał `incoming`.
+     * @return Odczyt wynikowy.
+     */
+    [[nodiscard]] static EnergyData Merge(DuplicatePolicy policy, const EnergyData &existing, int existingSamples,
+                                          const EnergyData &incoming, int incomingSamples);
+
+private:
+    /**
+     * @brief Sposób rozstrzygania duplikatów.
+     */
+    DuplicatePolicy _policy;
+    /**
+     * @brief Odbiorca rekordów wynikowych.
+     */
+    function<void(EnergyData &&, int)> _consumer;
+    /**
+     * @brief Rekord oczekujący na sprawdzenie, czy kolejny rekord nie ma tego samego znacznika czasu.
+     */
+    optional<EnergyData> _pending;
+    /**
+     * @brief Liczba odczytów, z których powstał rekord oczekujący.
+     */
+    int _pendingSamples = 0;
+    /**
+     * @brief Liczba wykrytych duplikatów.
+     */
+    size_t _duplicateCount = 0;
+};
+
+#endif //DUPLICATERESOLVER_HPP
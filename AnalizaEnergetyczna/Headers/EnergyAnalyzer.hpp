@@ -1,11 +1,25 @@
 #ifndef ENERGYANALYZER_HPP
 #define ENERGYANALYZER_HPP
 
-#include <vector>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "Year.hpp"
+#include "AggregateCube.hpp"
 #include "EnergyData.hpp"
+#include "EnergyDataSorter.hpp"
+#include "DuplicateResolver.hpp"
+#include "DataValidator.hpp"
+#include "GridResampler.hpp"
+#include "EnergyDataFollower.hpp"
+#include "SparseIndex.hpp"
+#include "WriteAheadLog.hpp"
 #include "CommandParser.hpp"
 
 class CommandParser;
@@ -21,17 +35,203 @@ using namespace std;
  */
 class EnergyAnalyzer {
 public:
+    /**
+     * @brief Domyślny rozmiar dziennika zapisów (w bajtach), po którego przekroczeniu tworzona jest nowa migawka.
+     */
+    static constexpr uintmax_t DefaultCompactionBytes = 64ull * 1024 * 1024;
+
+    /**
+     * @brief Najmniejsza liczba dni przeszukiwanych przez jeden wątek w `FindTopInRange`.
+     */
+    static constexpr int ParallelScanDays = 32;
+
+    /**
+     * @brief Największa liczba przedziałów histogramu (`HistogramInRange`).
+     */
+    static constexpr size_t MaxHistogramBins = 10000;
+
+    /**
+     * @brief Największa szerokość okna kroczącego (`ForEachWindowInRange`) w minutach.
+     */
+    static constexpr int MaxWindowMinutes = 366 * 24 * 60;
+
+    /**
+     * @brief Ciągły przedział brakujących 15-minutowych slotów.
+     */
+    struct MissingInterval {
+        /**
+         * @brief Początek pierwszego brakującego slotu.
+         */
+        DateTime Start;
+        /**
+         * @brief Początek ostatniego brakującego slotu.
+         */
+        DateTime End;
+        /**
+         * @brief Liczba brakujących slotów.
+         */
+        size_t Slots;
+    };
+
+    /**
+     * @brief Pokrycie przedziału czasowego odczytami.
+     */
+    struct Coverage {
+        /**
+         * @brief Liczba slotów siatki, dla których istnieje odczyt.
+         */
+        size_t Present;
+        /**
+         * @brief Liczba slotów siatki w przedziale.
+         */
+        size_t Expected;
+    };
+
+    /**
+     * @brief Sposób grupowania odczytów według czasu (patrz `GroupInRange`).
+     */
+    enum class Grouping {
+        /** Godzina doby (klucz 0-23). */
+        HourOfDay,
+        /** Dzień tygodnia (klucz 0 - poniedziałek, ..., 6 - niedziela). */
+        DayOfWeek,
+        /** Dzień (klucz RRRRMMDD). */
+        Day,
+        /** Miesiąc (klucz RRRRMM). */
+        Month
+    };
+
+    /**
+     * @brief Grupa odczytów o tym samym kluczu czasu.
+     */
+    struct Group {
+        /**
+         * @brief Klucz grupy (znaczenie zależy od sposobu grupowania).
+         */
+        int Key;
+        /**
+         * @brief Sumy, wartości skrajne i liczba odczytów grupy.
+         */
+        Aggregate Totals;
+    };
+
+    /**
+     * @brief Histogram wartości wielkości o przedziałach równej szerokości.
+     */
+    struct Histogram {
+        /**
+         * @brief Dolna granica pierwszego przedziału (najmniejsza wartość).
+         */
+        double Low;
+        /**
+         * @brief Szerokość przedziału (0, jeśli wszystkie wartości są równe).
+         */
+        double Width;
+        /**
+         * @brief Liczby odczytów w kolejnych przedziałach; przedział `i` to [Low + i·Width, Low + (i + 1)·Width),
+         *        a ostatni obejmuje też największą wartość.
+         */
+        vector<size_t> Counts;
+    };
+
+    /**
+     * @brief Punkt krzywej trwania obciążenia.
+     */
+    struct DurationPoint {
+        /**
+         * @brief Czas trwania: procent odczytów przedziału od największego do odczytu punktu włącznie.
+         */
+        double Share;
+        /**
+         * @brief Wartość wielkości (w watach [W]).
+         */
+        double Value;
+    };
+
+    /**
+     * @brief Statystyki okna kroczącego kończącego się odczytem.
+     */
+    struct WindowPoint {
+        /**
+         * @brief Data i godzina odczytu kończącego okno.
+         */
+        DateTime When;
+        /**
+         * @brief Suma wartości w oknie (w watach [W]).
+         */
+        long double Sum;
+        /**
+         * @brief Najmniejsza wartość w oknie.
+         */
+        double Min;
+        /**
+         * @brief Największa wartość w oknie.
+         */
+        double Max;
+        /**
+         * @brief Liczba odczytów w oknie.
+         */
+        size_t Count;
+    };
+
+    /**
+     * @brief Wartość skrajna wielkości wraz z czasem odczytu, w którym wystąpiła.
+     */
+    struct Extremum {
+        /**
+         * @brief Data i godzina odczytu.
+         */
+        DateTime When;
+        /**
+         * @brief Wartość wielkości (w watach [W]).
+         */
+        double Value;
+    };
+
+    /**
+     * @brief Konstruktor klasy EnergyAnalyzer.
+     *
+     * Tworzy pustą strukturę danych, którą można wypełniać metodami `Append` i `Upsert`.
+     *
+     * @param bucketMinutes Szerokość kubełka dnia w minutach (np. 15, 60 lub 360).
+     * @param duplicatePolicy Sposób rozstrzygania odczytów o tym samym znaczniku czasu.
+     *
+     * @throws std::invalid_argument Jeśli szerokość kubełka nie dzieli doby na pełne 15-minutowe sloty.
+     */
+    explicit EnergyAnalyzer(int bucketMinutes = Day::DefaultBucketMinutes,
+                            DuplicatePolicy duplicatePolicy = DuplicatePolicy::KeepFirst);
+
     /**
      * @brief Konstruktor klasy EnergyAnalyzer.
      *
      * Wczytuje dane z pliku CSV o podanej ścieżce i tworzy strukturę danych
-     * do ich przechowywania (lata, miesiące, dni, kwadranse, dane).
+     * do ich przechowywania (lata, miesiące, dni, kubełki, dane).
      *
-     * @param filepath Ścieżka do pliku CSV z danymi.
+     * Ścieżka może też wskazywać katalog (wczytywane są wszystkie pliki `.csv`) lub wzorzec
+     * nazw plików, np. `dane/licznik1_*.csv`. Pliki są wtedy parsowane równolegle, a ich rekordy
+     * scalane chronologicznie; powtórzone znaczniki czasu są rozstrzygane zgodnie z `duplicatePolicy`
+     * w kolejności plików według nazwy. Pliki skompresowane (gzip, zstd) są rozpakowywane
+     * w pamięci. Śledzenie pliku (`Follow`) wymaga pojedynczego, nieskompresowanego pliku.
      *
-     * @throws std::runtime_error Jeśli nie można otworzyć pliku.
+     * @param filepath Ścieżka do pliku CSV z danymi, katalogu lub wzorca nazw plików.
+     * @param bucketMinutes Szerokość kubełka dnia w minutach (np. 15, 60 lub 360).
+     * @param duplicatePolicy Sposób rozstrzygania odczytów o tym samym znaczniku czasu.
+     * @param columns Kolumny wartości wczytywane z pliku. Pozostałe nie są konwertowane, a zapytania
+     *                o nie zwracają NaN - pozwala to przyspieszyć wczytywanie, gdy potrzebna jest
+     *                tylko część wielkości (np. `ColumnOf(Metric::Import) | ColumnOf(Metric::Generation)`).
+     * @param rejectedRules Reguły poprawności, których naruszenie odrzuca rekord z pliku (patrz `DataValidator`).
+     * @param resampleGapSlots Przepróbkowanie odczytów na siatkę 15-minutowych slotów (patrz `GridResampler`):
+     *                         `NoResampling` je wyłącza, a wartość nieujemna to największa liczba kolejnych
+     *                         pustych slotów wypełnianych interpolacją liniową.
+     *
+     * @throws std::runtime_error Jeśli nie można otworzyć pliku lub żaden plik nie pasuje do wzorca.
+     * @throws std::invalid_argument Jeśli szerokość kubełka nie dzieli doby na pełne 15-minutowe sloty
+     *                               lub `resampleGapSlots` jest mniejsze niż `NoResampling`.
      */
-    explicit EnergyAnalyzer(const string& filepath);
+    explicit EnergyAnalyzer(const string& filepath, int bucketMinutes = Day::DefaultBucketMinutes,
+                            DuplicatePolicy duplicatePolicy = DuplicatePolicy::KeepFirst,
+                            ColumnSet columns = AllColumns, RuleSet rejectedRules = DefaultRejectedRules,
+                            int resampleGapSlots = NoResampling);
 
     /**
      * @brief Destruktor klasy EnergyAnalyzer.
@@ -40,6 +240,116 @@ public:
      */
     ~EnergyAnalyzer();
 
+    /**
+     * @brief Zwraca liczbę odrzuconych odczytów spoza 15-minutowej siatki slotów (np. 2:05 przy kadencji 5 minut).
+     *
+     * Taki odczyt nie ma własnego slotu, więc nie jest wstawiany - nie jest też traktowany jako
+     * duplikat odczytu z początku slotu.
+     *
+     * @return Liczba odrzuconych odczytów.
+     */
+    [[nodiscard]] size_t GetOffGridCount() const;
+
+    /**
+     * @brief Zwraca etap sprawdzania poprawności rekordów wczytywanych z pliku (liczniki naruszeń i kwarantanna).
+     *
+     * @return Referencja do etapu sprawdzania poprawności.
+     */
+    [[nodiscard]] const DataValidator& GetValidator() const;
+
+    /**
+     * @brief Zwija kostkę agregatów (rok × miesiąc × dzień tygodnia × slot doby) wszystkich odczytów.
+     *
+     * Kostka jest aktualizowana przy każdym wstawieniu, więc zawsze odpowiada strukturze danych.
+     * Wynik jest kopią, więc nie zmienia się, gdy wątek śledzący dopisuje nowe odczyty.
+     *
+     * @param by Wymiar, według którego łączone są komórki.
+     * @param filter Ograniczenia pozostałych wymiarów.
+     * @return Agregaty kolejnych wartości wymiaru (patrz `AggregateCube::RollUp`).
+     */
+    [[nodiscard]] map<int, Aggregate> RollUpCube(AggregateCube::Dimension by, const AggregateCube::Filter& filter) const;
+
+    /**
+     * @brief Dopisuje nowe rekordy do struktury danych.
+     *
+     * Rekordy nie muszą być uporządkowane ani późniejsze od danych już wczytanych. Odczyty
+     * o znacznikach czasu, które już istnieją, są rozstrzygane zgodnie z polityką duplikatów
+     * analizatora. Agregaty lat, miesięcy, dni i kubełków są aktualizowane przy każdym
+     * wstawieniu, więc koszt zależy tylko od liczby nowych rekordów.
+     *
+     * @param records Rekordy do dopisania.
+     * @return Liczba rekordów, które zostały dodane lub zmieniły istniejący odczyt.
+     * @throws invalid_argument Jeśli któryś rekord ma niepoprawną datę lub godzinę, np. 31.02 (partia nie jest wtedy wstawiana).
+     */
+    size_t Append(vector<EnergyData> records);
+
+    /**
+     * @brief Wstawia rekordy, zastępując istniejące odczyty o tych samych znacznikach czasu.
+     *
+     * Działa jak `Append`, ale niezależnie od polityki duplikatów nowszy odczyt zawsze
+     * zastępuje wcześniejszy (także w obrębie przekazanych rekordów).
+     *
+     * @param records Rekordy do wstawienia.
+     * @return Liczba rekordów, które zostały dodane lub zmieniły istniejący odczyt.
+     * @throws invalid_argument Jeśli któryś rekord ma niepoprawną datę lub godzinę, np. 31.02 (partia nie jest wtedy wstawiana).
+     */
+    size_t Upsert(vector<EnergyData> records);
+
+    /**
+     * @brief Włącza trwały zapis danych dopisywanych w trakcie działania programu.
+     *
+     * Wczytuje ostatnią migawkę z katalogu (jeśli istnieje) i odtwarza zapisane po niej
+     * pliki dziennika zapisów. Od tej chwili każda partia przekazana do `Append` lub `Upsert`
+     * jest przed powrotem z metody zapisywana w dzienniku i utrwalana na dysku. Gdy dziennik
+     * przekroczy `compactionBytes` bajtów, w tle zapisywana jest nowa migawka, a objęte nią
+     * pliki dziennika są usuwane - czas ponownego uruchomienia nie rośnie więc z ilością
+     * dopisanych danych.
+     *
+     * Trwały zapis wymaga analizatora ze wszystkimi kolumnami (`AllColumns`) - niewczytane
+     * kolumny (NaN) trafiłyby do migawki i dziennika jak prawdziwe odczyty.
+     *
+     * @param directory Katalog na migawkę i pliki dziennika (tworzony, jeśli nie istnieje).
+     * @param compactionBytes Rozmiar dziennika, po którego przekroczeniu tworzona jest migawka.
+     * @throws std::logic_error Jeśli trwały zapis jest już włączony lub analizator wczytał tylko część kolumn.
+     * @throws std::runtime_error Jeśli migawka jest uszkodzona lub nie można utworzyć dziennika.
+     */
+    void OpenStorage(const string& directory, uintmax_t compactionBytes = DefaultCompactionBytes);
+
+    /**
+     * @brief Kompresuje dane historyczne, aby zmniejszyć zużycie pamięci.
+     *
+     * Dni wcześniejsze niż `before` są przechowywane w postaci skompresowanych bloków
+     * (patrz `CompressedBlock`). Wstawienie rekordu do takiego dnia rozpakowuje go.
+     *
+     * @param before Wskaźnik do obiektu DateTime - dni od tej daty pozostają nieskompresowane.
+     * @return Liczba skompresowanych dni.
+     */
+    size_t CompressHistory(const DateTime* before);
+
+    /**
+     * @brief Włącza śledzenie pliku, z którego wczytano dane.
+     *
+     * W osobnym wątku co `interval` sprawdza, czy do pliku dopisano nowe linie, i dodaje
+     * je przez `Append`. Plik jest czytany od miejsca, w którym skończyło się wczytywanie
+     * w konstruktorze, więc żadna linia nie jest czytana dwukrotnie. Polecenia wykonywane
+     * przez `ExecuteCommand` oraz publiczne zapytania (`Calculate*`, `Find*`, `GroupInRange`,
+     * `RollUpCube` itd.) wykluczają się ze wstawianiem nowych rekordów, więc można je wywoływać
+     * z innych wątków w trakcie śledzenia. Funkcje przekazywane do zapytań (np. do
+     * `ForEachWindowInRange`) nie mogą wstawiać rekordów do tego samego analizatora.
+     *
+     * Przy włączonym przepróbkowaniu rekord slotu jest dodawany dopiero po dopisaniu odczytu
+     * z późniejszego slotu.
+     *
+     * @param interval Odstęp między kolejnymi sprawdzeniami pliku.
+     * @throws std::logic_error Jeśli analizator nie został utworzony z pliku.
+     */
+    void Follow(chrono::milliseconds interval = chrono::seconds(1));
+
+    /**
+     * @brief Wyłącza śledzenie pliku i czeka na zakończenie wątku śledzącego.
+     */
+    void StopFollowing();
+
     /**
      * @brief Oblicza sumę autokonsumpcji w zadanym przedziale czasowym.
      *
@@ -256,6 +566,25 @@ public:
      */
     void ExecuteCommand(const string& command) const;
 
+    /**
+     * @brief Wykonuje polecenie bez wczytywania całego pliku CSV.
+     *
+     * Na podstawie rzadkiego indeksu pliku (patrz `SparseIndex`) wczytuje tylko fragment
+     * obejmujący daty występujące w poleceniu i wykonuje na nim polecenie. Wyniki poleceń
+     * `SUMA`, `SREDNIA`, `WYPISZ` (a także `POROWNAJ` i `ZNAJDZ`) są takie same jak po
+     * wczytaniu całego pliku, a koszt zależy od długości przedziału, a nie od rozmiaru pliku.
+     *
+     * @param filepath Ścieżka do pliku CSV z danymi.
+     * @param index Indeks pliku.
+     * @param command Polecenie do wykonania.
+     * @param bucketMinutes Szerokość kubełka dnia w minutach.
+     * @param duplicatePolicy Sposób rozstrzygania odczytów o tym samym znaczniku czasu.
+     * @throws std::runtime_error Jeśli nie można otworzyć pliku lub indeks jest nieaktualny.
+     */
+    static void ExecuteIndexedCommand(const string& filepath, const SparseIndex& index, const string& command,
+                                      int bucketMinutes = Day::DefaultBucketMinutes,
+                                      DuplicatePolicy duplicatePolicy = DuplicatePolicy::KeepFirst);
+
     /**
      * @brief Wypisuje wszystkie dane z zadanego przedziału czasowego.
      *
@@ -268,6 +597,169 @@ public:
      */
     void PrintAllDataInRange(const DateTime* start, const DateTime* end) const;
 
+    /**
+     * @brief Wyznacza przedziały brakujących odczytów w siatce 15-minutowych slotów.
+     *
+     * Oczekiwany jest jeden odczyt na każdy slot przedziału [start, end] (96 na dobę; godzina
+     * powtarzana przy zmianie czasu nie należy do siatki). Braki są wyszukiwane w mapach obecności
+     * dni (`Day::GetPresenceWord`) po 64 sloty naraz, a dni bez żadnych danych są brakami w całości.
+     *
+     * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+     * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+     * @return Przedziały brakujących slotów w kolejności chronologicznej.
+     */
+    [[nodiscard]] vector<MissingInterval> FindMissingIntervals(const DateTime* start, const DateTime* end) const;
+
+    /**
+     * @brief Oblicza pokrycie przedziału czasowego odczytami (patrz `FindMissingIntervals`).
+     *
+     * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+     * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+     * @return Liczba obecnych i oczekiwanych slotów.
+     */
+    [[nodiscard]] Coverage CalculateCoverage(const DateTime* start, const DateTime* end) const;
+
+    /**
+     * @brief Wyszukuje największą wartość wielkości w przedziale czasowym [start, end].
+     *
+     * Wartość jest odczytywana z agregatów lat, miesięcy, dni i kubełków (aktualizowanych przy każdym
+     * wstawieniu), a rekordy są odwiedzane tylko w kubełkach przeciętych granicą przedziału. Czas
+     * odczytu jest następnie wyszukiwany zejściem w głąb węzłów, których agregat zawiera tę wartość.
+     *
+     * @param metric Wielkość.
+     * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+     * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+     * @return Wartość największa i czas jej pierwszego wystąpienia lub `nullopt`, jeśli w przedziale nie ma danych.
+     */
+    [[nodiscard]] optional<Extremum> FindMaxInRange(Metric metric, const DateTime* start, const DateTime* end) const;
+
+    /**
+     * @brief Wyszukuje najmniejszą wartość wielkości w przedziale czasowym [start, end] (patrz `FindMaxInRange`).
+     *
+     * @param metric Wielkość.
+     * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+     * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+     * @return Wartość najmniejsza i czas jej pierwszego wystąpienia lub `nullopt`, jeśli w przedziale nie ma danych.
+     */
+    [[nodiscard]] optional<Extremum> FindMinInRange(Metric metric, const DateTime* start, const DateTime* end) const;
+
+    /**
+     * @brief Wyszukuje `count` odczytów o największych wartościach wielkości w przedziale czasowym [start, end].
+     *
+     * Przedział jest dzielony na ciągłe fragmenty po co najmniej `ParallelScanDays` dni, przeszukiwane
+     * równolegle. Każdy wątek przechowuje kopiec `count` najlepszych dotąd odczytów i pomija lata,
+     * miesiące, dni i kubełki, których wartość maksymalna (z agregatu) nie przewyższa najgorszego
+     * odczytu w pełnym kopcu. Kopce wątków są na końcu scalane.
+     *
+     * @param metric Wielkość.
+     * @param count Liczba szukanych odczytów.
+     * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+     * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+     * @return Odczyty uporządkowane malejąco według wartości (przy równych wartościach - chronologicznie).
+     */
+    [[nodiscard]] vector<Extremum> FindTopInRange(Metric metric, size_t count, const DateTime* start,
+                                                  const DateTime* end) const;
+
+    /**
+     * @brief Grupuje odczyty z przedziału czasowego [start, end] według czasu i oblicza agregat każdej grupy.
+     *
+     * Wszystkie grupy są wyznaczane w jednym przebiegu, a fragmenty przedziału są przetwarzane
+     * równolegle, każdy do własnej tablicy grup, scalanych na końcu. Węzeł drzewa leżący w całości
+     * w przedziale i w jednej grupie (miesiąc przy grupowaniu po miesiącach, dzień przy grupowaniu
+     * po dniach i dniach tygodnia, kubełek mieszczący się w jednej godzinie przy grupowaniu po
+     * godzinach) dokłada od razu swój agregat.
+     *
+     * @param grouping Sposób grupowania.
+     * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+     * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+     * @return Niepuste grupy uporządkowane rosnąco według klucza.
+     */
+    [[nodiscard]] vector<Group> GroupInRange(Grouping grouping, const DateTime* start, const DateTime* end) const;
+
+    /**
+     * @brief Szacuje percentyl wartości wielkości w przedziale czasowym [start, end].
+     *
+     * Szacunek pochodzi ze szkicu `SketchInRange`, więc jego koszt nie zależy od liczby odczytów
+     * w przedziale, a błąd względem wyniku `CalculatePercentileInRange` wynosi najwyżej
+     * `QuantileSketch::RelativeAccuracy` modułu dokładnej wartości (patrz `QuantileSketch`).
+     *
+     * @param metric Wielkość.
+     * @param percentile Percentyl (0-100).
+     * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+     * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+     * @return Szacunek percentyla lub `nullopt`, jeśli w przedziale nie ma danych.
+     */
+    [[nodiscard]] optional<double> EstimatePercentileInRange(Metric metric, double percentile, const DateTime* start,
+                                                             const DateTime* end) const;
+
+    /**
+     * @brief Oblicza dokładny percentyl wartości wielkości w przedziale czasowym [start, end].
+     *
+     * Wartości z przedziału są kopiowane, a wartość o randze `QuantileSketch::GetRank` jest
+     * wybierana przez `nth_element` (w czasie liniowym względem liczby odczytów).
+     *
+     * @param metric Wielkość.
+     * @param percentile Percentyl (0-100).
+     * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+     * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+     * @return Percentyl lub `nullopt`, jeśli w przedziale nie ma danych.
+     */
+    [[nodiscard]] optional<double> CalculatePercentileInRange(Metric metric, double percentile, const DateTime* start,
+                                                              const DateTime* end) const;
+
+    /**
+     * @brief Oblicza histogram wartości wielkości w przedziale czasowym [start, end].
+     *
+     * Zakres histogramu (wartość najmniejsza i największa) pochodzi z `AggregateInRange`, a wartości
+     * wydobyte z przedziału (`ExtractValuesInRange`) są przypisywane do przedziałów w jednym przebiegu.
+     *
+     * @param metric Wielkość.
+     * @param binCount Liczba przedziałów histogramu (od 1 do `MaxHistogramBins`).
+     * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+     * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+     * @return Histogram lub `nullopt`, jeśli w przedziale nie ma danych.
+     * @throws std::invalid_argument Jeśli liczba przedziałów jest spoza dopuszczalnego zakresu.
+     */
+    [[nodiscard]] optional<Histogram> HistogramInRange(Metric metric, size_t binCount, const DateTime* start,
+                                                       const DateTime* end) const;
+
+    /**
+     * @brief Wyznacza krzywą trwania obciążenia (wartości uporządkowane malejąco) w przedziale czasowym [start, end].
+     *
+     * Wartości wydobyte z przedziału są sortowane pozycyjnie (radix sort) według bitów liczb
+     * zmiennoprzecinkowych, a krzywa jest próbkowana w `pointCount` równo rozłożonych pozycjach
+     * (pierwszy punkt to wartość największa, ostatni - najmniejsza).
+     *
+     * @param metric Wielkość.
+     * @param pointCount Liczba punktów krzywej (nie więcej niż liczba odczytów w przedziale).
+     * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+     * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+     * @return Punkty krzywej (pusty wektor, jeśli w przedziale nie ma danych).
+     */
+    [[nodiscard]] vector<DurationPoint> DurationCurveInRange(Metric metric, size_t pointCount, const DateTime* start,
+                                                             const DateTime* end) const;
+
+    /**
+     * @brief Oblicza statystyki okna kroczącego dla każdego odczytu z przedziału czasowego [start, end].
+     *
+     * Okno odczytu z chwili `t` obejmuje odczyty z przedziału (t - width, t], także sprzed `start`.
+     * Statystyki są liczone przyrostowo w jednym przebiegu, w czasie O(n): suma jest bieżąca
+     * (odczyt wchodzący jest dodawany, a wychodzący odejmowany), a wartości skrajne pochodzą
+     * z kolejek monotonicznych. Wyniki są przekazywane odbiorcy od razu, bez gromadzenia ich w pamięci.
+     *
+     * Czas okna jest mierzony zegarem ściennym; odczyty godziny powtarzanej przy zmianie czasu
+     * są traktowane tak, jakby nastąpiły w chwili poprzedniego odczytu.
+     *
+     * @param metric Wielkość.
+     * @param widthMinutes Szerokość okna w minutach (od 1 do `MaxWindowMinutes`).
+     * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+     * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+     * @param consumer Funkcja wywoływana dla kolejnych okien w porządku chronologicznym.
+     * @throws std::invalid_argument Jeśli szerokość okna jest spoza dopuszczalnego zakresu.
+     */
+    void ForEachWindowInRange(Metric metric, int widthMinutes, const DateTime* start, const DateTime* end,
+                              const function<void(const WindowPoint&)>& consumer) const;
+
 private:
     /**
      * @brief Wskaźnik do wektora przechowującego lata.
@@ -286,12 +778,391 @@ private:
     CommandParser* _commandParser;
 
     /**
-     * @brief Tworzy strukturę danych (lata, miesiące, dni, kwadranse, dane) na podstawie wektora obiektów EnergyData.
+     * @brief Szerokość kubełka dnia w minutach, używana przy tworzeniu nowych dni.
+     */
+    int _bucketMinutes;
+
+    /**
+     * @brief Sposób rozstrzygania odczytów o tym samym znaczniku czasu.
+     */
+    DuplicatePolicy _duplicatePolicy;
+
+    /**
+     * @brief Liczba odrzuconych odczytów spoza siatki slotów.
+     */
+    size_t _offGridCount = 0;
+
+    /**
+     * @brief Ścieżka do pliku, z którego wczytano dane (pusta dla analizatora utworzonego bez pliku).
+     */
+    string _filepath;
+
+    /**
+     * @brief Kolumny wartości wczytywane z pliku `_filepath`.
+     */
+    ColumnSet _columns = AllColumns;
+
+    /**
+     * @brief Sprawdza poprawność rekordów wczytywanych z pliku i z dopisywanych do niego linii.
+     */
+    DataValidator _validator;
+
+    /**
+     * @brief Kostka agregatów wszystkich odczytów.
+     */
+    AggregateCube _cube;
+
+    /**
+     * @brief Największa liczba pustych slotów wypełnianych interpolacją przy wczytywaniu (`NoResampling` - bez przepróbkowania).
+     */
+    int _resampleGapSlots = NoResampling;
+
+    /**
+     * @brief Pozycja w pliku `_filepath` tuż za ostatnią wczytaną linią.
+     */
+    streamoff _fileOffset = 0;
+
+    /**
+     * @brief Znacznik czasu ostatniego rekordu wczytanego z pliku `_filepath`.
+     */
+    optional<DateTime> _lastRead;
+
+    /**
+     * @brief Blokada chroniąca strukturę danych przed jednoczesnym odczytem i zapisem.
+     *
+     * Polecenia i publiczne zapytania zajmują ją współdzielnie (patrz `ReadLock`), a `Append`
+     * i `Upsert` - na wyłączność.
+     */
+    mutable shared_mutex _mutex;
+
+    /**
+     * @brief Współdzielona blokada `_mutex` zajmowana przez polecenia i publiczne zapytania.
+     *
+     * Jeśli bieżący wątek trzyma już blokadę tego analizatora (zapytania wywoływane przez
+     * `CommandParser` w `ExecuteCommand` lub przez inne zapytania), nie jest ona zajmowana
+     * ponownie - ponowne zajęcie `shared_mutex` przez ten sam wątek mogłoby się zakleszczyć
+     * z czekającym na blokadę `Append`.
+     */
+    class ReadLock {
+    public:
+        /**
+         * @brief Zajmuje blokadę analizatora, jeśli bieżący wątek jeszcze jej nie trzyma.
+         *
+         * @param analyzer Analizator, którego strukturę danych czyta zapytanie.
+         */
+        explicit ReadLock(const EnergyAnalyzer& analyzer);
+
+        /**
+         * @brief Zwalnia blokadę, jeśli została zajęta przez ten obiekt.
+         */
+        ~ReadLock();
+
+        ReadLock(const ReadLock&) = delete;
+        ReadLock& operator=(const ReadLock&) = delete;
+
+    private:
+        /**
+         * @brief Analizatory, których blokady trzyma bieżący wątek.
+         */
+        static thread_local vector<const EnergyAnalyzer*> _held;
+
+        /**
+         * @brief Blokada zajęta przez ten obiekt (pusta, jeśli wątek trzymał ją już wcześniej).
+         */
+        shared_lock<shared_mutex> _lock;
+
+        /**
+         * @brief Analizator, którego blokadę zajęto.
+         */
+        const EnergyAnalyzer* _analyzer;
+    };
+
+    /**
+     * @brief Wątek śledzący dopisywanie do pliku (patrz `Follow`).
+     */
+    jthread _followThread;
+
+    /**
+     * @brief Katalog na migawkę i pliki dziennika zapisów (pusty, jeśli trwały zapis jest wyłączony).
+     */
+    string _storageDirectory;
+
+    /**
+     * @brief Bieżący plik dziennika zapisów (`nullptr`, jeśli trwały zapis jest wyłączony).
+     *
+     * Współdzielony z wątkami czekającymi na utrwalenie swoich wpisów i z wątkiem tworzącym migawkę.
+     */
+    shared_ptr<WriteAheadLog> _writeAheadLog;
+
+    /**
+     * @brief Numer pokolenia bieżącego pliku dziennika zapisów.
+     */
+    uint64_t _walGeneration = 0;
+
+    /**
+     * @brief Rozmiar dziennika, po którego przekroczeniu tworzona jest migawka.
+     */
+    uintmax_t _compactionBytes = DefaultCompactionBytes;
+
+    /**
+     * @brief Czy w tle trwa zapis migawki.
+     */
+    atomic<bool> _compacting = false;
+
+    /**
+     * @brief Wątek zapisujący migawkę.
+     */
+    jthread _compactionThread;
+
+    /**
+     * @brief Rok, do którego trafił ostatnio wstawiony rekord (`nullptr`, jeśli nie wstawiono jeszcze żadnego).
+     */
+    Year* _currentYear = nullptr;
+
+    /**
+     * @brief Miesiąc, do którego trafił ostatnio wstawiony rekord (`nullptr`, jeśli nie wstawiono jeszcze żadnego).
+     */
+    Month* _currentMonth = nullptr;
+
+    /**
+     * @brief Dzień, do którego trafił ostatnio wstawiony rekord (`nullptr`, jeśli nie wstawiono jeszcze żadnego).
+     */
+    Day* _currentDay = nullptr;
+
+    /**
+     * @brief Data dnia `_currentDay` w postaci RRRRMMDD.
+     */
+    int _currentDate = 0;
+
+    /**
+     * @brief Wywołuje funkcję dla każdego rekordu z przedziału czasowego [start, end].
+     *
+     * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+     * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+     * @param visitor Funkcja wywoływana jako `visitor(const DateTime&, const Data&)` dla każdego rekordu.
+     */
+    template<typename Visitor>
+    void ForEachDataInRange(const DateTime* start, const DateTime* end, Visitor&& visitor) const;
+
+    /**
+     * @brief Zwraca datę ostatniego dnia miesiąca.
+     *
+     * @param monthDate Miesiąc w postaci RRRRMM.
+     * @return Data ostatniego dnia miesiąca w postaci RRRRMMDD.
+     */
+    [[nodiscard]] static int GetLastDate(int monthDate);
+
+    /**
+     * @brief Wywołuje funkcję dla rekordów z przedziału czasowego [start, end], pomijając całe węzły drzewa.
+     *
+     * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+     * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+     * @param visitor Funkcja wywoływana jako `visitor(const DateTime&, const Data&)` dla każdego rekordu.
+     * @param mayContain Funkcja `mayContain(const Aggregate&)`; rok, miesiąc, dzień lub kubełek, dla którego
+     *                   zwraca `false`, jest pomijany wraz ze wszystkimi rekordami.
+     */
+    template<typename Visitor, typename Pruner>
+    void ForEachDataInRange(const DateTime* start, const DateTime* end, Visitor&& visitor, Pruner&& mayContain) const;
+
+    /**
+     * @brief Wywołuje funkcję dla każdego słowa map obecności dni z przedziału czasowego [start, end].
+     *
+     * Odwiedzane są wszystkie dni kalendarza z przedziału, także te, których nie ma w strukturze danych
+     * (ich słowa są puste).
+     *
+     * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+     * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+     * @param visitor Funkcja wywoływana jako `visitor(int64_t firstSlot, uint64_t present, uint64_t expected)`,
+     *                gdzie `firstSlot` to numer slotu bitu 0 liczony od północy dnia `start`, a `expected`
+     *                zawiera bity slotów należących do przedziału.
+     */
+    template<typename Visitor>
+    void ForEachPresenceWord(const DateTime* start, const DateTime* end, Visitor&& visitor) const;
+
+    /**
+     * @brief Oblicza agregat (sumy i liczbę rekordów) danych z przedziału czasowego [start, end].
+     *
+     * Lata, miesiące, dni i kubełki leżące w całości w przedziale są brane z ich agregatów,
+     * a pojedyncze rekordy odwiedzane są tylko w kubełkach brzegowych.
+     *
+     * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+     * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+     * @return Agregat danych z przedziału.
+     */
+    [[nodiscard]] Aggregate AggregateInRange(const DateTime* start, const DateTime* end) const;
+
+    /**
+     * @brief Buduje szkic rozkładu wartości danych z przedziału czasowego [start, end].
+     *
+     * Lata, miesiące i dni leżące w całości w przedziale dokładają swoje szkice, a pojedyncze
+     * rekordy odwiedzane są tylko w co najwyżej dwóch dniach brzegowych.
+     *
+     * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+     * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+     * @return Szkic danych z przedziału.
+     */
+    [[nodiscard]] QuantileSketch SketchInRange(const DateTime* start, const DateTime* end) const;
+
+    /**
+     * @brief Dzieli przedział czasowy na ciągłe fragmenty (po co najmniej `ParallelScanDays` dni) do równoległego przeszukiwania.
+     *
+     * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+     * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+     * @return Początki i końce kolejnych fragmentów.
+     */
+    [[nodiscard]] static vector<pair<DateTime, DateTime>> SplitRange(const DateTime* start, const DateTime* end);
+
+    /**
+     * @brief Wywołuje funkcję dla każdego fragmentu przedziału (patrz `SplitRange`) w osobnym wątku.
+     *
+     * @param count Liczba fragmentów.
+     * @param scan Funkcja wywoływana z numerem fragmentu.
+     */
+    template<typename Scanner>
+    static void RunParts(size_t count, Scanner&& scan);
+
+    /**
+     * @brief Kopiuje wartości wielkości z przedziału czasowego [start, end] do jednej tablicy.
+     *
+     * Fragmenty przedziału (`SplitRange`) są przeglądane równolegle, a wartości NaN (niewczytane
+     * kolumny) i nieskończone są pomijane.
+     *
+     * @param metric Wielkość.
+     * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+     * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+     * @return Wartości w porządku chronologicznym.
+     */
+    [[nodiscard]] vector<double> ExtractValuesInRange(Metric metric, const DateTime* start, const DateTime* end) const;
+
+    /**
+     * @brief Sortuje wartości malejąco sortowaniem pozycyjnym (LSD radix sort) po bitach liczb zmiennoprzecinkowych.
+     *
+     * @param values Wartości do posortowania (bez NaN).
+     */
+    static void RadixSortDescending(vector<double>& values);
+
+    /**
+     * @brief Wyszukuje wartość skrajną wielkości w przedziale czasowym [start, end].
+     *
+     * @param metric Wielkość.
+     * @param start Data i godzina początku przedziału.
+     * @param end Data i godzina końca przedziału.
+     * @param maximum true dla wartości największej, false dla najmniejszej.
+     * @return Wartość skrajna i czas jej pierwszego wystąpienia lub `nullopt`, jeśli w przedziale nie ma danych.
+     */
+    [[nodiscard]] optional<Extremum> FindExtremumInRange(Metric metric, const DateTime* start, const DateTime* end,
+                                                         bool maximum) const;
+
+    /**
+     * @brief Wstawia rekordy wczytywane z pliku CSV.
+     *
+     * Rekordy są sprawdzane partiami (`DataValidator`). Rekordy w porządku chronologicznym
+     * trafiają od razu do struktury danych, pozostałe są wstawiane po zakończeniu wczytywania.
+     *
+     * @param read Funkcja wczytująca rekordy i przekazująca je do podanego odbiorcy.
+     * @return Wynik funkcji `read` (pozycja w pliku za ostatnią wczytaną linią).
+     */
+    streamoff Load(const function<streamoff(const function<void(EnergyData&&)>&)>& read);
+
+    /**
+     * @brief Wstawia uporządkowane lub nieuporządkowane rekordy, usuwając duplikaty.
+     *
+     * @param records Rekordy do wstawienia.
+     * @param policy Sposób rozstrzygania odczytów o tym samym znaczniku czasu.
+     * @return Liczba rekordów, które zostały dodane lub zmieniły istniejący odczyt.
+     */
+    size_t InsertAll(vector<EnergyData>& records, DuplicatePolicy policy);
+
+    /**
+     * @brief Sprawdza, czy wszystkie rekordy partii mają poprawne daty i godziny.
+     *
+     * @param records Rekordy partii.
+     * @throws invalid_argument Jeśli któryś rekord ma niepoprawną datę lub godzinę.
+     */
+    static void CheckTimestamps(const vector<EnergyData>& records);
+
+    /**
+     * @brief Zapisuje partię rekordów w dzienniku (jeśli trwały zapis jest włączony) i wstawia ją do struktury danych.
+     *
+     * @param operation Rodzaj operacji.
+     * @param records Rekordy do wstawienia.
+     * @return Liczba rekordów, które zostały dodane lub zmieniły istniejący odczyt.
+     */
+    size_t Commit(WriteAheadLog::Operation operation, vector<EnergyData>& records);
+
+    /**
+     * @brief Rozpoczyna nowy plik dziennika i zapisuje w tle migawkę obejmującą poprzednie.
+     *
+     * Wymaga zajętej na wyłączność blokady `_mutex`.
+     */
+    void StartCompaction();
+
+    /**
+     * @brief Zwraca kopię wszystkich rekordów w porządku chronologicznym.
+     *
+     * @return Wektor rekordów.
+     */
+    [[nodiscard]] vector<EnergyData> CollectAllData() const;
+
+    /**
+     * @brief Zwraca ścieżkę do pliku dziennika zapisów o podanym numerze pokolenia.
+     *
+     * @param generation Numer pokolenia.
+     * @return Ścieżka do pliku.
+     */
+    [[nodiscard]] string GetWalPath(uint64_t generation) const;
+
+    /**
+     * @brief Wstawia rekord do struktury danych (lata, miesiące, dni, kubełki, dane).
+     *
+     * Aktualizuje agregaty kubełka, dnia, miesiąca i roku, do których trafia rekord.
+     *
+     * @param record Rekord do wstawienia.
+     * @param policy Sposób rozstrzygania kolizji z odczytem już zapisanym w slocie.
+     * @param samples Liczba odczytów, z których powstał rekord (waga przy uśrednianiu duplikatów).
+     * @return `true`, jeśli rekord został dodany lub zmienił istniejący odczyt, `false` w przeciwnym razie.
+     */
+    bool InsertData(const EnergyData& record, DuplicatePolicy policy, int samples = 1);
+
+    /**
+     * @brief Aktualizuje agregaty kubełka oraz bieżącego dnia, miesiąca i roku po zastąpieniu odczytu.
+     *
+     * Sumy zmieniają się o różnicę wartości, a wartości skrajne są składane na nowo tylko na
+     * poziomach, na których zastąpiona wartość była wartością skrajną.
+     *
+     * @param quarter Kubełek bieżącego dnia, w którym zastąpiono odczyt.
+     * @param previous Zastąpiony odczyt.
+     * @param current Nowy odczyt.
+     */
+    void RebuildAggregates(const Quarter& quarter, const Data& previous, const Data& current) const;
+
+    /**
+     * @brief Aktualizuje komórkę kostki agregatów po zastąpieniu odczytu w bieżącym miesiącu.
+     *
+     * Sumy zmieniają się o różnicę wartości. Wartości skrajne są składane na nowo z odczytów
+     * tego samego slotu doby w dniach bieżącego miesiąca przypadających w ten sam dzień
+     * tygodnia (najwyżej pięć dni) tylko wtedy, gdy zastąpiona wartość była wartością skrajną.
+     *
+     * @param dateTime Data i godzina zastąpionego odczytu.
+     * @param previous Zastąpiony odczyt.
+     * @param current Nowy odczyt.
+     */
+    void RebuildCubeCell(const DateTime& dateTime, const Data& previous, const Data& current);
+
+    /**
+     * @brief Ustawia rok, miesiąc i dzień bieżącego rekordu na istniejące elementy (`nullptr` dla brakujących).
+     *
+     * @param dateTime Data pomiaru.
+     */
+    void MoveCursor(const DateTime& dateTime);
+
+    /**
+     * @brief Dołącza nowy dzień do struktury, tworząc w razie potrzeby jego rok i miesiąc, i ustawia na nim kursor.
      *
-     * @param energyData Wektor wskaźników do obiektów EnergyData.
-     * @return Wskaźnik do wektora lat.
+     * @param dateTime Data pomiaru.
+     * @param day Nowy dzień (struktura przejmuje go na własność).
      */
-    static vector<Year*>* createYears(const std::vector<EnergyData*>* energyData);
+    void AttachDay(const DateTime& dateTime, Day* day);
 };
 
 #endif //ENERGYANALYZER_HPP
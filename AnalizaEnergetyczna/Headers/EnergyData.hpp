@@ -3,10 +3,49 @@
 
 using namespace std;
 
-#include <vector>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <fstream>
+#include <functional>
+#include <ios>
+#include <optional>
 
+#include "CsvDialect.hpp"
 #include "DateTime.hpp"
+#include "Data.hpp"
+
+/**
+ * @brief Zbiór kolumn wartości wczytywanych z pliku CSV (bit `1 << Metric` dla każdej wielkości).
+ */
+using ColumnSet = uint8_t;
+
+/**
+ * @brief Zbiór wszystkich kolumn wartości.
+ */
+constexpr ColumnSet AllColumns = (1 << MetricCount) - 1;
+
+/**
+ * @brief Zwraca zbiór zawierający kolumnę jednej wielkości.
+ *
+ * @param metric Wielkość.
+ * @return Zbiór kolumn.
+ */
+constexpr ColumnSet ColumnOf(const Metric metric) {
+    return static_cast<ColumnSet>(1 << static_cast<int>(metric));
+}
+
+/**
+ * @brief Zakres zapisu przebiegu wczytywania pliku CSV w plikach logów (`log_*.txt` i `log_error_*.txt`).
+ */
+enum class LineLogging {
+    /** Każda linia trafia do logu, a pliki logów są opróżniane po każdej linii. */
+    All,
+    /** Do logów trafiają tylko błędne linie, bez opróżniania plików po każdej z nich; pliki są tworzone dopiero przy pierwszym błędzie. */
+    ErrorsOnly,
+    /** Pliki logów nie są tworzone (np. przy wielokrotnym wczytywaniu fragmentów tego samego pliku). */
+    None
+};
 
 /**
  * @brief Klasa reprezentująca pojedynczy rekord danych z pomiarów energii wczytany z pliku CSV.
@@ -16,33 +55,35 @@ using namespace std;
  */
 class EnergyData {
 public:
+    /**
+     * @brief Funkcja parsująca linię pliku CSV jednej odmiany (patrz `GetLineParser`).
+     *
+     * Nie zgłasza wyjątków - dla niepoprawnej linii zwraca pusty wynik i, jeśli `error` nie jest
+     * `nullptr`, zapisuje w nim opis błędu (budowany tylko w takim przypadku).
+     */
+    using LineParser = optional<EnergyData> (*)(string_view line, optional<DateTime> &previous, ColumnSet columns,
+                                                string *error);
+
     /**
      * @brief Konstruktor klasy EnergyData.
      *
      * Tworzy obiekt EnergyData z podanymi wartościami.
      *
-     * @param dateTime Wskaźnik do obiektu DateTime reprezentującego datę i godzinę pomiaru.
+     * @param dateTime Data i godzina pomiaru.
      * @param autoConsumption Wartość autokonsumpcji energii (w watach [W]).
      * @param exportW Wartość eksportu energii (w watach [W]).
      * @param import Wartość importu energii (w watach [W]).
      * @param consumption Wartość zużycia energii (poboru) (w watach [W]).
      * @param generation Wartość produkcji energii (w watach [W]).
      */
-    EnergyData(DateTime* dateTime, double autoConsumption, double exportW, double import, double consumption, double generation);
-
-    /**
-     * @brief Destruktor klasy EnergyData.
-     *
-     * Zwalnia pamięć zaalokowaną dla obiektu DateTime.
-     */
-    ~EnergyData();
+    EnergyData(const DateTime& dateTime, double autoConsumption, double exportW, double import, double consumption, double generation);
 
     /**
      * @brief Zwraca referencję do obiektu DateTime reprezentującego datę i godzinę pomiaru.
      *
      * @return Referencja do obiektu DateTime.
      */
-    [[nodiscard]] DateTime& GetDateTime() const;
+    [[nodiscard]] const DateTime& GetDateTime() const;
 
     /**
      * @brief Zwraca wartość autokonsumpcji energii.
@@ -80,21 +121,89 @@ public:
     [[nodiscard]] double GetGeneration() const;
 
     /**
-     * @brief Wczytuje dane z pliku CSV i zwraca wektor wskaźników do obiektów EnergyData.
+     * @brief Wczytuje dane z pliku CSV i przekazuje każdy poprawnie sparsowany rekord do odbiorcy.
+     *
+     * Pomija pierwszą linię pliku (nagłówek). Odmiana pliku (separator, cudzysłowy, separator dziesiętny,
+     * układ daty) jest rozpoznawana raz, przed wczytaniem (patrz `CsvDialect::DetectFile`), i wszystkie
+     * linie są parsowane wersją parsera wyspecjalizowaną dla tej odmiany. Rekordy nie są nigdzie buforowane - odbiorca
+     * dostaje każdy z nich zaraz po sparsowaniu linii i może go przenieść bezpośrednio
+     * do docelowej struktury danych.
+     *
+     * Zwracana pozycja pozwala później doczytywać tylko linie dopisane do pliku
+     * (patrz `EnergyDataFollower`).
+     *
+     * Plik skompresowany (gzip lub zstd, rozpoznawany po pierwszych bajtach) jest rozpakowywany
+     * w pamięci, w osobnym wątku równolegle z parsowaniem (patrz `CompressedInput`).
+     *
+     * @param filepath Ścieżka do pliku CSV.
+     * @param consumer Funkcja wywoływana dla każdego wczytanego rekordu.
+     * @param columns Kolumny wartości do wczytania; pozostałe są pomijane bez konwersji (patrz `ParseLine`).
+     * @param logging Zakres zapisu wczytywanych linii w plikach logów.
+     * @return Pozycja w pliku (w bajtach) tuż za ostatnią wczytaną kompletną linią (0 dla pliku skompresowanego).
+     * @throws runtime_error Jeśli nie można otworzyć pliku lub plik skompresowany jest uszkodzony.
+     */
+    static streamoff ReadEnergyData(const string &filepath, const function<void(EnergyData &&)> &consumer,
+                                    ColumnSet columns = AllColumns, LineLogging logging = LineLogging::All);
+
+    /**
+     * @brief Wczytuje z pliku CSV tylko linie z podanego zakresu bajtów.
      *
-     * Pomija pierwszą linię pliku (nagłówek).
+     * Pozwala odpowiadać na zapytania bez wczytywania całego pliku (patrz `SparseIndex`).
+     * Zakres musi zaczynać się na początku linii; wczytywane są linie zaczynające się przed `end`.
      *
      * @param filepath Ścieżka do pliku CSV.
-     * @return Wektor wskaźników do obiektów EnergyData.
-     * @throws runtime_error Jeśli nie można otworzyć pliku lub jeśli wystąpi błąd podczas parsowania danych.
+     * @param begin Pozycja (w bajtach) początku pierwszej linii do wczytania.
+     * @param end Pozycja, od której linie nie są już wczytywane (-1 oznacza koniec pliku).
+     * @param previous Znacznik czasu linii poprzedzającej `begin`, jeśli jest potrzebny
+     *                 do rozpoznania godziny powtarzanej przy zmianie czasu.
+     * @param consumer Funkcja wywoływana dla każdego wczytanego rekordu.
+     * @param columns Kolumny wartości do wczytania.
+     * @param logging Zakres zapisu wczytywanych linii w plikach logów (`LineLogging::None` przy
+     *                zapytaniach, aby każde z nich nie tworzyło nowych plików logów).
+     * @return Pozycja w pliku (w bajtach) tuż za ostatnią wczytaną kompletną linią.
+     * @throws runtime_error Jeśli nie można otworzyć pliku.
      */
-    static vector<EnergyData*>* ReadEnergyData(const string &filepath);
+    static streamoff ReadEnergyDataSlice(const string &filepath, streamoff begin, streamoff end,
+                                         optional<DateTime> previous,
+                                         const function<void(EnergyData &&)> &consumer,
+                                         ColumnSet columns = AllColumns, LineLogging logging = LineLogging::All);
+
+    /**
+     * @brief Parsuje pojedynczą linię pliku CSV w odmianie eksportu falownika (`ExporterDialect`).
+     *
+     * Linia z godziny powtarzanej przy zmianie czasu z letniego na zimowy jest rozpoznawana
+     * na podstawie poprzednio sparsowanego znacznika czasu, który jest aktualizowany.
+     *
+     * Pola są wyznaczane bezpośrednio w buforze linii, bez kopiowania. Wartości kolumn spoza
+     * `columns` nie są konwertowane ani sprawdzane - rekord dostaje w ich miejscu NaN.
+     *
+     * @param line Linia pliku CSV.
+     * @param previous Znacznik czasu poprzedniej poprawnie sparsowanej linii (aktualizowany).
+     * @param columns Kolumny wartości do wczytania.
+     * @return Sparsowany rekord.
+     * @throws std::invalid_argument Jeśli linia nie zawiera poprawnych wartości.
+     */
+    static EnergyData ParseLine(string_view line, optional<DateTime> &previous, ColumnSet columns = AllColumns);
+
+    /**
+     * @brief Zwraca parser linii wyspecjalizowany dla odmiany pliku CSV.
+     *
+     * Separator, cudzysłowy, separator dziesiętny i układ daty są parametrami szablonu parsera,
+     * więc pętla parsowania nie sprawdza odmiany przy każdym polu. Parser zachowuje się jak
+     * `ParseLine` (także przy rozpoznawaniu godziny powtarzanej i pomijaniu kolumn), ale
+     * niepoprawną linię zgłasza pustym wynikiem zamiast wyjątkiem - plik z wieloma błędnymi
+     * liniami jest wczytywany równie szybko jak poprawny.
+     *
+     * @param dialect Odmiana pliku.
+     * @return Parser linii.
+     */
+    [[nodiscard]] static LineParser GetLineParser(const CsvDialect &dialect);
 
 private:
     /**
-     * @brief Wskaźnik do obiektu DateTime reprezentującego datę i godzinę pomiaru.
+     * @brief Data i godzina pomiaru.
      */
-    DateTime* _dateTime;
+    DateTime _dateTime;
     /**
      * @brief Wartość autokonsumpcji energii (w watach [W]).
      */
@@ -123,6 +232,105 @@ private:
      */
     static string GetCurrentDateTimeFormatted();
 
+    /**
+     * @brief Wczytuje kolejne linie z otwartego pliku CSV, śledząc pozycję za ostatnią kompletną linią.
+     *
+     * @param inputFile Plik ustawiony na początku pierwszej linii do wczytania (zamykany po wczytaniu).
+     * @param parser Parser linii odmiany pliku.
+     * @param end Pozycja, od której linie nie są już wczytywane (-1 oznacza koniec pliku).
+     * @param previous Znacznik czasu linii poprzedzającej pierwszą wczytywaną linię.
+     * @param consumer Funkcja wywoływana dla każdego wczytanego rekordu.
+     * @param columns Kolumny wartości do wczytania.
+     * @param logging Zakres zapisu wczytywanych linii w plikach logów.
+     * @return Pozycja w pliku (w bajtach) tuż za ostatnią wczytaną kompletną linią.
+     */
+    static streamoff ReadStream(ifstream &inputFile, LineParser parser, streamoff end, optional<DateTime> previous,
+                                const function<void(EnergyData &&)> &consumer, ColumnSet columns,
+                                LineLogging logging);
+
+    /**
+     * @brief Parsuje kolejne linie i zapisuje przebieg wczytywania w plikach logów.
+     *
+     * @param nextLine Funkcja zwracająca kolejną linię (false na końcu danych).
+     * @param parser Parser linii odmiany pliku.
+     * @param previous Znacznik czasu linii poprzedzającej pierwszą wczytywaną linię.
+     * @param consumer Funkcja wywoływana dla każdego wczytanego rekordu.
+     * @param columns Kolumny wartości do wczytania.
+     * @param logging Zakres zapisu wczytywanych linii w plikach logów.
+     */
+    static void ReadLines(const function<bool(string_view &)> &nextLine, LineParser parser,
+                          optional<DateTime> previous, const function<void(EnergyData &&)> &consumer, ColumnSet columns,
+                          LineLogging logging);
+
+    /**
+     * @brief Parsuje pojedynczą linię pliku CSV podanej odmiany.
+     *
+     * @tparam Separator Znak oddzielający pola.
+     * @tparam Quoted Czy pola mogą być ujęte w cudzysłowy.
+     * @tparam Decimal Separator dziesiętny.
+     * @tparam Layout Układ daty i godziny.
+     * @param line Linia pliku CSV.
+     * @param previous Znacznik czasu poprzedniej poprawnie sparsowanej linii (aktualizowany).
+     * @param columns Kolumny wartości do wczytania.
+     * @param error Miejsce na opis błędu (może być `nullptr`).
+     * @return Sparsowany rekord lub pusty wynik, jeśli linia nie zawiera poprawnych wartości.
+     */
+    template <char Separator, bool Quoted, char Decimal, DateLayout Layout>
+    static optional<EnergyData> ParseLineAs(string_view line, optional<DateTime> &previous, ColumnSet columns,
+                                            string *error);
+
+    /**
+     * @brief Wybiera parser dla odmiany o danym separatorze pól.
+     *
+     * @tparam Separator Znak oddzielający pola.
+     * @param dialect Odmiana pliku.
+     * @return Parser linii.
+     */
+    template <char Separator>
+    static LineParser SelectParser(const CsvDialect &dialect);
+
+    /**
+     * @brief Oznacza znacznik czasu jako drugie wystąpienie godziny powtarzanej przy zmianie czasu, jeśli nim jest.
+     *
+     * @param parsed Sparsowany znacznik czasu.
+     * @param previous Znacznik czasu poprzedniej poprawnie sparsowanej linii.
+     * @return Znacznik czasu rekordu.
+     */
+    static DateTime ResolveRepeatedHour(const DateTime &parsed, const optional<DateTime> &previous);
+
+    /**
+     * @brief Odcina z początku linii kolejne pole (do separatora) i zwraca je bez cudzysłowów i białych znaków.
+     *
+     * @tparam Separator Znak kończący pole.
+     * @tparam Quoted Czy pole ujęte w cudzysłowy może zawierać separator.
+     * @param rest Pozostała część linii (skracana o pole i separator).
+     * @return Widok na zawartość pola.
+     */
+    template <char Separator, bool Quoted = false>
+    static string_view NextField(string_view &rest);
+
+    /**
+     * @brief Konwertuje pole na liczbę całkowitą.
+     *
+     * @param field Pole tekstowe.
+     * @param value Wartość pola.
+     * @param error Miejsce na opis błędu (może być `nullptr`).
+     * @return false, jeśli pole nie jest w całości liczbą całkowitą, true w przeciwnym razie.
+     */
+    static bool ParseInt(string_view field, int &value, string *error);
+
+    /**
+     * @brief Konwertuje pole na liczbę zmiennoprzecinkową.
+     *
+     * @tparam Decimal Separator dziesiętny.
+     * @param field Pole tekstowe.
+     * @param value Wartość pola.
+     * @param error Miejsce na opis błędu (może być `nullptr`).
+     * @return false, jeśli pole nie jest w całości liczbą (np. `1,5` przy kropce dziesiętnej), true w przeciwnym razie.
+     */
+    template <char Decimal = '.'>
+    static bool ParseDouble(string_view field, double &value, string *error);
+
     /**
      * @brief Tworzy lub otwiera plik w bieżącym katalogu roboczym programu.
      *
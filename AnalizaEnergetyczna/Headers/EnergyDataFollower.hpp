@@ -0,0 +1,84 @@
+#ifndef ENERGYDATAFOLLOWER_HPP
+#define ENERGYDATAFOLLOWER_HPP
+
+#include <functional>
+#include <ios>
+#include <optional>
+#include <string>
+
+#include "EnergyData.hpp"
+
+using namespace std;
+
+/**
+ * @brief Klasa doczytująca rekordy dopisywane na bieżąco do pliku CSV.
+ *
+ * Pamięta pozycję (w bajtach) za ostatnią przetworzoną linią i przy każdym wywołaniu `Poll`
+ * parsuje wyłącznie kompletne linie dopisane od poprzedniego wywołania - wcześniejsza część
+ * pliku nigdy nie jest czytana ponownie. Linia bez znaku końca linii (zapisywana właśnie przez
+ * inny proces) czeka do następnego wywołania. Jeśli plik został skrócony lub zastąpiony nowym,
+ * jest czytany od początku (z pominięciem nagłówka).
+ */
+class EnergyDataFollower {
+public:
+    /**
+     * @brief Konstruktor klasy EnergyDataFollower.
+     *
+     * @param filepath Ścieżka do śledzonego pliku CSV.
+     * @param offset Pozycja w pliku, od której należy czytać (0 - od początku pliku, z pominięciem nagłówka).
+     * @param previous Znacznik czasu ostatniego rekordu przed pozycją `offset`, jeśli jest znany.
+     * @param columns Kolumny wartości do wczytania.
+     */
+    explicit EnergyDataFollower(string filepath, streamoff offset = 0, optional<DateTime> previous = nullopt,
+                                ColumnSet columns = AllColumns);
+
+    /**
+     * @brief Parsuje linie dopisane do pliku od poprzedniego wywołania.
+     *
+     * @param consumer Funkcja wywoływana dla każdego poprawnie sparsowanego rekordu.
+     * @return Liczba przekazanych rekordów (0, jeśli plik nie istnieje lub nic nie dopisano).
+     */
+    size_t Poll(const function<void(EnergyData &&)> &consumer);
+
+    /**
+     * @brief Zwraca pozycję w pliku tuż za ostatnią przetworzoną linią.
+     *
+     * @return Pozycja w bajtach.
+     */
+    [[nodiscard]] streamoff GetOffset() const;
+
+    /**
+     * @brief Zwraca liczbę pominiętych linii, których nie udało się sparsować.
+     *
+     * @return Liczba pominiętych linii.
+     */
+    [[nodiscard]] size_t GetSkippedLines() const;
+
+private:
+    /**
+     * @brief Ścieżka do śledzonego pliku CSV.
+     */
+    string _filepath;
+    /**
+     * @brief Pozycja w pliku tuż za ostatnią przetworzoną linią.
+     */
+    streamoff _offset;
+    /**
+     * @brief Znacznik czasu ostatniego sparsowanego rekordu (do rozpoznania godziny powtarzanej).
+     */
+    optional<DateTime> _previous;
+    /**
+     * @brief Kolumny wartości do wczytania.
+     */
+    ColumnSet _columns;
+    /**
+     * @brief Parser linii odmiany śledzonego pliku (rozpoznawanej przy pierwszym odczycie).
+     */
+    EnergyData::LineParser _parser = nullptr;
+    /**
+     * @brief Liczba pominiętych linii.
+     */
+    size_t _skippedLines = 0;
+};
+
+#endif //ENERGYDATAFOLLOWER_HPP
@@ -0,0 +1,184 @@
+#ifndef ENERGYDATAMERGER_HPP
+#define ENERGYDATAMERGER_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "EnergyData.hpp"
+
+using namespace std;
+
+/**
+ * @brief Klasa wczytująca dane z wielu plików CSV (np. jeden plik na miesiąc i licznik) jako jeden strumień.
+ *
+ * Pliki są parsowane równolegle, każdy w osobnym wątku, a ich uporządkowane chronologicznie
+ * rekordy są scalane (k-way merge) w jeden strumień rosnący w czasie. Rekordy o tym samym
+ * znaczniku czasu trafiają do strumienia w kolejności plików (według nazwy), więc etap
+ * usuwania duplikatów (`DuplicateResolver`) rozstrzyga je deterministycznie.
+ *
+ * Pliki uporządkowane (zwykły przypadek) są czytane leniwie, przez ograniczoną kolejkę
+ * rekordów, więc w pamięci jest naraz tylko kilka bloków rekordów każdego pliku. W całości
+ * wczytywane i sortowane są tylko pliki, których rekordy okazały się nieuporządkowane.
+ */
+class EnergyDataMerger {
+public:
+    /**
+     * @brief Sprawdza, czy ścieżka wskazuje wiele plików (katalog lub wzorzec z `*` lub `?` w nazwie pliku).
+     *
+     * @param path Ścieżka do sprawdzenia.
+     * @return true, jeśli ścieżka jest katalogiem lub wzorcem, false w przeciwnym razie.
+     */
+    [[nodiscard]] static bool IsMultiFilePath(const string& path);
+
+    /**
+     * @brief Zwraca pliki wskazywane przez ścieżkę.
+     *
+     * Dla katalogu są to wszystkie pliki `.csv` (także skompresowane `.csv.gz` i `.csv.zst`) w nim zawarte,
+     * dla wzorca (np. `dane/licznik1_*.csv`) - pliki z katalogu wzorca pasujące do nazwy. Pliki są uporządkowane według ścieżki.
+     *
+     * @param path Katalog, wzorzec lub ścieżka do pojedynczego pliku.
+     * @return Ścieżki plików.
+     * @throws std::runtime_error Jeśli żaden plik nie pasuje do ścieżki.
+     */
+    [[nodiscard]] static vector<string> ResolveFiles(const string& path);
+
+    /**
+     * @brief Wczytuje pliki CSV i przekazuje ich rekordy do odbiorcy w porządku chronologicznym.
+     *
+     * @param files Ścieżki plików.
+     * @param consumer Funkcja wywoływana dla każdego rekordu scalonego strumienia.
+     * @param columns Kolumny wartości do wczytania.
+     * @param threads Największa liczba plików jednocześnie sprawdzanych i sortowanych (0 - liczba rdzeni procesora).
+     * @return Liczba przekazanych rekordów.
+     * @throws std::runtime_error Jeśli nie można otworzyć któregoś z plików.
+     */
+    static size_t ReadEnergyData(const vector<string>& files, const function<void(EnergyData&&)>& consumer,
+                                 ColumnSet columns = AllColumns, unsigned threads = 0);
+
+private:
+    /**
+     * @brief Uporządkowany strumień rekordów jednego pliku, z którego scalanie pobiera kolejne rekordy.
+     *
+     * Strumień pliku uporządkowanego jest wypełniany przez osobny wątek parsujący plik do
+     * ograniczonej kolejki bloków rekordów - wątek czeka, gdy kolejka jest pełna. Strumień
+     * pliku nieuporządkowanego zawiera od razu wszystkie jego rekordy, już posortowane.
+     */
+    class FileStream {
+    public:
+        /**
+         * @brief Liczba rekordów w jednym bloku kolejki.
+         */
+        static constexpr size_t BlockSize = 1024;
+
+        /**
+         * @brief Największa liczba bloków oczekujących w kolejce.
+         */
+        static constexpr size_t MaxQueuedBlocks = 4;
+
+        /**
+         * @brief Uruchamia wątek parsujący uporządkowany plik.
+         *
+         * @param filepath Ścieżka do pliku.
+         * @param columns Kolumny wartości do wczytania.
+         */
+        FileStream(const string& filepath, ColumnSet columns);
+
+        /**
+         * @brief Tworzy strumień z rekordów wczytanych już w całości.
+         *
+         * @param records Rekordy uporządkowane chronologicznie.
+         */
+        explicit FileStream(vector<EnergyData>&& records);
+
+        /**
+         * @brief Zatrzymuje wątek parsujący i czeka na jego zakończenie.
+         */
+        ~FileStream();
+
+        FileStream(const FileStream&) = delete;
+        FileStream& operator=(const FileStream&) = delete;
+
+        /**
+         * @brief Zwraca bieżący rekord strumienia.
+         *
+         * @return Wskaźnik do rekordu lub nullptr na końcu strumienia.
+         * @throws std::runtime_error Jeśli wątek parsujący zgłosił błąd.
+         */
+        EnergyData* Peek();
+
+        /**
+         * @brief Przechodzi do następnego rekordu strumienia.
+         */
+        void Pop();
+
+    private:
+        /**
+         * @brief Blok, z którego pobierane są rekordy.
+         */
+        vector<EnergyData> _current;
+
+        /**
+         * @brief Pozycja bieżącego rekordu w bloku `_current`.
+         */
+        size_t _position = 0;
+
+        /**
+         * @brief Bloki sparsowane przez wątek, oczekujące na pobranie.
+         */
+        deque<vector<EnergyData>> _blocks;
+
+        /**
+         * @brief Czy wątek parsujący zakończył pracę.
+         */
+        bool _finished = true;
+
+        /**
+         * @brief Błąd zgłoszony przez wątek parsujący.
+         */
+        exception_ptr _error;
+
+        /**
+         * @brief Blokada kolejki.
+         */
+        mutex _mutex;
+
+        /**
+         * @brief Zmienna warunkowa sygnalizująca zmianę stanu kolejki.
+         */
+        condition_variable_any _changed;
+
+        /**
+         * @brief Wątek parsujący plik.
+         */
+        jthread _thread;
+
+        /**
+         * @brief Przekazuje sparsowany blok do kolejki, czekając na wolne miejsce.
+         *
+         * @param token Token zatrzymania wątku parsującego.
+         * @param block Blok rekordów.
+         * @return false, jeśli zażądano zatrzymania wątku, true w przeciwnym razie.
+         */
+        bool Push(const stop_token& token, vector<EnergyData>&& block);
+    };
+
+    /**
+     * @brief Sprawdza, czy nazwa pasuje do wzorca z symbolami `*` (dowolny ciąg) i `?` (dowolny znak).
+     *
+     * @param name Nazwa pliku.
+     * @param pattern Wzorzec.
+     * @return true, jeśli nazwa pasuje do wzorca, false w przeciwnym razie.
+     */
+    [[nodiscard]] static bool MatchesPattern(string_view name, string_view pattern);
+};
+
+#endif //ENERGYDATAMERGER_HPP
@@ -0,0 +1,39 @@
+#ifndef ENERGYDATASORTER_HPP
+#define ENERGYDATASORTER_HPP
+
+#include <vector>
+
+#include "EnergyData.hpp"
+
+using namespace std;
+
+/**
+ * @brief Klasa porządkująca rekordy EnergyData rosnąco według daty i godziny pomiaru.
+ *
+ * Sortowanie odbywa się bez porównań - sortowaniem pozycyjnym LSD (radix sort) po
+ * spakowanym znaczniku czasu (`DateTime::GetSortKey`). Jest stabilne, więc rekordy
+ * o tym samym znaczniku czasu zachowują kolejność z pliku.
+ */
+class EnergyDataSorter {
+public:
+    /**
+     * @brief Sprawdza w jednym przebiegu, czy rekordy są już uporządkowane rosnąco w czasie.
+     *
+     * @param records Wektor rekordów do sprawdzenia.
+     * @return `true`, jeśli rekordy są uporządkowane, `false` w przeciwnym razie.
+     */
+    [[nodiscard]] static bool IsSorted(const vector<EnergyData> &records);
+
+    /**
+     * @brief Porządkuje rekordy rosnąco według daty i godziny pomiaru.
+     *
+     * Jeśli rekordy są już uporządkowane, funkcja kończy się po jednym przebiegu sprawdzającym.
+     * W przeciwnym razie wykonywane jest sortowanie pozycyjne LSD po 8-bitowych cyfrach klucza,
+     * z pominięciem cyfr, które są takie same we wszystkich rekordach (np. rok).
+     *
+     * @param records Wektor rekordów do posortowania (modyfikowany w miejscu).
+     */
+    static void SortByDateTime(vector<EnergyData> &records);
+};
+
+#endif //ENERGYDATASORTER_HPP
@@ -0,0 +1,120 @@
+#ifndef GRIDRESAMPLER_HPP
+#define GRIDRESAMPLER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+
+#include "EnergyData.hpp"
+
+using namespace std;
+
+/**
+ * @brief Wartość parametru `resampleGapSlots` wyłączająca przepróbkowanie przy wczytywaniu.
+ */
+constexpr int NoResampling = -1;
+
+/**
+ * @brief Etap wczytywania przepróbkowujący uporządkowany strumień rekordów na siatkę 15-minutowych slotów.
+ *
+ * Liczniki raportujące co 1 lub 5 minut dają kilka odczytów na slot (`Quarter::SlotMinutes`).
+ * Etap zastępuje je jednym rekordem ze znacznikiem czasu początku slotu i średnią arytmetyczną
+ * mocy z odczytów slotu. Krótkie luki (najwyżej `maxGapSlots` pustych slotów) między dwoma
+ * slotami z odczytami są wypełniane interpolacją liniową.
+ *
+ * Stan etapu to tylko sumy bieżącego slotu i ostatni wysłany rekord, więc etap działa w stałej
+ * pamięci niezależnie od kadencji licznika. Rekord slotu jest wysyłany dopiero po nadejściu
+ * odczytu z późniejszego slotu (lub po `Flush`). Godzina powtarzana przy zmianie czasu ma
+ * własne sloty; luki przylegające do niej nie są interpolowane.
+ */
+class GridResampler {
+public:
+    /**
+     * @brief Konstruktor klasy GridResampler.
+     *
+     * @param maxGapSlots Największa liczba kolejnych pustych slotów wypełnianych interpolacją (0 wyłącza interpolację).
+     * @param consumer Odbiorca rekordów wynikowych; dostaje rekord i liczbę odczytów, z których powstał.
+     * @throws std::invalid_argument Jeśli `maxGapSlots` jest ujemne.
+     */
+    GridResampler(int maxGapSlots, function<void(EnergyData &&, int)> consumer);
+
+    /**
+     * @brief Przekazuje kolejny rekord uporządkowanego strumienia.
+     *
+     * @param record Rekord do przetworzenia.
+     */
+    void Push(EnergyData &&record);
+
+    /**
+     * @brief Przekazuje odbiorcy rekord bieżącego slotu. Należy wywołać po ostatnim rekordzie strumienia.
+     */
+    void Flush();
+
+    /**
+     * @brief Zwraca liczbę slotów wypełnionych interpolacją.
+     *
+     * @return Liczba slotów.
+     */
+    [[nodiscard]] size_t GetInterpolatedCount() const;
+
+private:
+    /**
+     * @brief Liczba wielkości w rekordzie.
+     */
+    static constexpr int ValueCount = 5;
+
+    /**
+     * @brief Slot siatki wraz z wartościami.
+     */
+    struct Slot {
+        /**
+         * @brief Numer slotu liczony od 1.01.1970 (96 slotów na dobę).
+         */
+        int64_t Index;
+        /**
+         * @brief Czy slot należy do godziny powtarzanej przy zmianie czasu.
+         */
+        bool Repeated;
+        /**
+         * @brief Sumy (dla bieżącego slotu) lub średnie (dla ostatnio wysłanego) wartości wielkości.
+         */
+        array<double, ValueCount> Values;
+    };
+
+    /**
+     * @brief Największa liczba kolejnych pustych slotów wypełnianych interpolacją.
+     */
+    int _maxGapSlots;
+    /**
+     * @brief Odbiorca rekordów wynikowych.
+     */
+    function<void(EnergyData &&, int)> _consumer;
+    /**
+     * @brief Slot, do którego trafiają bieżące odczyty.
+     */
+    optional<Slot> _current;
+    /**
+     * @brief Liczba odczytów bieżącego slotu.
+     */
+    int _currentSamples = 0;
+    /**
+     * @brief Ostatni wysłany slot (punkt początkowy interpolacji).
+     */
+    optional<Slot> _last;
+    /**
+     * @brief Liczba slotów wypełnionych interpolacją.
+     */
+    size_t _interpolatedCount = 0;
+
+    /**
+     * @brief Wysyła odbiorcy rekord slotu.
+     *
+     * @param slot Slot ze średnimi wartościami wielkości.
+     * @param samples Liczba odczytów, z których powstał rekord.
+     */
+    void Emit(const Slot &slot, int samples);
+};
+
+#endif //GRIDRESAMPLER_HPP
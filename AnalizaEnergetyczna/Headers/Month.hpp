@@ -28,7 +28,7 @@ public:
     /**
      * @brief Destruktor klasy Month.
      *
-     * Zwalnia pamięć zaalokowaną dla obiektów Day.
+     * Zwalnia pamięć zaalokowaną dla obiektów Day oraz agregatu.
      */
     ~Month();
 
@@ -46,6 +46,24 @@ public:
      */
     [[nodiscard]] vector<Day*>& GetDays() const;
 
+    /**
+     * @brief Zwraca agregat (sumy i liczbę rekordów) wszystkich danych miesiąca.
+     *
+     * Agregat jest aktualizowany przy każdym wstawieniu lub zastąpieniu rekordu.
+     *
+     * @return Referencja do agregatu.
+     */
+    [[nodiscard]] Aggregate& GetAggregate() const;
+
+    /**
+     * @brief Zwraca szkic rozkładu wartości wszystkich danych miesiąca.
+     *
+     * Szkic jest aktualizowany przy każdym wstawieniu lub zastąpieniu rekordu.
+     *
+     * @return Referencja do szkicu.
+     */
+    [[nodiscard]] QuantileSketch& GetSketch() const;
+
 private:
     /**
      * @brief Numer miesiąca (1-12).
@@ -55,6 +73,14 @@ private:
      * @brief Wskaźnik do wektora wskaźników do obiektów Day reprezentujących dni miesiąca.
      */
     vector<Day*>* _days;
+    /**
+     * @brief Wskaźnik do agregatu danych miesiąca.
+     */
+    Aggregate* _aggregate;
+    /**
+     * @brief Wskaźnik do szkicu rozkładu wartości danych miesiąca.
+     */
+    QuantileSketch* _sketch;
 };
 
 #endif //MONTH_HPP
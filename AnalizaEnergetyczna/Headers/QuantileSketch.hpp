@@ -0,0 +1,172 @@
+#ifndef QUANTILESKETCH_HPP
+#define QUANTILESKETCH_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Data.hpp"
+
+using namespace std;
+
+/**
+ * @brief Scalany szkic rozkładu wartości wszystkich wielkości, pozwalający szacować percentyle.
+ *
+ * Szkic jest histogramem o kubełkach rosnących wykładniczo (jak DDSketch): wartość `x > 0`
+ * trafia do kubełka `i = ceil(log_γ x)` obejmującego przedział (γ^(i-1), γ^i], gdzie
+ * γ = (1 + α) / (1 - α), a α = `RelativeAccuracy`. Wartości ujemne mają osobny histogram
+ * modułów, a wartości o module mniejszym niż `MinIndexableValue` są liczone jako zera.
+ *
+ * Ranga szukanego percentyla jest wyznaczana dokładnie, więc szacunek jest reprezentantem
+ * kubełka zawierającego dokładny percentyl (metoda najbliższej rangi, patrz `GetRank`).
+ * Błąd szacunku `v'` dokładnej wartości `v` wynosi więc najwyżej |v' - v| <= α·|v|
+ * (dla |v| < `MinIndexableValue` - najwyżej `MinIndexableValue`), niezależnie od liczby
+ * i kolejności odczytów.
+ *
+ * Szkice można dodawać (`Merge`) bez utraty dokładności, dlatego każdy dzień, miesiąc i rok
+ * ma swój szkic, a zapytanie o przedział łączy szkice węzłów leżących w nim w całości.
+ * Liczba kubełków zależy tylko od zakresu wartości (ok. 115 kubełków na rząd wielkości).
+ * Wartości NaN (niewczytane kolumny) i nieskończone są pomijane.
+ */
+class QuantileSketch {
+public:
+    /**
+     * @brief Względna dokładność szacunku percentyla (α).
+     */
+    static constexpr double RelativeAccuracy = 0.01;
+
+    /**
+     * @brief Najmniejszy moduł wartości odróżniany od zera (w watach [W]).
+     */
+    static constexpr double MinIndexableValue = 1e-3;
+
+    /**
+     * @brief Dodaje wszystkie wartości rekordu do szkicu.
+     *
+     * @param data Rekord do dodania.
+     */
+    void Add(const Data& data);
+
+    /**
+     * @brief Usuwa wartości rekordu dodanego wcześniej do szkicu (np. przy zastąpieniu odczytu).
+     *
+     * @param data Rekord do usunięcia.
+     */
+    void Remove(const Data& data);
+
+    /**
+     * @brief Dodaje do szkicu wszystkie wartości innego szkicu.
+     *
+     * @param other Szkic do dołączenia.
+     */
+    void Merge(const QuantileSketch& other);
+
+    /**
+     * @brief Szacuje percentyl wartości wielkości.
+     *
+     * @param metric Wielkość.
+     * @param percentile Percentyl (0-100).
+     * @return Szacunek percentyla (NaN dla pustego szkicu).
+     */
+    [[nodiscard]] double GetPercentile(Metric metric, double percentile) const;
+
+    /**
+     * @brief Zwraca liczbę wartości wielkości w szkicu.
+     *
+     * @param metric Wielkość.
+     * @return Liczba wartości.
+     */
+    [[nodiscard]] size_t GetCount(Metric metric) const;
+
+    /**
+     * @brief Wyznacza rangę percentyla metodą najbliższej rangi.
+     *
+     * @param percentile Percentyl (0-100).
+     * @param count Liczba wartości (większa od zera).
+     * @return Numer (od 1) wartości w ciągu posortowanym rosnąco: `max(1, ceil(percentile / 100 · count))`.
+     */
+    [[nodiscard]] static size_t GetRank(double percentile, size_t count);
+
+private:
+    /**
+     * @brief Gęsta tablica liczników kolejnych kubełków.
+     */
+    struct Store {
+        /**
+         * @brief Numer kubełka pierwszego licznika.
+         */
+        int32_t Offset = 0;
+        /**
+         * @brief Liczniki kubełków od `Offset` wzwyż.
+         */
+        vector<uint32_t> Counts;
+
+        /**
+         * @brief Zmienia licznik kubełka, rozszerzając w razie potrzeby tablicę.
+         *
+         * @param index Numer kubełka.
+         * @param delta Zmiana licznika.
+         */
+        void Add(int32_t index, int64_t delta);
+    };
+
+    /**
+     * @brief Histogram wartości jednej wielkości.
+     */
+    struct Histogram {
+        /**
+         * @brief Kubełki wartości dodatnich.
+         */
+        Store Positive;
+        /**
+         * @brief Kubełki modułów wartości ujemnych.
+         */
+        Store Negative;
+        /**
+         * @brief Liczba wartości traktowanych jako zero.
+         */
+        size_t Zeros = 0;
+        /**
+         * @brief Liczba wszystkich wartości.
+         */
+        size_t Count = 0;
+    };
+
+    /**
+     * @brief Współczynnik wzrostu granic kubełków (γ).
+     */
+    static constexpr double Gamma = (1 + RelativeAccuracy) / (1 - RelativeAccuracy);
+
+    /**
+     * @brief Histogramy kolejnych wielkości (indeksowane wartością `Metric`).
+     */
+    array<Histogram, MetricCount> _histograms;
+
+    /**
+     * @brief Zmienia histogram wielkości o jedną wartość.
+     *
+     * @param histogram Histogram wielkości.
+     * @param value Wartość (NaN i nieskończoność są pomijane).
+     * @param delta 1 przy dodawaniu, -1 przy usuwaniu.
+     */
+    static void Update(Histogram& histogram, double value, int delta);
+
+    /**
+     * @brief Wyznacza numer kubełka dla modułu wartości.
+     *
+     * @param magnitude Moduł wartości (co najmniej `MinIndexableValue`).
+     * @return Numer kubełka.
+     */
+    static int32_t GetIndex(double magnitude);
+
+    /**
+     * @brief Zwraca reprezentanta kubełka - wartość o najmniejszym błędzie względnym dla całego kubełka.
+     *
+     * @param index Numer kubełka.
+     * @return Reprezentant kubełka `2γ^i / (γ + 1)`.
+     */
+    static double GetRepresentative(int32_t index);
+};
+
+#endif //QUANTILESKETCH_HPP
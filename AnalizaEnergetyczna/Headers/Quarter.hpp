@@ -2,88 +2,127 @@
 #define QUARTER_HPP
 
 #include <vector>
+#include <optional>
 
 #include "Time.hpp"
 #include "Data.hpp"
+#include "Aggregate.hpp"
 
 using namespace std;
 
 /**
- * @brief Klasa reprezentująca kwadrans (przedział czasowy) w ciągu dnia.
+ * @brief Klasa reprezentująca kubełek (przedział czasowy) w ciągu dnia.
  *
- * Przechowuje informacje o godzinie rozpoczęcia i zakończenia kwadransa oraz dane pomiarowe
- * z tego okresu.
+ * Przechowuje informacje o godzinie rozpoczęcia i zakończenia kubełka oraz dane pomiarowe
+ * z tego okresu. Dane są adresowane slotami: każdy 15-minutowy odczyt ma w kubełku stałą
+ * pozycję wyznaczoną przez jego minutę, więc dane są zawsze uporządkowane w czasie i nie
+ * wymagają ani przeszukiwania, ani sortowania.
+ *
+ * Drugie wystąpienie godziny powtarzanej przy zmianie czasu trafia do kubełka, w którym kończy
+ * się jej pierwsze wystąpienie - kubełek dostaje wtedy dodatkowe sloty dla tej godziny,
+ * wstawione zaraz po jej ostatnim slocie.
  */
 class Quarter {
 public:
+    /**
+     * @brief Długość pojedynczego slotu w minutach (rozdzielczość odczytów licznika).
+     */
+    static constexpr int SlotMinutes = 15;
+
     /**
      * @brief Konstruktor klasy Quarter.
      *
-     * Tworzy obiekt Quarter z podanymi godzinami rozpoczęcia i zakończenia.
-     * Inicjalizuje wektor danych.
+     * Tworzy obiekt Quarter rozpoczynający się o podanej minucie dnia i obejmujący podaną liczbę minut.
+     * Inicjalizuje puste sloty danych.
      *
-     * @param startHour Godzina rozpoczęcia kwadransa.
-     * @param endHour Godzina zakończenia kwadransa.
+     * @param startMinute Minuta dnia, od której zaczyna się kubełek (0-1439).
+     * @param lengthMinutes Długość kubełka w minutach (wielokrotność `SlotMinutes`).
      */
-    Quarter(int startHour, int endHour);
+    Quarter(int startMinute, int lengthMinutes);
 
     /**
      * @brief Destruktor klasy Quarter.
      *
-     * Zwalnia pamięć zaalokowaną dla obiektów Time oraz wektora danych.
+     * Zwalnia pamięć zaalokowaną dla obiektów Time, wektora danych oraz agregatu.
      */
     ~Quarter();
 
     /**
-     * @brief Dodaje dane pomiarowe do kwadransa, jeśli czas pomiaru mieści się w przedziale czasowym kwadransa.
+     * @brief Zwraca slot odpowiadający podanemu czasowi pomiaru.
      *
-     * @param time Referencja do stałej টাইম obiektu Time reprezentującego czas pomiaru.
-     * @param data Referencja do obiektu Data zawierającego dane pomiarowe.
-     * @return `true`, jeśli dane zostały dodane, `false` w przeciwnym razie.
-     */
-    bool AddData(const Time& time, Data& data) const;
-
-    /**
-     * @brief Sortuje dane pomiarowe w kwadransie rosnąco według czasu.
+     * Dla drugiego wystąpienia godziny powtarzanej przy zmianie czasu tworzy w razie potrzeby
+     * dodatkowe sloty tej godziny (tylko w kubełku, w którym kończy się ta godzina).
+     *
+     * Czas spoza 15-minutowej siatki (minuta niebędąca wielokrotnością `SlotMinutes`) nie ma
+     * slotu - taki odczyt nie może zająć slotu sąsiedniego odczytu ani zostać uznany za jego duplikat.
      *
-     * Dane są sortowane w miejscu, modyfikując kolejność elementów w wektorze `_data`.
+     * @param time Czas pomiaru.
+     * @return Wskaźnik do slotu lub `nullptr`, jeśli czas leży poza kubełkiem lub poza siatką slotów.
      */
-    void SortData() const;
+    optional<Data>* GetSlot(const Time& time);
 
     /**
-     * @brief Zwraca referencję do obiektu Time reprezentującego godzinę rozpoczęcia kwadransa.
+     * @brief Zwraca referencję do obiektu Time reprezentującego godzinę rozpoczęcia kubełka.
      *
      * @return Referencja do obiektu Time.
      */
     [[nodiscard]] Time& GetStartTime() const;
 
     /**
-     * @brief Zwraca referencję do obiektu Time reprezentującego godzinę zakończenia kwadransa.
+     * @brief Zwraca referencję do obiektu Time reprezentującego początek ostatniego slotu kubełka.
      *
      * @return Referencja do obiektu Time.
      */
     [[nodiscard]] Time& GetEndTime() const;
 
     /**
-     * @brief Zwraca referencję do wektora wskaźników do obiektów Data, zawierającego dane pomiarowe z kwadransa.
+     * @brief Zwraca referencję do wektora slotów z danymi pomiarowymi kubełka.
+     *
+     * Slot o indeksie `i` odpowiada odczytowi z minuty `start + i * SlotMinutes` (z przesunięciem
+     * o sloty godziny powtarzanej, jeśli kubełek je zawiera). Puste sloty (brak odczytu) nie
+     * zawierają wartości.
+     *
+     * @return Referencja do wektora slotów.
+     */
+    [[nodiscard]] vector<optional<Data>>& GetData() const;
+
+    /**
+     * @brief Zwraca godzinę, której drugie wystąpienie przechowuje kubełek.
      *
-     * @return Referencja do wektora wskaźników do obiektów Data.
+     * @return Godzina (0-23) lub -1, jeśli kubełek nie zawiera slotów godziny powtarzanej.
      */
-    [[nodiscard]] vector<Data*>& GetData() const;
+    [[nodiscard]] int GetRepeatedHour() const;
+
+    /**
+     * @brief Zwraca agregat (sumy i liczbę rekordów) wszystkich danych kubełka.
+     *
+     * Agregat jest aktualizowany przy każdym wstawieniu lub zastąpieniu rekordu.
+     *
+     * @return Referencja do agregatu.
+     */
+    [[nodiscard]] Aggregate& GetAggregate() const;
 
 private:
     /**
-     * @brief Wskaźnik do obiektu Time reprezentującego godzinę rozpoczęcia kwadransa.
+     * @brief Wskaźnik do obiektu Time reprezentującego godzinę rozpoczęcia kubełka.
      */
     Time* _startTime;
     /**
-     * @brief Wskaźnik do obiektu Time reprezentującego godzinę zakończenia kwadransa.
+     * @brief Wskaźnik do obiektu Time reprezentującego początek ostatniego slotu kubełka.
      */
     Time* _endTime;
     /**
-     * @brief Wskaźnik do wektora wskaźników do obiektów Data, przechowującego dane pomiarowe z kwadransa.
+     * @brief Wskaźnik do wektora slotów, przechowującego dane pomiarowe z kubełka.
+     */
+    vector<optional<Data>>* _data;
+    /**
+     * @brief Wskaźnik do agregatu danych kubełka.
+     */
+    Aggregate* _aggregate;
+    /**
+     * @brief Godzina, dla której kubełek zawiera sloty drugiego wystąpienia, lub -1, jeśli ich nie ma.
      */
-    vector<Data*>* _data;
+    int _repeatedHour = -1;
 };
 
 #endif //QUARTER_HPP
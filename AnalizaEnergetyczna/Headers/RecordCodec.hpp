@@ -0,0 +1,52 @@
+#ifndef RECORDCODEC_HPP
+#define RECORDCODEC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "EnergyData.hpp"
+
+using namespace std;
+
+/**
+ * @brief Binarny zapis rekordów używany przez dziennik zapisów i migawki.
+ *
+ * Rekord zajmuje `RecordSize` bajtów: spakowany znacznik czasu (`DateTime::GetSortKey`)
+ * i pięć wartości typu double, w natywnej kolejności bajtów. Pliki nie są więc
+ * przenośne między platformami o różnej kolejności bajtów.
+ */
+class RecordCodec {
+public:
+    /**
+     * @brief Rozmiar zakodowanego rekordu w bajtach.
+     */
+    static constexpr size_t RecordSize = sizeof(uint64_t) + 5 * sizeof(double);
+
+    /**
+     * @brief Dopisuje zakodowany rekord na koniec bufora.
+     *
+     * @param record Rekord do zakodowania.
+     * @param buffer Bufor, do którego dopisywany jest rekord.
+     */
+    static void Encode(const EnergyData& record, string& buffer);
+
+    /**
+     * @brief Dekoduje rekord zapisany metodą `Encode`.
+     *
+     * @param bytes Wskaźnik do `RecordSize` bajtów rekordu.
+     * @return Odczytany rekord.
+     */
+    [[nodiscard]] static EnergyData Decode(const char* bytes);
+
+    /**
+     * @brief Oblicza sumę kontrolną CRC-32 (wielomian IEEE 802.3).
+     *
+     * @param bytes Wskaźnik do danych.
+     * @param size Liczba bajtów.
+     * @return Suma kontrolna.
+     */
+    [[nodiscard]] static uint32_t Crc32(const char* bytes, size_t size);
+};
+
+#endif //RECORDCODEC_HPP
@@ -0,0 +1,55 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "EnergyData.hpp"
+
+using namespace std;
+
+/**
+ * @brief Migawka wszystkich rekordów analizatora zapisana w pliku binarnym.
+ *
+ * Plik zawiera nagłówek (sygnatura, wersja, numer pokolenia dziennika, liczba rekordów,
+ * CRC-32 rekordów) i rekordy w postaci `RecordCodec`. Numer pokolenia oznacza, że migawka
+ * obejmuje wszystkie pliki dziennika zapisów o numerach nie większych od niego.
+ * Migawka jest zapisywana do pliku tymczasowego i podmieniana atomowo, więc przerwany
+ * zapis nigdy nie niszczy poprzedniej migawki.
+ */
+class Snapshot {
+public:
+    /**
+     * @brief Zapisuje migawkę.
+     *
+     * @param filepath Ścieżka do pliku migawki.
+     * @param generation Numer ostatniego pokolenia dziennika zawartego w migawce.
+     * @param records Rekordy do zapisania.
+     * @throws std::runtime_error Jeśli zapis się nie powiódł.
+     */
+    static void Write(const string& filepath, uint64_t generation, const vector<EnergyData>& records);
+
+    /**
+     * @brief Wczytuje migawkę.
+     *
+     * @param filepath Ścieżka do pliku migawki.
+     * @param consumer Funkcja wywoływana z wczytanymi rekordami.
+     * @return Numer ostatniego pokolenia dziennika zawartego w migawce.
+     * @throws std::runtime_error Jeśli plik jest uszkodzony lub ma nieznany format.
+     */
+    static uint64_t Read(const string& filepath, const function<void(vector<EnergyData>&&)>& consumer);
+
+private:
+    /**
+     * @brief Sygnatura pliku migawki.
+     */
+    static constexpr uint32_t Magic = 0x4E534145; // "EASN"
+    /**
+     * @brief Wersja formatu pliku migawki.
+     */
+    static constexpr uint32_t Version = 1;
+};
+
+#endif //SNAPSHOT_HPP
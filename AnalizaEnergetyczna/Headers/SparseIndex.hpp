@@ -0,0 +1,192 @@
+#ifndef SPARSEINDEX_HPP
+#define SPARSEINDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "DateTime.hpp"
+
+using namespace std;
+
+/**
+ * @brief Rzadki indeks pliku CSV: znacznik czasu co `stride`-tego rekordu i pozycja (w bajtach) jego linii.
+ *
+ * Indeks jest budowany jednym przebiegiem po pliku i zapisywany obok niego w pliku `<csv>.idx`.
+ * Na jego podstawie można wczytać tylko fragment pliku obejmujący zadany przedział czasu
+ * (patrz `EnergyAnalyzer::ExecuteIndexedCommand`) - wyszukiwanie binarne w indeksie zastępuje
+ * czytanie całego, wielogigabajtowego archiwum.
+ *
+ * Zawężanie zakresu wymaga, aby rekordy w pliku były uporządkowane chronologicznie. Dla pliku
+ * nieuporządkowanego indeks jest nadal poprawny, ale zawsze wskazuje cały plik.
+ */
+class SparseIndex {
+public:
+    /**
+     * @brief Domyślna liczba rekordów pliku przypadająca na jeden wpis indeksu.
+     */
+    static constexpr size_t DefaultStride = 1024;
+
+    /**
+     * @brief Fragment pliku CSV do wczytania.
+     */
+    struct Slice {
+        /**
+         * @brief Pozycja początku pierwszej linii fragmentu.
+         */
+        streamoff Begin;
+        /**
+         * @brief Pozycja, od której linie nie należą już do fragmentu (-1 oznacza koniec pliku).
+         */
+        streamoff End;
+        /**
+         * @brief Znacznik czasu potrzebny do poprawnego sparsowania pierwszej linii (patrz `EnergyData::ReadEnergyDataSlice`).
+         */
+        optional<DateTime> Previous;
+    };
+
+    /**
+     * @brief Buduje indeks pliku CSV.
+     *
+     * @param filepath Ścieżka do pliku CSV.
+     * @param stride Liczba rekordów pliku przypadająca na jeden wpis indeksu.
+     * @return Zbudowany indeks.
+     * @throws std::invalid_argument Jeśli `stride` jest równe 0 lub plik jest skompresowany.
+     * @throws std::runtime_error Jeśli nie można otworzyć pliku.
+     */
+    [[nodiscard]] static SparseIndex Build(const string& filepath, size_t stride = DefaultStride);
+
+    /**
+     * @brief Wczytuje indeks z pliku obok pliku CSV, a jeśli go nie ma lub jest nieaktualny - buduje go i zapisuje.
+     *
+     * @param filepath Ścieżka do pliku CSV.
+     * @param stride Liczba rekordów pliku przypadająca na jeden wpis budowanego indeksu.
+     * @return Indeks pliku.
+     * @throws std::runtime_error Jeśli nie można otworzyć pliku CSV lub zapisać indeksu.
+     */
+    [[nodiscard]] static SparseIndex Open(const string& filepath, size_t stride = DefaultStride);
+
+    /**
+     * @brief Zwraca ścieżkę pliku indeksu dla pliku CSV.
+     *
+     * @param filepath Ścieżka do pliku CSV.
+     * @return Ścieżka pliku indeksu.
+     */
+    [[nodiscard]] static string GetIndexPath(const string& filepath);
+
+    /**
+     * @brief Zapisuje indeks do pliku.
+     *
+     * @param filepath Ścieżka do pliku indeksu.
+     * @throws std::runtime_error Jeśli zapis się nie powiódł.
+     */
+    void Save(const string& filepath) const;
+
+    /**
+     * @brief Wczytuje indeks zapisany metodą `Save`.
+     *
+     * @param filepath Ścieżka do pliku indeksu.
+     * @return Wczytany indeks.
+     * @throws std::runtime_error Jeśli plik jest uszkodzony lub ma nieznany format.
+     */
+    [[nodiscard]] static SparseIndex Load(const string& filepath);
+
+    /**
+     * @brief Sprawdza, czy indeks opisuje aktualną zawartość pliku CSV.
+     *
+     * Plik, do którego tylko dopisano linie, nadal pasuje do indeksu - nowe linie leżą za ostatnim wpisem.
+     * Plik o zmienionym czasie modyfikacji pasuje do indeksu tylko wtedy, gdy urósł, a końcówka
+     * indeksowanej części (`TailBytes` bajtów) nie zmieniła się - plik zapisany od nowa wymaga nowego indeksu.
+     *
+     * @param filepath Ścieżka do pliku CSV.
+     * @return true, jeśli plik jest taki jak w chwili budowy indeksu lub tylko do niego dopisano, false w przeciwnym razie.
+     */
+    [[nodiscard]] bool IsCurrent(const string& filepath) const;
+
+    /**
+     * @brief Wyznacza fragment pliku zawierający wszystkie rekordy z przedziału czasowego.
+     *
+     * Fragment obejmuje całe dni, w których leżą początek i koniec przedziału, oraz linie
+     * do najbliższych wpisów indeksu - jest więc nieco większy niż sam przedział.
+     *
+     * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+     * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+     * @return Fragment pliku do wczytania.
+     */
+    [[nodiscard]] Slice Locate(const DateTime* start, const DateTime* end) const;
+
+    /**
+     * @brief Zwraca liczbę wpisów indeksu.
+     *
+     * @return Liczba wpisów.
+     */
+    [[nodiscard]] size_t GetEntryCount() const;
+
+private:
+    /**
+     * @brief Wpis indeksu.
+     */
+    struct Entry {
+        /**
+         * @brief Znacznik czasu rekordu (`DateTime::GetSortKey`).
+         */
+        uint64_t Key;
+        /**
+         * @brief Pozycja początku linii rekordu w pliku.
+         */
+        int64_t Offset;
+    };
+
+    /**
+     * @brief Sygnatura pliku indeksu.
+     */
+    static constexpr uint32_t Magic = 0x58494145; // "EAIX"
+    /**
+     * @brief Wersja formatu pliku indeksu.
+     */
+    static constexpr uint32_t Version = 2;
+    /**
+     * @brief Liczba bajtów przed końcem indeksowanej części pliku objętych sumą kontrolną `_tailCrc`.
+     */
+    static constexpr uint64_t TailBytes = 4096;
+
+    /**
+     * @brief Oblicza sumę kontrolną końcówki indeksowanej części pliku.
+     *
+     * @param filepath Ścieżka do pliku CSV.
+     * @param dataBegin Pozycja pierwszej linii za nagłówkiem pliku.
+     * @param fileSize Koniec indeksowanej części pliku.
+     * @return CRC-32 bajtów od `max(dataBegin, fileSize - TailBytes)` do `fileSize` lub `nullopt`, jeśli nie można ich odczytać.
+     */
+    [[nodiscard]] static optional<uint32_t> GetTailCrc(const string& filepath, int64_t dataBegin, uint64_t fileSize);
+
+    /**
+     * @brief Wpisy indeksu uporządkowane według pozycji w pliku.
+     */
+    vector<Entry> _entries;
+    /**
+     * @brief Pozycja pierwszej linii za nagłówkiem pliku.
+     */
+    int64_t _dataBegin = 0;
+    /**
+     * @brief Rozmiar pliku CSV w chwili budowy indeksu.
+     */
+    uint64_t _fileSize = 0;
+    /**
+     * @brief Czas ostatniej modyfikacji pliku CSV w chwili budowy indeksu (liczba taktów `filesystem::file_time_type`).
+     */
+    int64_t _writeTime = 0;
+    /**
+     * @brief CRC-32 ostatnich `TailBytes` bajtów indeksowanej części pliku.
+     */
+    uint32_t _tailCrc = 0;
+    /**
+     * @brief Czy rekordy pliku są uporządkowane chronologicznie.
+     */
+    bool _ordered = true;
+};
+
+#endif //SPARSEINDEX_HPP
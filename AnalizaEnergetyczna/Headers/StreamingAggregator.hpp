@@ -0,0 +1,160 @@
+#ifndef STREAMINGAGGREGATOR_HPP
+#define STREAMINGAGGREGATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Data.hpp"
+#include "DateTime.hpp"
+#include "DuplicateResolver.hpp"
+#include "EnergyData.hpp"
+
+using namespace std;
+
+/**
+ * @brief Klasa obliczająca wyniki komend agregujących w jednym przebiegu po pliku CSV.
+ *
+ * Komendy `SUMA`, `SREDNIA` i `POROWNAJ` (w składni `CommandParser`) są parsowane przed
+ * wczytaniem pliku. Podczas wczytywania każdy rekord jest dodawany do liczników przedziałów,
+ * do których należy, i od razu porzucany - struktura lat, miesięcy i dni nie jest tworzona,
+ * więc zużycie pamięci zależy tylko od liczby komend, a nie od rozmiaru pliku. Wczytywane są
+ * tylko kolumny potrzebne komendom.
+ *
+ * Wyniki są wypisywane w tym samym formacie co przy wykonaniu komend przez `EnergyAnalyzer`.
+ * Duplikaty są rozstrzygane zgodnie z polityką, jeśli sąsiadują ze sobą w pliku (tak jest
+ * w pliku uporządkowanym chronologicznie); powtórzenia rozrzucone po pliku są liczone wielokrotnie.
+ */
+class StreamingAggregator {
+public:
+    /**
+     * @brief Konstruktor klasy StreamingAggregator.
+     *
+     * @param duplicatePolicy Sposób rozstrzygania sąsiadujących odczytów o tym samym znaczniku czasu.
+     */
+    explicit StreamingAggregator(DuplicatePolicy duplicatePolicy = DuplicatePolicy::KeepFirst);
+
+    /**
+     * @brief Parsuje komendę i dodaje ją do listy obliczanych komend.
+     *
+     * Błędy składni są zgłaszane na standardowe wyjście błędów, tak jak przy wykonaniu komendy.
+     *
+     * @param command Komenda `SUMA`, `SREDNIA` lub `POROWNAJ`.
+     * @return true, jeśli komenda została dodana, false w przeciwnym razie.
+     */
+    bool AddCommand(const string& command);
+
+    /**
+     * @brief Wczytuje plik CSV i dodaje jego rekordy do liczników komend.
+     *
+     * Można wywołać wielokrotnie (np. dla kolejnych plików) - liczniki się sumują.
+     *
+     * @param filepath Ścieżka do pliku CSV.
+     * @return Liczba rekordów dodanych do liczników (po rozstrzygnięciu duplikatów).
+     * @throws std::runtime_error Jeśli nie można otworzyć pliku.
+     */
+    size_t Run(const string& filepath);
+
+    /**
+     * @brief Wypisuje wyniki wszystkich komend w kolejności ich dodania.
+     */
+    void PrintResults() const;
+
+private:
+    /**
+     * @brief Przedział czasowy komendy wraz z licznikami.
+     */
+    struct Range {
+        /**
+         * @brief Początek przedziału.
+         */
+        DateTime Start;
+        /**
+         * @brief Koniec przedziału.
+         */
+        DateTime End;
+        /**
+         * @brief Klucz minuty początku przedziału (patrz `GetMinuteKey`).
+         */
+        int64_t FirstMinute;
+        /**
+         * @brief Klucz minuty końca przedziału.
+         */
+        int64_t LastMinute;
+        /**
+         * @brief Suma wartości rekordów z przedziału.
+         */
+        long double Sum = 0;
+        /**
+         * @brief Liczba rekordów z przedziału.
+         */
+        size_t Count = 0;
+    };
+
+    /**
+     * @brief Sparsowana komenda.
+     */
+    struct Query {
+        /**
+         * @brief Nazwa komendy (`SUMA`, `SREDNIA` lub `POROWNAJ`).
+         */
+        string Name;
+        /**
+         * @brief Typ danych podany w komendzie (np. `IMPORT`).
+         */
+        string Type;
+        /**
+         * @brief Wielkość odpowiadająca typowi danych (patrz `CommandParser::ParseMetric`).
+         */
+        Metric Quantity;
+        /**
+         * @brief Przedziały komendy (dwa dla `POROWNAJ`, jeden dla pozostałych).
+         */
+        vector<Range> Ranges;
+    };
+
+    /**
+     * @brief Sposób rozstrzygania sąsiadujących odczytów o tym samym znaczniku czasu.
+     */
+    DuplicatePolicy _duplicatePolicy;
+
+    /**
+     * @brief Komendy w kolejności dodania.
+     */
+    vector<Query> _queries;
+
+    /**
+     * @brief Kolumny wartości potrzebne komendom.
+     */
+    ColumnSet _columns = 0;
+
+    /**
+     * @brief Dodaje rekord do liczników wszystkich przedziałów, do których należy.
+     *
+     * @param record Rekord.
+     */
+    void Accumulate(const EnergyData& record);
+
+    /**
+     * @brief Zwraca klucz porządkujący datę i minutę doby (godzina powtarzana ma te same klucze co jej pierwsze wystąpienie).
+     *
+     * Porównanie takich kluczy odpowiada temu, jak `EnergyAnalyzer` wybiera rekordy z przedziału.
+     *
+     * @param dateTime Data i godzina.
+     * @return Klucz minuty.
+     */
+    [[nodiscard]] static int64_t GetMinuteKey(const DateTime& dateTime);
+
+    /**
+     * @brief Parsuje przedział `OD <data> DO <data>` zaczynający się od podanego tokenu.
+     *
+     * @param tokens Tokeny komendy.
+     * @param index Indeks tokenu `OD` (przesuwany za przedział).
+     * @param ranges Wektor, do którego dodawany jest przedział.
+     * @return true, jeśli przedział jest poprawny, false w przeciwnym razie.
+     */
+    static bool ParseRange(const vector<string>& tokens, size_t& index, vector<Range>& ranges);
+};
+
+#endif //STREAMINGAGGREGATOR_HPP
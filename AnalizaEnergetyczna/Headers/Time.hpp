@@ -3,6 +3,9 @@
 
 /**
  * @brief Klasa reprezentująca godzinę i minutę.
+ *
+ * Godzina powtarzana przy zmianie czasu z letniego na zimowy jest oznaczana osobnym znacznikiem,
+ * tak aby jej drugie wystąpienie było późniejsze od pierwszego i wcześniejsze od następnej godziny.
  */
 class Time {
 public:
@@ -13,9 +16,10 @@ public:
      *
      * @param hour Godzina (0-23).
      * @param minute Minuta (0-59).
+     * @param repeated `true` dla drugiego wystąpienia godziny powtarzanej przy zmianie czasu.
      * @throws std::out_of_range jeśli `hour` lub `minute` są poza zakresem.
      */
-    Time(int hour, int minute);
+    Time(int hour, int minute, bool repeated = false);
 
     /**
      * @brief Zwraca godzinę.
@@ -31,6 +35,20 @@ public:
      */
     [[nodiscard]] int GetMinute() const;
 
+    /**
+     * @brief Zwraca liczbę minut, które upłynęły od północy.
+     *
+     * @return Minuta dnia (0-1439).
+     */
+    [[nodiscard]] int GetMinuteOfDay() const;
+
+    /**
+     * @brief Sprawdza, czy jest to drugie wystąpienie godziny powtarzanej przy zmianie czasu.
+     *
+     * @return `true` dla drugiego wystąpienia, `false` w przeciwnym razie.
+     */
+    [[nodiscard]] bool IsRepeated() const;
+
     /**
      * @brief Operator mniejszości.
      *
@@ -60,6 +78,10 @@ private:
      * @brief Minuta (0-59).
      */
     int _minute;
+    /**
+     * @brief Znacznik drugiego wystąpienia godziny powtarzanej przy zmianie czasu.
+     */
+    bool _repeated;
 };
 
 #endif //TIME_HPP
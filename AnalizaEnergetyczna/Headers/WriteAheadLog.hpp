@@ -0,0 +1,145 @@
+#ifndef WRITEAHEADLOG_HPP
+#define WRITEAHEADLOG_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "EnergyData.hpp"
+
+using namespace std;
+
+/**
+ * @brief Dziennik zapisów (write-ahead log) partii rekordów dopisywanych w trakcie działania programu.
+ *
+ * Plik składa się z wpisów `[rozmiar: uint32][CRC-32: uint32][operacja: uint8][rekordy]`, dopisywanych
+ * wyłącznie na koniec. Zapis odbywa się grupowo: wpisy zgłoszone przez różne wątki trafiają do wspólnego
+ * bufora, a jeden z oczekujących wątków zapisuje cały bufor i wywołuje jedno `fsync` za wszystkie.
+ * Przy odtwarzaniu uszkodzony lub niedokończony ostatni wpis (przerwany zapis) jest odcinany.
+ */
+class WriteAheadLog {
+public:
+    /**
+     * @brief Rodzaj operacji zapisanej w dzienniku.
+     */
+    enum class Operation : uint8_t {
+        /** Dopisanie rekordów zgodnie z polityką duplikatów analizatora (`EnergyAnalyzer::Append`). */
+        Append = 1,
+        /** Wstawienie rekordów z zastąpieniem istniejących odczytów (`EnergyAnalyzer::Upsert`). */
+        Upsert = 2
+    };
+
+    /**
+     * @brief Konstruktor klasy WriteAheadLog.
+     *
+     * Otwiera (lub tworzy) plik dziennika do dopisywania.
+     *
+     * @param filepath Ścieżka do pliku dziennika.
+     * @throws std::runtime_error Jeśli nie można otworzyć pliku.
+     */
+    explicit WriteAheadLog(const string& filepath);
+
+    /**
+     * @brief Destruktor klasy WriteAheadLog.
+     *
+     * Zapisuje oczekujące wpisy i zamyka plik.
+     */
+    ~WriteAheadLog();
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    /**
+     * @brief Dodaje wpis do bufora grupowego zapisu.
+     *
+     * Wpis nie jest jeszcze trwały - należy poczekać na niego metodą `WaitDurable`.
+     *
+     * @param operation Rodzaj operacji.
+     * @param records Rekordy partii.
+     * @return Numer kolejny wpisu.
+     */
+    uint64_t Enqueue(Operation operation, const vector<EnergyData>& records);
+
+    /**
+     * @brief Czeka, aż wpis o podanym numerze (i wszystkie wcześniejsze) zostanie zapisany na dysku.
+     *
+     * @param sequence Numer wpisu zwrócony przez `Enqueue`.
+     * @throws std::runtime_error Jeśli zapis do pliku się nie powiódł.
+     */
+    void WaitDurable(uint64_t sequence);
+
+    /**
+     * @brief Zapisuje na dysku wszystkie dotąd zgłoszone wpisy.
+     */
+    void Flush();
+
+    /**
+     * @brief Zwraca rozmiar dziennika w bajtach (łącznie z wpisami oczekującymi na zapis).
+     *
+     * @return Rozmiar dziennika.
+     */
+    [[nodiscard]] uintmax_t GetSize() const;
+
+    /**
+     * @brief Odtwarza wpisy z pliku dziennika.
+     *
+     * Odczyt kończy się na pierwszym niekompletnym lub uszkodzonym wpisie; plik jest przycinany
+     * do ostatniego poprawnego wpisu.
+     *
+     * @param filepath Ścieżka do pliku dziennika.
+     * @param consumer Funkcja wywoływana dla każdego poprawnego wpisu.
+     * @return Liczba odtworzonych wpisów.
+     */
+    static size_t Replay(const string& filepath, const function<void(Operation, vector<EnergyData>&&)>& consumer);
+
+private:
+    /**
+     * @brief Uchwyt pliku dziennika.
+     */
+    FILE* _file;
+    /**
+     * @brief Chroni bufor i liczniki wpisów.
+     */
+    mutable mutex _mutex;
+    /**
+     * @brief Powiadamia wątki czekające na zapis swoich wpisów.
+     */
+    condition_variable _durableChanged;
+    /**
+     * @brief Zakodowane wpisy oczekujące na zapis.
+     */
+    string _pending;
+    /**
+     * @brief Numer ostatniego zgłoszonego wpisu.
+     */
+    uint64_t _lastQueued = 0;
+    /**
+     * @brief Numer ostatniego wpisu zapisanego na dysku.
+     */
+    uint64_t _lastDurable = 0;
+    /**
+     * @brief Czy któryś z wątków zapisuje właśnie bufor na dysk.
+     */
+    bool _writing = false;
+    /**
+     * @brief Czy ostatni zapis na dysk się nie powiódł.
+     */
+    bool _failed = false;
+    /**
+     * @brief Rozmiar dziennika w bajtach.
+     */
+    uintmax_t _size = 0;
+
+    /**
+     * @brief Wymusza zapis buforów pliku na dysku.
+     *
+     * @return `true`, jeśli się udało, `false` w przeciwnym razie.
+     */
+    bool Sync() const;
+};
+
+#endif //WRITEAHEADLOG_HPP
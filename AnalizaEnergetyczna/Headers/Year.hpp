@@ -27,7 +27,7 @@ public:
     /**
      * @brief Destruktor klasy Year.
      *
-     * Zwalnia pamięć zaalokowaną dla obiektów Month.
+     * Zwalnia pamięć zaalokowaną dla obiektów Month oraz agregatu.
      */
     ~Year();
 
@@ -45,6 +45,24 @@ public:
      */
     [[nodiscard]] vector<Month*>& GetMonths() const;
 
+    /**
+     * @brief Zwraca agregat (sumy i liczbę rekordów) wszystkich danych roku.
+     *
+     * Agregat jest aktualizowany przy każdym wstawieniu lub zastąpieniu rekordu.
+     *
+     * @return Referencja do agregatu.
+     */
+    [[nodiscard]] Aggregate& GetAggregate() const;
+
+    /**
+     * @brief Zwraca szkic rozkładu wartości wszystkich danych roku.
+     *
+     * Szkic jest aktualizowany przy każdym wstawieniu lub zastąpieniu rekordu.
+     *
+     * @return Referencja do szkicu.
+     */
+    [[nodiscard]] QuantileSketch& GetSketch() const;
+
 private:
     /**
      * @brief Numer roku.
@@ -54,6 +72,14 @@ private:
      * @brief Wskaźnik do wektora wskaźników do obiektów Month reprezentujących miesiące roku.
      */
     vector<Month*>* _months;
+    /**
+     * @brief Wskaźnik do agregatu danych roku.
+     */
+    Aggregate* _aggregate;
+    /**
+     * @brief Wskaźnik do szkicu rozkładu wartości danych roku.
+     */
+    QuantileSketch* _sketch;
 };
 
 #endif //YEAR_HPP
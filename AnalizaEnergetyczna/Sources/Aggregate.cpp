@@ -0,0 +1,140 @@
+#include "../Headers/Aggregate.hpp"
+
+#include <algorithm>
+
+/**
+ * @brief Dodaje rekord do agregatu.
+ *
+ * @param data Rekord do dodania.
+ */
+void Aggregate::Add(const Data& data) {
+    for (int i = 0; i < MetricCount; ++i) {
+        const double value = data.GetValue(static_cast<Metric>(i));
+
+        _sums[i] += value;
+        _min[i] = min(_min[i], value);
+        _max[i] = max(_max[i], value);
+    }
+
+    ++_count;
+}
+
+/**
+ * @brief Zastępuje w agregacie rekord dodany wcześniej nowym rekordem.
+ *
+ * Wartości NaN (niewczytane kolumny) nie są równe żadnej wartości skrajnej, więc nigdy
+ * nie wymagają ich przeliczenia.
+ *
+ * @param previous Zastępowany rekord.
+ * @param current Nowy rekord.
+ * @return true, jeśli wartości skrajne mogą być nieaktualne.
+ */
+bool Aggregate::Replace(const Data& previous, const Data& current) {
+    bool stale = false;
+
+    for (int i = 0; i < MetricCount; ++i) {
+        const double oldValue = previous.GetValue(static_cast<Metric>(i));
+        const double newValue = current.GetValue(static_cast<Metric>(i));
+
+        stale |= (oldValue == _min[i] && newValue > oldValue) || (oldValue == _max[i] && newValue < oldValue);
+
+        _sums[i] += static_cast<long double>(newValue) - oldValue;
+        _min[i] = min(_min[i], newValue);
+        _max[i] = max(_max[i], newValue);
+    }
+
+    return stale;
+}
+
+/**
+ * @brief Przepisuje wartości skrajne z innego agregatu.
+ *
+ * @param source Agregat, z którego pochodzą wartości skrajne.
+ */
+void Aggregate::SetExtremes(const Aggregate& source) {
+    _min = source._min;
+    _max = source._max;
+}
+
+/**
+ * @brief Sprawdza, czy agregaty mają te same wartości skrajne.
+ *
+ * @param other Agregat do porównania.
+ * @return true, jeśli wartości minimalne i maksymalne są równe.
+ */
+bool Aggregate::HasSameExtremes(const Aggregate& other) const {
+    return _min == other._min && _max == other._max;
+}
+
+/**
+ * @brief Zeruje agregat.
+ */
+void Aggregate::Clear() {
+    *this = Aggregate();
+}
+
+/**
+ * @brief Dodaje do agregatu wartości innego agregatu.
+ *
+ * @param other Agregat do dołączenia.
+ */
+void Aggregate::Merge(const Aggregate& other) {
+    for (int i = 0; i < MetricCount; ++i) {
+        _sums[i] += other._sums[i];
+        _min[i] = min(_min[i], other._min[i]);
+        _max[i] = max(_max[i], other._max[i]);
+    }
+
+    _count += other._count;
+}
+
+/**
+ * @brief Zwraca sumę wartości wielkości.
+ *
+ * @param metric Wielkość.
+ * @return Suma wartości.
+ */
+long double Aggregate::GetSum(const Metric metric) const {
+    return _sums[static_cast<int>(metric)];
+}
+
+/**
+ * @brief Zwraca liczbę rekordów.
+ *
+ * @return Liczba rekordów.
+ */
+size_t Aggregate::GetCount() const {
+    return _count;
+}
+
+/**
+ * @brief Zwraca najmniejszą wartość wielkości.
+ *
+ * @param metric Wielkość.
+ * @return Wartość minimalna.
+ */
+double Aggregate::GetMin(const Metric metric) const {
+    return _min[static_cast<int>(metric)];
+}
+
+/**
+ * @brief Zwraca największą wartość wielkości.
+ *
+ * @param metric Wielkość.
+ * @return Wartość maksymalna.
+ */
+double Aggregate::GetMax(const Metric metric) const {
+    return _max[static_cast<int>(metric)];
+}
+
+/**
+ * @brief Sprawdza, czy agregat może zawierać wartość wielkości z przedziału [low, high].
+ *
+ * @param metric Wielkość.
+ * @param low Dolna granica przedziału.
+ * @param high Górna granica przedziału.
+ * @return false, jeśli żaden rekord agregatu nie ma wartości w przedziale.
+ */
+bool Aggregate::MayContain(const Metric metric, const long double low, const long double high) const {
+    return _count > 0 && _max[static_cast<int>(metric)] >= low && _min[static_cast<int>(metric)] <= high;
+}
@@ -0,0 +1,95 @@
+#include "../Headers/AggregateCube.hpp"
+
+/**
+ * @brief Dodaje odczyt do komórki kostki.
+ *
+ * @param dateTime Data i godzina odczytu.
+ * @param data Odczyt.
+ */
+void AggregateCube::Add(const DateTime &dateTime, const Data &data) {
+    GetCell(dateTime).Add(data);
+}
+
+/**
+ * @brief Zwraca komórkę kostki.
+ *
+ * @param dateTime Data i godzina wyznaczająca komórkę.
+ * @return Referencja do agregatu komórki.
+ */
+Aggregate &AggregateCube::GetCell(const DateTime &dateTime) {
+    vector<Aggregate> &cells = _years[dateTime.GetYear()];
+
+    if (cells.empty()) cells.resize(CellsPerYear);
+
+    const int slot = (dateTime.GetHour() * 60 + dateTime.GetMinute()) / Quarter::SlotMinutes;
+
+    return cells[GetCellIndex(dateTime.GetMonth(), dateTime.GetDayOfWeek(), slot)];
+}
+
+/**
+ * @brief Łączy komórki wycinka kostki według wymiaru.
+ *
+ * Pętle przechodzą tylko po miesiącach i dniach tygodnia należących do wycinka, a komórki
+ * slotów jednego miesiąca i dnia tygodnia leżą w tablicy obok siebie.
+ *
+ * @param by Wymiar, według którego łączone są komórki.
+ * @param filter Wycinek kostki.
+ * @return Niepuste agregaty uporządkowane według klucza wymiaru.
+ */
+map<int, Aggregate> AggregateCube::RollUp(const Dimension by, const Filter &filter) const {
+    map<int, Aggregate> result;
+
+    for (const auto &[year, cells]: _years) {
+        if (filter.Year != 0 && year != filter.Year) continue;
+
+        for (int month = 1; month <= 12; ++month) {
+            if (filter.Month != 0 && month != filter.Month) continue;
+
+            for (int weekday = 0; weekday < 7; ++weekday) {
+                if (!(filter.Weekdays >> weekday & 1)) continue;
+
+                for (int slot = 0; slot < Day::SlotsPerDay; ++slot) {
+                    const Aggregate &cell = cells[GetCellIndex(month, weekday, slot)];
+
+                    if (cell.GetCount() == 0) continue;
+
+                    int key = 0;
+
+                    switch (by) {
+                        case Dimension::Year:
+                            key = year;
+                            break;
+                        case Dimension::Month:
+                            key = month;
+                            break;
+                        case Dimension::DayOfWeek:
+                            key = weekday;
+                            break;
+                        case Dimension::Hour:
+                            key = slot * Quarter::SlotMinutes / 60;
+                            break;
+                        case Dimension::Slot:
+                            key = slot;
+                            break;
+                    }
+
+                    result[key].Merge(cell);
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Wyznacza indeks komórki w tablicy roku.
+ *
+ * @param month Miesiąc (1-12).
+ * @param weekday Dzień tygodnia (0-6).
+ * @param slot Slot doby (0-95).
+ * @return Indeks komórki.
+ */
+int AggregateCube::GetCellIndex(const int month, const int weekday, const int slot) {
+    return ((month - 1) * 7 + weekday) * Day::SlotsPerDay + slot;
+}
@@ -1,8 +1,10 @@
 #include "../Headers/CommandParser.hpp"
 
+#include <fstream>
 #include <sstream>
 #include <iostream>
 #include <iomanip>
+#include <optional>
 
 CommandParser::CommandParser(EnergyAnalyzer &analyzer) : _analyzer(analyzer) {}
 
@@ -24,6 +26,26 @@ void CommandParser::ParseAndExecute(const string &command) {
         ExecuteSearch(tokens);
     } else if (commandType == "WYPISZ") {
         ExecutePrint(tokens);
+    } else if (commandType == "MAKS") {
+        ExecuteExtremum(tokens, true);
+    } else if (commandType == "MIN") {
+        ExecuteExtremum(tokens, false);
+    } else if (commandType == "NAJWIEKSZE") {
+        ExecuteTop(tokens);
+    } else if (commandType == "PERCENTYL") {
+        ExecutePercentile(tokens);
+    } else if (commandType == "HISTOGRAM") {
+        ExecuteHistogram(tokens);
+    } else if (commandType == "KRZYWA_TRWANIA") {
+        ExecuteDurationCurve(tokens);
+    } else if (commandType == "OKNO") {
+        ExecuteWindow(tokens);
+    } else if (commandType == "GRUPUJ") {
+        ExecuteGroup(tokens);
+    } else if (commandType == "KOSTKA") {
+        ExecuteCube(tokens);
+    } else if (commandType == "BRAKI") {
+        ExecuteMissing(tokens);
     } else if (commandType == "KONIEC") {
         exit(0);
     }
@@ -32,6 +54,37 @@ void CommandParser::ParseAndExecute(const string &command) {
     }
 }
 
+bool CommandParser::GetCommandRange(const string &command, DateTime &start, DateTime &end) {
+    const vector<string> tokens = Tokenize(command);
+    optional<DateTime> first, last;
+
+    for (size_t index = 0; index + 2 < tokens.size(); ++index) {
+        if (tokens[index] != "OD" && tokens[index] != "DO") continue;
+
+        const vector<string> dateTokens = Tokenize(tokens[index + 1], '.');
+        const vector<string> timeTokens = Tokenize(tokens[index + 2], ':');
+
+        if (dateTokens.size() != 3 || timeTokens.size() != 2) continue;
+
+        try {
+            const DateTime dateTime(stoi(dateTokens[0]), stoi(dateTokens[1]), stoi(dateTokens[2]),
+                                    stoi(timeTokens[0]), stoi(timeTokens[1]));
+
+            if (!first.has_value() || dateTime.GetSortKey() < first->GetSortKey()) first = dateTime;
+            if (!last.has_value() || dateTime.GetSortKey() > last->GetSortKey()) last = dateTime;
+        } catch (const exception &) {
+            // Błędną datę zgłosi wykonanie komendy.
+        }
+    }
+
+    if (!first.has_value()) return false;
+
+    start = *first;
+    end = *last;
+
+    return true;
+}
+
 vector<string> CommandParser::Tokenize(const string &command, const char delimiter) {
     vector<string> tokens;
     stringstream ss(command);
@@ -105,15 +158,15 @@ void CommandParser::ExecuteSum(const vector<string> &tokens) const {
     cout << "Wywołano komendę SUMA dla " << type << " w przedziale od " << start->ToString() << " do " << end->ToString() << endl;
 
     if (type == "AUTOKONSUMPCJA") {
-        cout << fixed << setprecision(4) << "Suma autokonsumpcji: " << _analyzer.CalculateAutoConsumptionSumInRange(start, end) << " W" << endl;
+        PrintSum(Metric::AutoConsumption, _analyzer.CalculateAutoConsumptionSumInRange(start, end));
     } else if (type == "EKSPORT") {
-        cout << fixed << setprecision(4) << "Suma eksportu: " << _analyzer.CalculateEksportSumInRange(start, end) << " W" << endl;
+        PrintSum(Metric::Export, _analyzer.CalculateEksportSumInRange(start, end));
     } else if (type == "IMPORT") {
-        cout << fixed << setprecision(4) << "Suma importu: " << _analyzer.CalculateImportSumInRange(start, end) << " W" << endl;
+        PrintSum(Metric::Import, _analyzer.CalculateImportSumInRange(start, end));
     } else if (type == "POBOR") {
-        cout << fixed << setprecision(4) << "Suma poboru: " << _analyzer.CalculateConsumptionSumInRange(start, end) << " W" << endl;
+        PrintSum(Metric::Consumption, _analyzer.CalculateConsumptionSumInRange(start, end));
     } else if (type == "PRODUKCJA") {
-        cout << fixed << setprecision(4) << "Suma produkcji: " << _analyzer.CalculateGenerationSumInRange(start, end) << " W" << endl;
+        PrintSum(Metric::Generation, _analyzer.CalculateGenerationSumInRange(start, end));
     } else {
         cerr << "Błąd: Nieznany typ dla komendy SUMA: " << type << endl;
     }
@@ -154,17 +207,27 @@ void CommandParser::ExecuteAverage(const vector<string> &tokens) const {
     cout << "Wywołano komendę SREDNIA dla " << type << " w przedziale od " << start->ToString() << " do " << end->ToString() << endl;
 
     if (type == "AUTOKONSUMPCJA") {
-        cout << fixed << setprecision(4) << "Średnia autokonsumpcja: " << _analyzer.CalculateAutoConsumptionAvgInRange(start, end) << " W" << endl;
+        PrintAverage(Metric::AutoConsumption, _analyzer.CalculateAutoConsumptionAvgInRange(start, end));
     } else if (type == "EKSPORT") {
-        cout << fixed << setprecision(4) << "Średnia eksportu: " << _analyzer.CalculateEksportAvgInRange(start, end) << " W" << endl;
+        PrintAverage(Metric::Export, _analyzer.CalculateEksportAvgInRange(start, end));
     } else if (type == "IMPORT") {
-        cout << fixed << setprecision(4) << "Średnia importu: " << _analyzer.CalculateImportAvgInRange(start, end) << " W" << endl;
+        PrintAverage(Metric::Import, _analyzer.CalculateImportAvgInRange(start, end));
     } else if (type == "POBOR") {
-        cout << fixed << setprecision(4) << "Średnia poboru: " << _analyzer.CalculateConsumptionAvgInRange(start, end) << " W" << endl;
+        PrintAverage(Metric::Consumption, _analyzer.CalculateConsumptionAvgInRange(start, end));
     } else if (type == "PRODUKCJA") {
-        cout << fixed << setprecision(4) << "Średnia produkcji: " << _analyzer.CalculateGenerationAvgInRange(start, end) << " W" << endl;
+        PrintAverage(Metric::Generation, _analyzer.CalculateGenerationAvgInRange(start, end));
     } else {
         cerr << "Błąd: Nieznany typ dla komendy SREDNIA: " << type << endl;
+        delete start;
+        delete end;
+        return;
+    }
+
+    if (index < tokens.size() && tokens[index] == "POKRYCIE") {
+        const EnergyAnalyzer::Coverage coverage = _analyzer.CalculateCoverage(start, end);
+
+        cout << "Pokrycie: " << coverage.Present << " z " << coverage.Expected << " kwadransów (" << fixed
+             << setprecision(2) << (coverage.Expected ? 100.0 * coverage.Present / coverage.Expected : 0.0) << "%)" << endl;
     }
 
     delete start;
@@ -366,3 +429,705 @@ void CommandParser::ExecutePrint(const vector<string> &tokens) const {
     delete start;
     delete end;
 }
+
+void CommandParser::ExecuteMissing(const vector<string> &tokens) const {
+    if (tokens.size() < 5) {
+        cerr << "Błąd: Nieprawidłowa liczba argumentów dla komendy BRAKI." << endl;
+        return;
+    }
+
+    size_t index = 1;
+
+    if (tokens[index++] != "OD") {
+        cerr << "Błąd: Brak słowa kluczowego OD" << endl;
+        return;
+    }
+
+    const DateTime *start = ParseDateTime(tokens, index);
+
+    if (tokens[index++] != "DO") {
+        cerr << "Błąd: Brak słowa kluczowego DO" << endl;
+        delete start;
+        return;
+    }
+
+    const DateTime *end = ParseDateTime(tokens, index);
+
+    if (start == nullptr || end == nullptr) {
+        delete start;
+        delete end;
+        return;
+    }
+
+    cout << "Wywołano komendę BRAKI w przedziale od " << start->ToString() << " do " << end->ToString() << endl;
+
+    size_t missing = 0;
+
+    for (const EnergyAnalyzer::MissingInterval &interval: _analyzer.FindMissingIntervals(start, end)) {
+        cout << "Brak danych od " << interval.Start.ToString() << " do " << interval.End.ToString() << " ("
+             << interval.Slots << " kwadransów)" << endl;
+        missing += interval.Slots;
+    }
+
+    const EnergyAnalyzer::Coverage coverage = _analyzer.CalculateCoverage(start, end);
+
+    cout << "Brakujących kwadransów: " << missing << " z " << coverage.Expected << ", pokrycie: " << fixed
+         << setprecision(2) << (coverage.Expected ? 100.0 * coverage.Present / coverage.Expected : 0.0) << "%" << endl;
+
+    delete start;
+    delete end;
+}
+
+void CommandParser::ExecuteExtremum(const vector<string> &tokens, const bool maximum) const {
+    const string commandType = maximum ? "MAKS" : "MIN";
+
+    if (tokens.size() < 6) {
+        cerr << "Błąd: Nieprawidłowa liczba argumentów dla komendy " << commandType << "." << endl;
+        return;
+    }
+
+    const string& type = tokens[1];
+    const optional<Metric> metric = ParseMetric(type);
+    size_t index = 2;
+
+    if (!metric.has_value()) {
+        cerr << "Błąd: Nieznany typ dla komendy " << commandType << ": " << type << endl;
+        return;
+    }
+
+    if (tokens[index++] != "OD") {
+        cerr << "Błąd: Brak słowa kluczowego OD" << endl;
+        return;
+    }
+
+    const DateTime *start = ParseDateTime(tokens, index);
+
+    if (tokens[index++] != "DO") {
+        cerr << "Błąd: Brak słowa kluczowego DO" << endl;
+        delete start;
+        return;
+    }
+
+    const DateTime *end = ParseDateTime(tokens, index);
+
+    if (start == nullptr || end == nullptr) {
+        delete start;
+        delete end;
+        return;
+    }
+
+    cout << "Wywołano komendę " << commandType << " dla " << type << " w przedziale od " << start->ToString() << " do " << end->ToString() << endl;
+
+    if (const optional<EnergyAnalyzer::Extremum> extremum = maximum
+                                                               ? _analyzer.FindMaxInRange(*metric, start, end)
+                                                               : _analyzer.FindMinInRange(*metric, start, end)) {
+        cout << fixed << setprecision(4) << (maximum ? "Wartość maksymalna: " : "Wartość minimalna: ")
+             << extremum->Value << " W (" << extremum->When.ToString() << ")" << endl;
+    } else {
+        cout << "Brak danych w przedziale." << endl;
+    }
+
+    delete start;
+    delete end;
+}
+
+void CommandParser::ExecuteTop(const vector<string> &tokens) const {
+    if (tokens.size() < 7) {
+        cerr << "Błąd: Nieprawidłowa liczba argumentów dla komendy NAJWIEKSZE." << endl;
+        return;
+    }
+
+    const optional<size_t> count = ParseCount(tokens[1], "liczba odczytów");
+
+    if (!count.has_value()) return;
+
+    const string& type = tokens[2];
+    const optional<Metric> metric = ParseMetric(type);
+    size_t index = 3;
+
+    if (!metric.has_value()) {
+        cerr << "Błąd: Nieznany typ dla komendy NAJWIEKSZE: " << type << endl;
+        return;
+    }
+
+    if (tokens[index++] != "OD") {
+        cerr << "Błąd: Brak słowa kluczowego OD" << endl;
+        return;
+    }
+
+    const DateTime *start = ParseDateTime(tokens, index);
+
+    if (tokens[index++] != "DO") {
+        cerr << "Błąd: Brak słowa kluczowego DO" << endl;
+        delete start;
+        return;
+    }
+
+    const DateTime *end = ParseDateTime(tokens, index);
+
+    if (start == nullptr || end == nullptr) {
+        delete start;
+        delete end;
+        return;
+    }
+
+    cout << "Wywołano komendę NAJWIEKSZE dla " << *count << " " << type << " w przedziale od " << start->ToString() << " do " << end->ToString() << endl;
+
+    size_t position = 0;
+
+    for (const EnergyAnalyzer::Extremum &extremum: _analyzer.FindTopInRange(*metric, *count, start, end)) {
+        cout << fixed << setprecision(4) << "  " << ++position << ". " << extremum.When.ToString() << " - "
+             << extremum.Value << " W" << endl;
+    }
+
+    if (position == 0) cout << "Brak danych w przedziale." << endl;
+
+    delete start;
+    delete end;
+}
+
+void CommandParser::ExecutePercentile(const vector<string> &tokens) const {
+    if (tokens.size() < 7) {
+        cerr << "Błąd: Nieprawidłowa liczba argumentów dla komendy PERCENTYL." << endl;
+        return;
+    }
+
+    double percentile;
+    try {
+        percentile = stod(tokens[1]);
+    } catch (const exception &e) {
+        cerr << "Błąd: Nieprawidłowy format liczby (percentyl): " << e.what() << endl;
+        return;
+    }
+
+    if (!(percentile >= 0 && percentile <= 100)) {
+        cerr << "Błąd: Percentyl musi należeć do przedziału od 0 do 100: " << tokens[1] << endl;
+        return;
+    }
+
+    const string& type = tokens[2];
+    const optional<Metric> metric = ParseMetric(type);
+    size_t index = 3;
+
+    if (!metric.has_value()) {
+        cerr << "Błąd: Nieznany typ dla komendy PERCENTYL: " << type << endl;
+        return;
+    }
+
+    if (tokens[index++] != "OD") {
+        cerr << "Błąd: Brak słowa kluczowego OD" << endl;
+        return;
+    }
+
+    const DateTime *start = ParseDateTime(tokens, index);
+
+    if (tokens[index++] != "DO") {
+        cerr << "Błąd: Brak słowa kluczowego DO" << endl;
+        delete start;
+        return;
+    }
+
+    const DateTime *end = ParseDateTime(tokens, index);
+
+    if (start == nullptr || end == nullptr) {
+        delete start;
+        delete end;
+        return;
+    }
+
+    const bool exact = index < tokens.size() && tokens[index] == "DOKLADNIE";
+
+    cout << "Wywołano komendę PERCENTYL dla " << tokens[1] << " " << type << " w przedziale od " << start->ToString() << " do " << end->ToString() << endl;
+
+    if (const optional<double> value = exact
+                                           ? _analyzer.CalculatePercentileInRange(*metric, percentile, start, end)
+                                           : _analyzer.EstimatePercentileInRange(*metric, percentile, start, end)) {
+        cout << "Percentyl " << tokens[1];
+
+        if (exact) cout << " (dokładny): ";
+        else cout << " (szacunek, błąd do " << defaultfloat << QuantileSketch::RelativeAccuracy * 100 << "%): ";
+
+        cout << fixed << setprecision(4) << *value << " W" << endl;
+    } else {
+        cout << "Brak danych w przedziale." << endl;
+    }
+
+    delete start;
+    delete end;
+}
+
+void CommandParser::ExecuteHistogram(const vector<string> &tokens) const {
+    if (tokens.size() < 7) {
+        cerr << "Błąd: Nieprawidłowa liczba argumentów dla komendy HISTOGRAM." << endl;
+        return;
+    }
+
+    const optional<size_t> binCount = ParseCount(tokens[1], "liczba przedziałów");
+
+    if (!binCount.has_value()) return;
+
+    if (*binCount == 0 || *binCount > EnergyAnalyzer::MaxHistogramBins) {
+        cerr << "Błąd: Liczba przedziałów musi należeć do przedziału od 1 do " << EnergyAnalyzer::MaxHistogramBins << ": " << tokens[1] << endl;
+        return;
+    }
+
+    const string& type = tokens[2];
+    const optional<Metric> metric = ParseMetric(type);
+    size_t index = 3;
+
+    if (!metric.has_value()) {
+        cerr << "Błąd: Nieznany typ dla komendy HISTOGRAM: " << type << endl;
+        return;
+    }
+
+    if (tokens[index++] != "OD") {
+        cerr << "Błąd: Brak słowa kluczowego OD" << endl;
+        return;
+    }
+
+    const DateTime *start = ParseDateTime(tokens, index);
+
+    if (tokens[index++] != "DO") {
+        cerr << "Błąd: Brak słowa kluczowego DO" << endl;
+        delete start;
+        return;
+    }
+
+    const DateTime *end = ParseDateTime(tokens, index);
+
+    if (start == nullptr || end == nullptr) {
+        delete start;
+        delete end;
+        return;
+    }
+
+    cout << "Wywołano komendę HISTOGRAM dla " << *binCount << " " << type << " w przedziale od " << start->ToString() << " do " << end->ToString() << endl;
+
+    if (const optional<EnergyAnalyzer::Histogram> histogram = _analyzer.HistogramInRange(*metric, *binCount, start, end)) {
+        size_t total = 0;
+
+        for (const size_t count: histogram->Counts) total += count;
+
+        for (size_t i = 0; i < histogram->Counts.size(); ++i) {
+            const bool last = i + 1 == histogram->Counts.size();
+
+            cout << fixed << setprecision(4) << "  [" << histogram->Low + static_cast<double>(i) * histogram->Width
+                 << "; " << (last ? histogram->Low + static_cast<double>(histogram->Counts.size()) * histogram->Width
+                                  : histogram->Low + static_cast<double>(i + 1) * histogram->Width)
+                 << (last ? "]" : ")") << " W: " << histogram->Counts[i] << " (" << setprecision(2)
+                 << 100.0 * static_cast<double>(histogram->Counts[i]) / static_cast<double>(total) << "%)" << endl;
+        }
+    } else {
+        cout << "Brak danych w przedziale." << endl;
+    }
+
+    delete start;
+    delete end;
+}
+
+void CommandParser::ExecuteDurationCurve(const vector<string> &tokens) const {
+    if (tokens.size() < 7) {
+        cerr << "Błąd: Nieprawidłowa liczba argumentów dla komendy KRZYWA_TRWANIA." << endl;
+        return;
+    }
+
+    const optional<size_t> pointCount = ParseCount(tokens[1], "liczba punktów");
+
+    if (!pointCount.has_value()) return;
+
+    const string& type = tokens[2];
+    const optional<Metric> metric = ParseMetric(type);
+    size_t index = 3;
+
+    if (!metric.has_value()) {
+        cerr << "Błąd: Nieznany typ dla komendy KRZYWA_TRWANIA: " << type << endl;
+        return;
+    }
+
+    if (tokens[index++] != "OD") {
+        cerr << "Błąd: Brak słowa kluczowego OD" << endl;
+        return;
+    }
+
+    const DateTime *start = ParseDateTime(tokens, index);
+
+    if (tokens[index++] != "DO") {
+        cerr << "Błąd: Brak słowa kluczowego DO" << endl;
+        delete start;
+        return;
+    }
+
+    const DateTime *end = ParseDateTime(tokens, index);
+
+    if (start == nullptr || end == nullptr) {
+        delete start;
+        delete end;
+        return;
+    }
+
+    cout << "Wywołano komendę KRZYWA_TRWANIA dla " << *pointCount << " " << type << " w przedziale od " << start->ToString() << " do " << end->ToString() << endl;
+
+    const vector<EnergyAnalyzer::DurationPoint> curve = _analyzer.DurationCurveInRange(*metric, *pointCount, start, end);
+
+    for (const EnergyAnalyzer::DurationPoint &point: curve) {
+        cout << fixed << setprecision(2) << "  " << point.Share << "% - " << setprecision(4) << point.Value << " W"
+             << endl;
+    }
+
+    if (curve.empty()) cout << "Brak danych w przedziale." << endl;
+
+    delete start;
+    delete end;
+}
+
+void CommandParser::ExecuteWindow(const vector<string> &tokens) const {
+    if (tokens.size() < 7) {
+        cerr << "Błąd: Nieprawidłowa liczba argumentów dla komendy OKNO." << endl;
+        return;
+    }
+
+    const string& type = tokens[1];
+    const optional<Metric> metric = ParseMetric(type);
+    size_t index = 3;
+
+    if (!metric.has_value()) {
+        cerr << "Błąd: Nieznany typ dla komendy OKNO: " << type << endl;
+        return;
+    }
+
+    const optional<int> widthMinutes = ParseWindowWidth(tokens[2]);
+
+    if (!widthMinutes.has_value()) return;
+
+    if (tokens[index++] != "OD") {
+        cerr << "Błąd: Brak słowa kluczowego OD" << endl;
+        return;
+    }
+
+    const DateTime *start = ParseDateTime(tokens, index);
+
+    if (tokens[index++] != "DO") {
+        cerr << "Błąd: Brak słowa kluczowego DO" << endl;
+        delete start;
+        return;
+    }
+
+    const DateTime *end = ParseDateTime(tokens, index);
+
+    if (start == nullptr || end == nullptr) {
+        delete start;
+        delete end;
+        return;
+    }
+
+    ofstream file;
+
+    if (index < tokens.size() && tokens[index] == "PLIK") {
+        if (index + 1 >= tokens.size()) {
+            cerr << "Błąd: Brak ścieżki pliku po słowie kluczowym PLIK" << endl;
+            delete start;
+            delete end;
+            return;
+        }
+
+        file.open(tokens[index + 1]);
+
+        if (!file.is_open()) {
+            cerr << "Błąd: Nie można otworzyć pliku: " << tokens[index + 1] << endl;
+            delete start;
+            delete end;
+            return;
+        }
+
+        file << "Time,Suma (W),Średnia (W),Min (W),Maks (W),Liczba odczytów" << endl;
+    }
+
+    cout << "Wywołano komendę OKNO dla " << type << " " << tokens[2] << " w przedziale od " << start->ToString() << " do " << end->ToString() << endl;
+
+    size_t count = 0;
+
+    _analyzer.ForEachWindowInRange(*metric, *widthMinutes, start, end, [&](const EnergyAnalyzer::WindowPoint &point) {
+        const long double mean = point.Sum / static_cast<long double>(point.Count);
+
+        if (file.is_open()) {
+            file << fixed << setprecision(4) << point.When.ToString() << "," << point.Sum << "," << mean << ","
+                 << point.Min << "," << point.Max << "," << point.Count << "\n";
+        } else {
+            cout << fixed << setprecision(4) << "  " << point.When.ToString() << " - suma " << point.Sum
+                 << " W, średnia " << mean << " W, min " << point.Min << " W, maks " << point.Max << " W ("
+                 << point.Count << " odczytów)" << "\n";
+        }
+
+        ++count;
+    });
+
+    if (count == 0) cout << "Brak danych w przedziale." << endl;
+    else if (file.is_open()) cout << "Zapisano " << count << " okien do pliku " << tokens[index + 1] << endl;
+    else cout << flush;
+
+    delete start;
+    delete end;
+}
+
+void CommandParser::ExecuteGroup(const vector<string> &tokens) const {
+    if (tokens.size() < 8) {
+        cerr << "Błąd: Nieprawidłowa liczba argumentów dla komendy GRUPUJ." << endl;
+        return;
+    }
+
+    const string& type = tokens[1];
+    const optional<Metric> metric = ParseMetric(type);
+    size_t index = 2;
+
+    if (!metric.has_value()) {
+        cerr << "Błąd: Nieznany typ dla komendy GRUPUJ: " << type << endl;
+        return;
+    }
+
+    if (tokens[index++] != "PO") {
+        cerr << "Błąd: Brak słowa kluczowego PO" << endl;
+        return;
+    }
+
+    const string& groupingName = tokens[index++];
+    EnergyAnalyzer::Grouping grouping;
+
+    if (groupingName == "GODZINA") {
+        grouping = EnergyAnalyzer::Grouping::HourOfDay;
+    } else if (groupingName == "DZIEN_TYGODNIA") {
+        grouping = EnergyAnalyzer::Grouping::DayOfWeek;
+    } else if (groupingName == "DZIEN") {
+        grouping = EnergyAnalyzer::Grouping::Day;
+    } else if (groupingName == "MIESIAC") {
+        grouping = EnergyAnalyzer::Grouping::Month;
+    } else {
+        cerr << "Błąd: Nieznany sposób grupowania dla komendy GRUPUJ: " << groupingName << endl;
+        return;
+    }
+
+    if (tokens[index++] != "OD") {
+        cerr << "Błąd: Brak słowa kluczowego OD" << endl;
+        return;
+    }
+
+    const DateTime *start = ParseDateTime(tokens, index);
+
+    if (tokens[index++] != "DO") {
+        cerr << "Błąd: Brak słowa kluczowego DO" << endl;
+        delete start;
+        return;
+    }
+
+    const DateTime *end = ParseDateTime(tokens, index);
+
+    if (start == nullptr || end == nullptr) {
+        delete start;
+        delete end;
+        return;
+    }
+
+    cout << "Wywołano komendę GRUPUJ dla " << type << " po " << groupingName << " w przedziale od " << start->ToString() << " do " << end->ToString() << endl;
+
+    const vector<EnergyAnalyzer::Group> groups = _analyzer.GroupInRange(grouping, start, end);
+
+    for (const EnergyAnalyzer::Group &group: groups) {
+        ostringstream label;
+
+        label << setfill('0');
+
+        switch (grouping) {
+            case EnergyAnalyzer::Grouping::HourOfDay:
+                label << setw(2) << group.Key << ":00";
+                break;
+            case EnergyAnalyzer::Grouping::DayOfWeek:
+                label << Weekdays[group.Key];
+                break;
+            case EnergyAnalyzer::Grouping::Day:
+                label << setw(2) << group.Key % 100 << "." << setw(2) << group.Key / 100 % 100 << "." << group.Key / 10000;
+                break;
+            case EnergyAnalyzer::Grouping::Month:
+                label << setw(2) << group.Key % 100 << "." << group.Key / 100;
+                break;
+        }
+
+        PrintTotals(label.str(), group.Totals, *metric);
+    }
+
+    if (groups.empty()) cout << "Brak danych w przedziale." << endl;
+
+    delete start;
+    delete end;
+}
+
+void CommandParser::ExecuteCube(const vector<string> &tokens) const {
+    if (tokens.size() < 4) {
+        cerr << "Błąd: Nieprawidłowa liczba argumentów dla komendy KOSTKA." << endl;
+        return;
+    }
+
+    const string& type = tokens[1];
+    const optional<Metric> metric = ParseMetric(type);
+    size_t index = 2;
+
+    if (!metric.has_value()) {
+        cerr << "Błąd: Nieznany typ dla komendy KOSTKA: " << type << endl;
+        return;
+    }
+
+    if (tokens[index++] != "PO") {
+        cerr << "Błąd: Brak słowa kluczowego PO" << endl;
+        return;
+    }
+
+    const string& dimensionName = tokens[index++];
+    AggregateCube::Dimension dimension;
+
+    if (dimensionName == "ROK") {
+        dimension = AggregateCube::Dimension::Year;
+    } else if (dimensionName == "MIESIAC") {
+        dimension = AggregateCube::Dimension::Month;
+    } else if (dimensionName == "DZIEN_TYGODNIA") {
+        dimension = AggregateCube::Dimension::DayOfWeek;
+    } else if (dimensionName == "GODZINA") {
+        dimension = AggregateCube::Dimension::Hour;
+    } else if (dimensionName == "KWADRANS") {
+        dimension = AggregateCube::Dimension::Slot;
+    } else {
+        cerr << "Błąd: Nieznany wymiar dla komendy KOSTKA: " << dimensionName << endl;
+        return;
+    }
+
+    AggregateCube::Filter filter;
+
+    while (index + 1 < tokens.size()) {
+        const string& keyword = tokens[index++];
+        const string& value = tokens[index++];
+
+        try {
+            if (keyword == "ROK") {
+                filter.Year = stoi(value);
+            } else if (keyword == "MIESIAC") {
+                filter.Month = stoi(value);
+
+                if (filter.Month < 1 || filter.Month > 12) throw out_of_range("month");
+            } else if (keyword == "DNI" && value == "ROBOCZE") {
+                filter.Weekdays = AggregateCube::WorkingDays;
+            } else if (keyword == "DNI" && value == "WEEKEND") {
+                filter.Weekdays = AggregateCube::Weekend;
+            } else {
+                cerr << "Błąd: Nieznany filtr dla komendy KOSTKA: " << keyword << " " << value << endl;
+                return;
+            }
+        } catch (const exception &e) {
+            cerr << "Błąd: Nieprawidłowa wartość filtra " << keyword << ": " << e.what() << endl;
+            return;
+        }
+    }
+
+    if (index < tokens.size()) {
+        cerr << "Błąd: Niepełny filtr dla komendy KOSTKA: " << tokens[index] << endl;
+        return;
+    }
+
+    cout << "Wywołano komendę KOSTKA dla " << type << " po " << dimensionName << endl;
+
+    const map<int, Aggregate> groups = _analyzer.RollUpCube(dimension, filter);
+
+    for (const auto &[key, totals]: groups) {
+        ostringstream label;
+
+        label << setfill('0');
+
+        switch (dimension) {
+            case AggregateCube::Dimension::Year:
+                label << key;
+                break;
+            case AggregateCube::Dimension::Month:
+                label << setw(2) << key;
+                break;
+            case AggregateCube::Dimension::DayOfWeek:
+                label << Weekdays[key];
+                break;
+            case AggregateCube::Dimension::Hour:
+                label << setw(2) << key << ":00";
+                break;
+            case AggregateCube::Dimension::Slot:
+                label << setw(2) << key * Quarter::SlotMinutes / 60 << ":" << setw(2) << key * Quarter::SlotMinutes % 60;
+                break;
+        }
+
+        PrintTotals(label.str(), totals, *metric);
+    }
+
+    if (groups.empty()) cout << "Brak danych w wycinku." << endl;
+}
+
+optional<size_t> CommandParser::ParseCount(const string &token, const string &description) {
+    try {
+        if (token.starts_with('-')) throw invalid_argument("negative count");
+
+        return stoul(token);
+    } catch (const exception &e) {
+        cerr << "Błąd: Nieprawidłowy format liczby (" << description << "): " << e.what() << endl;
+        return nullopt;
+    }
+}
+
+optional<int> CommandParser::ParseWindowWidth(const string &token) {
+    const char unit = token.empty() ? '\0' : token.back();
+    const int unitMinutes = unit == 'M' ? 1 : unit == 'H' ? 60 : unit == 'D' ? 24 * 60 : 0;
+
+    try {
+        if (unitMinutes == 0) throw invalid_argument("unknown unit");
+        if (token.starts_with('-')) throw invalid_argument("negative width");
+
+        const string number = token.substr(0, token.size() - 1);
+        size_t length;
+        const long long value = stoll(number, &length);
+
+        if (length != number.size()) throw invalid_argument("trailing characters");
+        if (value < 1 || value > EnergyAnalyzer::MaxWindowMinutes / unitMinutes) throw out_of_range("width");
+
+        return static_cast<int>(value) * unitMinutes;
+    } catch (const exception &) {
+        cerr << "Błąd: Nieprawidłowa szerokość okna (np. 15M, 1H, 7D): " << token << endl;
+        return nullopt;
+    }
+}
+
+optional<Metric> CommandParser::ParseMetric(const string &type) {
+    if (type == "AUTOKONSUMPCJA") return Metric::AutoConsumption;
+    if (type == "EKSPORT" || type == "EXPORT") return Metric::Export;
+    if (type == "IMPORT") return Metric::Import;
+    if (type == "POBOR") return Metric::Consumption;
+    if (type == "PRODUKCJA") return Metric::Generation;
+
+    return nullopt;
+}
+
+void CommandParser::PrintSum(const Metric metric, const long double sum) {
+    cout << fixed << setprecision(4) << Labels[static_cast<int>(metric)].Sum << ": " << sum << " W" << endl;
+}
+
+void CommandParser::PrintAverage(const Metric metric, const long double average) {
+    cout << fixed << setprecision(4) << Labels[static_cast<int>(metric)].Average << ": " << average << " W" << endl;
+}
+
+void CommandParser::PrintComparison(const Metric metric, const DateTime &start1, const DateTime &end1,
+                                    const long double sum1, const DateTime &start2, const DateTime &end2,
+                                    const long double sum2) {
+    const char *label = Labels[static_cast<int>(metric)].Comparison;
+
+    if (sum1 > sum2)
+        cout << fixed << setprecision(4) << "Okres od " << start1.ToString() << " do " << end1.ToString() << " ma większe " << label << " energii o wartości " << sum1 - sum2 << " W" << endl;
+    else if (sum1 < sum2)
+        cout << fixed << setprecision(4) << "Okres od " << start2.ToString() << " do " << end2.ToString() << " ma większe " << label << " energii o wartości " << sum2 - sum1 << " W" << endl;
+    else
+        cout << fixed << setprecision(4) << "Okresy mają takie same " << label << " energii" << endl;
+}
+
+void CommandParser::PrintTotals(const string &label, const Aggregate &totals, const Metric metric) {
+    cout << fixed << setprecision(4) << "  " << label << ": suma " << totals.GetSum(metric)
+         << " W, średnia " << totals.GetSum(metric) / totals.GetCount() << " W, min " << totals.GetMin(metric)
+         << " W, maks " << totals.GetMax(metric) << " W (" << totals.GetCount() << " odczytów)" << endl;
+}
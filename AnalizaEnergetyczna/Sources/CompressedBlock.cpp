@@ -0,0 +1,259 @@
+#include "../Headers/CompressedBlock.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+    /**
+     * @brief Zapisuje wartości o zadanej liczbie bitów do strumienia bitów.
+     */
+    class BitWriter {
+    public:
+        explicit BitWriter(vector<uint64_t> &bits) : _bits(bits) {
+        }
+
+        void Write(const uint64_t value, const int count) {
+            for (int written = 0; written < count;) {
+                if (_used == 0) _bits.push_back(0);
+
+                const int chunk = min(count - written, 64 - _used);
+                const uint64_t part = value >> (count - written - chunk) & (chunk == 64 ? ~0ull : (1ull << chunk) - 1);
+
+                _bits.back() |= part << (64 - _used - chunk);
+                _used = (_used + chunk) % 64;
+                written += chunk;
+            }
+        }
+
+    private:
+        vector<uint64_t> &_bits;
+        int _used = 0;
+    };
+
+    /**
+     * @brief Odczytuje wartości o zadanej liczbie bitów ze strumienia bitów.
+     */
+    class BitReader {
+    public:
+        explicit BitReader(const vector<uint64_t> &bits) : _bits(bits) {
+        }
+
+        uint64_t Read(const int count) {
+            uint64_t value = 0;
+
+            for (int read = 0; read < count;) {
+                const int used = static_cast<int>(_position % 64);
+                const int chunk = min(count - read, 64 - used);
+                const uint64_t word = _bits[_position / 64];
+                const uint64_t part = word >> (64 - used - chunk) & (chunk == 64 ? ~0ull : (1ull << chunk) - 1);
+
+                value = chunk == 64 ? part : value << chunk | part;
+                _position += chunk;
+                read += chunk;
+            }
+
+            return value;
+        }
+
+    private:
+        const vector<uint64_t> &_bits;
+        size_t _position = 0;
+    };
+
+    /**
+     * @brief Liczba bitów różnicy drugiego rzędu znaczników czasu (po kodowaniu zigzag).
+     */
+    constexpr int DeltaBits = 13;
+
+    /**
+     * @brief Liczba bitów minuty dnia (łącznie z godziną powtarzaną).
+     */
+    constexpr int MinuteBits = 11;
+}
+
+/**
+ * @brief Konstruktor klasy CompressedBlock.
+ *
+ * Minuty drugiego wystąpienia godziny powtarzanej i wszystkie późniejsze są przesuwane
+ * o godzinę, dzięki czemu znaczniki czasu tworzą ciąg rosnący.
+ *
+ * @param data Rekordy dnia w porządku chronologicznym.
+ */
+CompressedBlock::CompressedBlock(const vector<Data> &data) {
+    for (const Data &record: data) {
+        if (record.GetTime().IsRepeated()) _repeatedHour = record.GetTime().GetHour();
+
+        _aggregate.Add(record);
+    }
+
+    BitWriter writer(_bits);
+
+    writer.Write(data.size(), 16);
+
+    // Znaczniki czasu: pierwsza minuta, pierwsza różnica, a dalej różnice drugiego rzędu.
+    int previousMinute = 0, previousDelta = 0;
+
+    for (size_t i = 0; i < data.size(); ++i) {
+        const Time &time = data[i].GetTime();
+        const bool shifted = time.IsRepeated() || (_repeatedHour >= 0 && time.GetHour() > _repeatedHour);
+        const int minute = time.GetMinuteOfDay() + (shifted ? 60 : 0);
+
+        if (i == 0) {
+            writer.Write(minute, MinuteBits);
+        } else if (i == 1) {
+            writer.Write(minute - previousMinute, MinuteBits);
+            previousDelta = minute - previousMinute;
+        } else {
+            const int delta = minute - previousMinute;
+
+            if (const int deltaOfDelta = delta - previousDelta; deltaOfDelta == 0) {
+                writer.Write(0, 1);
+            } else {
+                writer.Write(1, 1);
+                writer.Write(static_cast<uint32_t>(deltaOfDelta << 1 ^ deltaOfDelta >> 31), DeltaBits);
+            }
+
+            previousDelta = delta;
+        }
+
+        previousMinute = minute;
+    }
+
+    // Kolumny wartości: XOR z poprzednią wartością, z zapamiętanym oknem bitów znaczących.
+    for (int metric = 0; metric < MetricCount; ++metric) {
+        uint64_t previous = 0;
+        int leading = -1, trailing = 0;
+
+        for (size_t i = 0; i < data.size(); ++i) {
+            const uint64_t bits = bit_cast<uint64_t>(data[i].GetValue(static_cast<Metric>(metric)));
+
+            if (i == 0) {
+                writer.Write(bits, 64);
+                previous = bits;
+                continue;
+            }
+
+            const uint64_t xored = bits ^ previous;
+            previous = bits;
+
+            if (xored == 0) {
+                writer.Write(0, 1);
+                continue;
+            }
+
+            writer.Write(1, 1);
+
+            const int currentLeading = min(countl_zero(xored), 31);
+            const int currentTrailing = countr_zero(xored);
+
+            if (leading >= 0 && currentLeading >= leading && currentTrailing >= trailing) {
+                writer.Write(0, 1);
+                writer.Write(xored >> trailing, 64 - leading - trailing);
+                continue;
+            }
+
+            leading = currentLeading;
+            trailing = currentTrailing;
+
+            const int meaningful = 64 - leading - trailing;
+
+            writer.Write(1, 1);
+            writer.Write(leading, 5);
+            writer.Write(meaningful - 1, 6);
+            writer.Write(xored >> trailing, meaningful);
+        }
+    }
+
+    _bits.shrink_to_fit();
+}
+
+/**
+ * @brief Rozpakowuje blok.
+ *
+ * @return Rekordy dnia w porządku chronologicznym.
+ */
+vector<Data> CompressedBlock::Decode() const {
+    BitReader reader(_bits);
+
+    const auto count = static_cast<size_t>(reader.Read(16));
+
+    vector<Time> times;
+    times.reserve(count);
+
+    int minute = 0, delta = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        if (i == 0) {
+            minute = static_cast<int>(reader.Read(MinuteBits));
+        } else if (i == 1) {
+            delta = static_cast<int>(reader.Read(MinuteBits));
+            minute += delta;
+        } else {
+            if (reader.Read(1) == 1) {
+                const auto zigzag = static_cast<uint32_t>(reader.Read(DeltaBits));
+                delta += static_cast<int>(zigzag >> 1) ^ -static_cast<int>(zigzag & 1);
+            }
+
+            minute += delta;
+        }
+
+        if (_repeatedHour >= 0 && minute >= (_repeatedHour + 1) * 60) {
+            const bool repeated = minute < (_repeatedHour + 2) * 60;
+            times.emplace_back((minute - 60) / 60, minute % 60, repeated);
+        } else {
+            times.emplace_back(minute / 60, minute % 60);
+        }
+    }
+
+    array<vector<double>, MetricCount> columns;
+
+    for (int metric = 0; metric < MetricCount; ++metric) {
+        vector<double> &column = columns[metric];
+        column.reserve(count);
+
+        uint64_t previous = 0;
+        int leading = 0, trailing = 0;
+
+        for (size_t i = 0; i < count; ++i) {
+            if (i > 0 && reader.Read(1) == 1) {
+                if (reader.Read(1) == 1) {
+                    leading = static_cast<int>(reader.Read(5));
+                    const int meaningful = static_cast<int>(reader.Read(6)) + 1;
+                    trailing = 64 - leading - meaningful;
+                }
+
+                previous ^= reader.Read(64 - leading - trailing) << trailing;
+            } else if (i == 0) {
+                previous = reader.Read(64);
+            }
+
+            column.push_back(bit_cast<double>(previous));
+        }
+    }
+
+    vector<Data> data;
+    data.reserve(count);
+
+    for (size_t i = 0; i < count; ++i)
+        data.emplace_back(times[i], columns[0][i], columns[1][i], columns[2][i], columns[3][i], columns[4][i]);
+
+    return data;
+}
+
+/**
+ * @brief Zwraca agregat z nagłówka bloku.
+ *
+ * @return Referencja do agregatu.
+ */
+const Aggregate &CompressedBlock::GetAggregate() const {
+    return _aggregate;
+}
+
+/**
+ * @brief Zwraca rozmiar skompresowanych danych w bajtach.
+ *
+ * @return Rozmiar w bajtach.
+ */
+size_t CompressedBlock::GetSizeInBytes() const {
+    return _bits.size() * sizeof(uint64_t);
+}
@@ -0,0 +1,267 @@
+#include "../Headers/CompressedInput.hpp"
+
+#include <array>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+
+#ifdef ENERGY_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef ENERGY_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+/**
+ * @brief Rozpoznaje format pliku po jego pierwszych bajtach.
+ *
+ * @param filepath Ścieżka do pliku.
+ * @return Format pliku.
+ */
+CompressedInput::Format CompressedInput::DetectFormat(const string &filepath) {
+    ifstream inputFile(filepath, ios::binary);
+    array<unsigned char, 4> magic{};
+
+    if (!inputFile.read(reinterpret_cast<char *>(magic.data()), magic.size())) return Format::None;
+
+    if (magic[0] == 0x1F && magic[1] == 0x8B) return Format::Gzip;
+    if (magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD) return Format::Zstd;
+
+    return Format::None;
+}
+
+/**
+ * @brief Otwiera plik i uruchamia wątek dekompresji.
+ *
+ * @param filepath Ścieżka do pliku.
+ * @param format Format pliku.
+ * @throws runtime_error Jeśli format nie jest obsługiwany.
+ */
+CompressedInput::CompressedInput(const string &filepath, const Format format) : _filepath(filepath) {
+#ifndef ENERGY_HAVE_ZLIB
+    if (format == Format::Gzip) throw runtime_error("gzip input is not supported in this build: " + filepath);
+#endif
+#ifndef ENERGY_HAVE_ZSTD
+    if (format == Format::Zstd) throw runtime_error("zstd input is not supported in this build: " + filepath);
+#endif
+    if (format == Format::None) throw invalid_argument("File is not compressed: " + filepath);
+
+    _thread = jthread([this, format](const stop_token &token) {
+        try {
+            if (format == Format::Gzip) DecompressGzip(token);
+            else DecompressZstd(token);
+        } catch (...) {
+            lock_guard lock(_mutex);
+            _error = current_exception();
+        }
+
+        lock_guard lock(_mutex);
+        _finished = true;
+        _changed.notify_all();
+    });
+}
+
+/**
+ * @brief Zatrzymuje wątek dekompresji i czeka na jego zakończenie.
+ */
+CompressedInput::~CompressedInput() {
+    _thread.request_stop();
+
+    if (_thread.joinable()) _thread.join();
+}
+
+/**
+ * @brief Odczytuje kolejną linię rozpakowanych danych.
+ *
+ * @param line Widok na linię, ważny do następnego wywołania.
+ * @return true, jeśli odczytano linię, false na końcu danych.
+ * @throws runtime_error Jeśli plik jest uszkodzony.
+ */
+bool CompressedInput::ReadLine(string_view &line) {
+    _line.clear();
+
+    while (true) {
+        if (_position < _current.size()) {
+            if (const size_t newline = _current.find('\n', _position); newline != string::npos) {
+                const string_view part(_current.data() + _position, newline - _position);
+                _position = newline + 1;
+
+                // Linia w całości w bloku - bez kopiowania.
+                if (_line.empty()) {
+                    line = part;
+                    return true;
+                }
+
+                _line.append(part);
+                line = _line;
+                return true;
+            }
+
+            _line.append(_current, _position);
+            _position = _current.size();
+        }
+
+        if (!NextChunk()) {
+            line = _line;
+            return !_line.empty();
+        }
+    }
+}
+
+/**
+ * @brief Przekazuje rozpakowany blok do kolejki.
+ *
+ * @param token Token zatrzymania wątku dekompresji.
+ * @param chunk Rozpakowany blok.
+ * @return false, jeśli zażądano zatrzymania wątku, true w przeciwnym razie.
+ */
+bool CompressedInput::Push(const stop_token &token, string &&chunk) {
+    unique_lock lock(_mutex);
+
+    if (!_changed.wait(lock, token, [this] { return _chunks.size() < MaxQueuedChunks; })) return false;
+
+    _chunks.push_back(std::move(chunk));
+    _changed.notify_all();
+
+    return true;
+}
+
+/**
+ * @brief Pobiera z kolejki następny blok rozpakowanych danych.
+ *
+ * @return false, jeśli dane się skończyły, true w przeciwnym razie.
+ * @throws runtime_error Jeśli wątek dekompresji zgłosił błąd.
+ */
+bool CompressedInput::NextChunk() {
+    unique_lock lock(_mutex);
+
+    _changed.wait(lock, [this] { return !_chunks.empty() || _finished; });
+
+    if (_chunks.empty()) {
+        if (_error) rethrow_exception(_error);
+        return false;
+    }
+
+    _current = std::move(_chunks.front());
+    _chunks.pop_front();
+    _position = 0;
+    _changed.notify_all();
+
+    return true;
+}
+
+/**
+ * @brief Rozpakowuje plik gzip.
+ *
+ * Po zakończeniu jednego członu strumień jest zerowany, więc obsługiwane są też pliki
+ * złożone z kilku członów.
+ *
+ * @param token Token zatrzymania wątku.
+ * @throws runtime_error Jeśli nie można otworzyć pliku lub jest on uszkodzony.
+ */
+void CompressedInput::DecompressGzip(const stop_token &token) {
+#ifdef ENERGY_HAVE_ZLIB
+    ifstream inputFile(_filepath, ios::binary);
+
+    if (!inputFile.is_open()) throw runtime_error("Could not open file");
+
+    z_stream stream{};
+
+    // 15 bitów okna, +32 - automatyczne rozpoznanie nagłówka gzip/zlib.
+    if (inflateInit2(&stream, 15 + 32) != Z_OK) throw runtime_error("Could not initialize gzip decompression");
+
+    const unique_ptr<z_stream, int (*)(z_streamp)> guard(&stream, inflateEnd);
+
+    string input(ChunkSize, '\0');
+    bool complete = true;
+    bool outputFull = false;
+
+    while (!token.stop_requested()) {
+        // Przy zapełnionym buforze wyjściowym dekoder może mieć jeszcze dane bez nowego wejścia.
+        if (stream.avail_in == 0 && !outputFull) {
+            inputFile.read(input.data(), static_cast<streamsize>(input.size()));
+            stream.next_in = reinterpret_cast<Bytef *>(input.data());
+            stream.avail_in = static_cast<uInt>(inputFile.gcount());
+
+            if (stream.avail_in == 0) break;
+        }
+
+        string output(ChunkSize, '\0');
+        stream.next_out = reinterpret_cast<Bytef *>(output.data());
+        stream.avail_out = static_cast<uInt>(output.size());
+
+        const int result = inflate(&stream, Z_NO_FLUSH);
+
+        if (result == Z_STREAM_END) {
+            complete = true;
+            inflateReset(&stream);
+        } else if (result == Z_OK) {
+            complete = false;
+        } else if (result != Z_BUF_ERROR) {
+            throw runtime_error("Corrupted gzip file: " + _filepath);
+        }
+
+        outputFull = stream.avail_out == 0;
+        output.resize(output.size() - stream.avail_out);
+
+        if (!output.empty() && !Push(token, std::move(output))) return;
+    }
+
+    if (!complete && !token.stop_requested()) throw runtime_error("Truncated gzip file: " + _filepath);
+#else
+    (void) token;
+#endif
+}
+
+/**
+ * @brief Rozpakowuje plik zstd.
+ *
+ * @param token Token zatrzymania wątku.
+ * @throws runtime_error Jeśli nie można otworzyć pliku lub jest on uszkodzony.
+ */
+void CompressedInput::DecompressZstd(const stop_token &token) {
+#ifdef ENERGY_HAVE_ZSTD
+    ifstream inputFile(_filepath, ios::binary);
+
+    if (!inputFile.is_open()) throw runtime_error("Could not open file");
+
+    const unique_ptr<ZSTD_DStream, size_t (*)(ZSTD_DStream *)> stream(ZSTD_createDStream(), ZSTD_freeDStream);
+
+    if (stream == nullptr || ZSTD_isError(ZSTD_initDStream(stream.get())))
+        throw runtime_error("Could not initialize zstd decompression");
+
+    string input(ChunkSize, '\0');
+    size_t remaining = 0; // 0 - ostatnia ramka została w całości rozpakowana.
+
+    while (!token.stop_requested()) {
+        inputFile.read(input.data(), static_cast<streamsize>(input.size()));
+
+        ZSTD_inBuffer in{input.data(), static_cast<size_t>(inputFile.gcount()), 0};
+
+        if (in.size == 0) break;
+
+        // Dekoder może mieć rozpakowane dane w buforze także po zużyciu całego wejścia.
+        bool outputFull = true;
+
+        while (in.pos < in.size || outputFull) {
+            string output(ChunkSize, '\0');
+            ZSTD_outBuffer out{output.data(), output.size(), 0};
+
+            remaining = ZSTD_decompressStream(stream.get(), &out, &in);
+
+            if (ZSTD_isError(remaining))
+                throw runtime_error("Corrupted zstd file: " + _filepath + " (" + ZSTD_getErrorName(remaining) + ")");
+
+            outputFull = out.pos == out.size;
+            output.resize(out.pos);
+
+            if (!output.empty() && !Push(token, std::move(output))) return;
+        }
+    }
+
+    if (remaining != 0 && !token.stop_requested()) throw runtime_error("Truncated zstd file: " + _filepath);
+#else
+    (void) token;
+#endif
+}
@@ -0,0 +1,108 @@
+#include "../Headers/CsvDialect.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+#include "../Headers/CompressedInput.hpp"
+
+/**
+ * @brief Rozpoznaje odmianę pliku na podstawie nagłówka i pierwszych linii danych.
+ *
+ * Jedna linia nie wystarcza do rozpoznania separatora dziesiętnego - odczyty o północy są
+ * często całkowite (`0;0;0;0;0`), więc przeglądane są wszystkie podane linie.
+ *
+ * @param header Nagłówek pliku.
+ * @param lines Pierwsze linie danych.
+ * @return Rozpoznana odmiana.
+ */
+CsvDialect CsvDialect::Detect(const string_view header, const vector<string_view> &lines) {
+    CsvDialect dialect = ExporterDialect;
+
+    // Przy równej liczbie wystąpień wygrywa kandydat wcześniejszy na liście.
+    size_t best = 0;
+
+    for (const char candidate: {',', ';', '\t'}) {
+        if (const auto count = static_cast<size_t>(ranges::count(header, candidate)); count > best) {
+            best = count;
+            dialect.Separator = candidate;
+        }
+    }
+
+    if (lines.empty()) return dialect;
+
+    bool comma = false, dot = false;
+
+    dialect.Quoted = false;
+
+    for (size_t i = 0; i < lines.size(); ++i) {
+        string_view rest = lines[i];
+        bool first = true;
+
+        dialect.Quoted |= rest.find('"') != string_view::npos;
+
+        while (!rest.empty()) {
+            const size_t start = rest.find_first_not_of(" \t");
+            size_t end;
+
+            if (start != string_view::npos && rest[start] == '"') {
+                end = rest.find('"', start + 1);
+                end = rest.find(dialect.Separator, end == string_view::npos ? rest.size() : end);
+            } else {
+                end = rest.find(dialect.Separator);
+            }
+
+            const string_view field = rest.substr(0, end);
+
+            if (first) {
+                // Data ISO zaczyna się od czterocyfrowego roku: RRRR-MM-DD.
+                const size_t digits = field.find_first_of("0123456789");
+
+                if (i == 0 && digits != string_view::npos && field.find('-', digits) == digits + 4)
+                    dialect.Layout = DateLayout::Iso;
+                first = false;
+            } else {
+                comma |= field.find(',') != string_view::npos;
+                dot |= field.find('.') != string_view::npos;
+            }
+
+            rest.remove_prefix(end == string_view::npos ? rest.size() : end + 1);
+        }
+    }
+
+    if (comma) dialect.Decimal = ',';
+    else if (dot) dialect.Decimal = '.';
+    else dialect.Decimal = dialect.Separator == ';' ? ',' : '.';
+
+    return dialect;
+}
+
+/**
+ * @brief Rozpoznaje odmianę pliku na podstawie nagłówka i pierwszych linii danych.
+ *
+ * @param filepath Ścieżka do pliku CSV.
+ * @return Rozpoznana odmiana.
+ */
+CsvDialect CsvDialect::DetectFile(const string &filepath) {
+    string header;
+    vector<string> lines;
+
+    if (const CompressedInput::Format format = CompressedInput::DetectFormat(filepath);
+        format != CompressedInput::Format::None) {
+        CompressedInput input(filepath, format);
+        string_view line;
+
+        if (input.ReadLine(line)) header = line;
+        while (lines.size() < SampleLines && input.ReadLine(line)) lines.emplace_back(line);
+    } else {
+        ifstream inputFile(filepath);
+        string line;
+
+        getline(inputFile, header);
+        while (lines.size() < SampleLines && getline(inputFile, line)) lines.push_back(std::move(line));
+    }
+
+    // Puste linie (np. na końcu pliku) nie niosą informacji o odmianie.
+    erase_if(lines, [](const string &line) { return line.find_first_not_of(" \t\r") == string::npos; });
+
+    return Detect(header, vector<string_view>(lines.begin(), lines.end()));
+}
@@ -5,15 +5,14 @@
  *
  * Tworzy obiekt klasy Data przechowujący informacje o zużyciu i produkcji energii w danym czasie.
  *
- * @param time Wskaźnik do obiektu Time reprezentującego czas pomiaru.
+ * @param time Czas pomiaru.
  * @param autoConsumption Wartość autokonsumpcji energii [kWh].
  * @param exportW Wartość eksportu energii [kWh].
  * @param importW Wartość importu energii [kWh].
  * @param consumption Wartość całkowitego zużycia energii [kWh].
  * @param generation Wartość produkcji energii [kWh].
  */
-Data::Data(Time* time,const double autoConsumption, const double exportW, const double importW, const double consumption, const double generation) {
-    _time = time;
+Data::Data(const Time& time, const double autoConsumption, const double exportW, const double importW, const double consumption, const double generation) : _time(time) {
     _autoConsumption = autoConsumption;
     _export = exportW;
     _import = importW;
@@ -21,22 +20,13 @@ Data::Data(Time* time,const double autoConsumption, const double exportW, const
     _generation = generation;
 }
 
-/**
- * @brief Destruktor klasy Data.
- *
- * Zwalnia pamięć zaalokowaną dla obiektu Time.
- */
-Data::~Data() {
-    delete _time;
-}
-
 /**
  * @brief Zwraca referencję do obiektu Time.
  *
  * @return Referencja do obiektu Time reprezentującego czas pomiaru.
  */
-Time& Data::GetTime() const {
-    return *_time;
+const Time& Data::GetTime() const {
+    return _time;
 }
 
 /**
@@ -82,4 +72,22 @@ double Data::GetConsumption() const {
  */
 double Data::GetGeneration() const {
     return _generation;
+}
+
+/**
+ * @brief Zwraca wartość wskazanej wielkości.
+ *
+ * @param metric Wielkość, której wartość należy zwrócić.
+ * @return Wartość wielkości [kWh].
+ */
+double Data::GetValue(const Metric metric) const {
+    switch (metric) {
+        case Metric::AutoConsumption: return _autoConsumption;
+        case Metric::Export: return _export;
+        case Metric::Import: return _import;
+        case Metric::Consumption: return _consumption;
+        case Metric::Generation: return _generation;
+    }
+
+    return 0;
 }
\ No newline at end of file
@@ -0,0 +1,235 @@
+#include "../Headers/DataValidator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Konstruktor klasy DataValidator.
+ *
+ * @param rejected Reguły, których naruszenie odrzuca rekord.
+ */
+DataValidator::DataValidator(const RuleSet rejected) : _rejected(rejected | RuleOf(ValidationRule::InvalidTimestamp)) {
+}
+
+/**
+ * @brief Zmienia reguły, których naruszenie odrzuca rekord.
+ *
+ * @param rejected Reguły, których naruszenie odrzuca rekord.
+ */
+void DataValidator::SetRejectedRules(const RuleSet rejected) {
+    lock_guard lock(_mutex);
+
+    _rejected = rejected | RuleOf(ValidationRule::InvalidTimestamp);
+}
+
+/**
+ * @brief Sprawdza partię rekordów i usuwa z niej rekordy odrzucone.
+ *
+ * Dłuższa partia jest sprawdzana fragmentami po `BatchSize` rekordów, więc tablice
+ * pomocnicze mieszczą się na stosie. Blokada jest zajmowana raz na partię.
+ *
+ * @param records Partia rekordów.
+ * @return Liczba odrzuconych rekordów.
+ */
+size_t DataValidator::Validate(vector<EnergyData> &records) {
+    const RuleSet enforced = GetRejectedRules();
+    array<size_t, ValidationRuleCount> violations{};
+    vector<QuarantinedRecord> quarantined;
+    size_t kept = 0;
+
+    for (size_t begin = 0; begin < records.size(); begin += BatchSize) {
+        const size_t count = min(BatchSize, records.size() - begin);
+        RuleSet masks[BatchSize];
+
+        Check(records.data() + begin, count, masks);
+
+        for (int rule = 0; rule < ValidationRuleCount; ++rule) {
+            size_t total = 0;
+
+            for (size_t i = 0; i < count; ++i) total += masks[i] >> rule & 1;
+
+            violations[rule] += total;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            EnergyData &record = records[begin + i];
+
+            if (masks[i] & enforced) quarantined.push_back({std::move(record), masks[i]});
+            else if (kept != begin + i) records[kept++] = std::move(record);
+            else ++kept;
+        }
+    }
+
+    const size_t rejected = records.size() - kept;
+
+    records.erase(records.begin() + static_cast<ptrdiff_t>(kept), records.end());
+
+    lock_guard lock(_mutex);
+
+    _checked += kept + rejected;
+    _rejectedCount += rejected;
+
+    for (int rule = 0; rule < ValidationRuleCount; ++rule) _violations[rule] += violations[rule];
+
+    for (QuarantinedRecord &record: quarantined) {
+        if (_quarantine.size() >= QuarantineLimit) break;
+        _quarantine.push_back(std::move(record));
+    }
+
+    return rejected;
+}
+
+/**
+ * @brief Wyznacza bity naruszonych reguł dla fragmentu partii.
+ *
+ * Wartości są najpierw przepisywane do tablic po jednej dla każdej wielkości, a każda reguła
+ * jest osobną pętlą bez rozgałęzień (warunki łączone operatorami bitowymi). Porównania z NaN
+ * są fałszywe, więc kolumny niewczytane nie naruszają reguł. Dzień jest sprawdzany z liczbą dni
+ * miesiąca (tablica i bit roku przestępnego), więc np. 31.02 i 31.04 są niepoprawne.
+ *
+ * @param records Rekordy fragmentu.
+ * @param count Liczba rekordów fragmentu.
+ * @param violations Tablica na bity naruszeń.
+ */
+void DataValidator::Check(const EnergyData *records, const size_t count, RuleSet *violations) {
+    double autoConsumption[BatchSize], exportW[BatchSize], import[BatchSize], consumption[BatchSize],
+            generation[BatchSize];
+    int day[BatchSize], month[BatchSize], year[BatchSize], hour[BatchSize], minute[BatchSize];
+
+    for (size_t i = 0; i < count; ++i) {
+        const DateTime &dateTime = records[i].GetDateTime();
+
+        autoConsumption[i] = records[i].GetAutoConsumption();
+        exportW[i] = records[i].GetExport();
+        import[i] = records[i].GetImport();
+        consumption[i] = records[i].GetConsumption();
+        generation[i] = records[i].GetGeneration();
+        day[i] = dateTime.GetDay();
+        month[i] = dateTime.GetMonth();
+        year[i] = dateTime.GetYear();
+        hour[i] = dateTime.GetHour();
+        minute[i] = dateTime.GetMinute();
+    }
+
+    constexpr auto bit = [](const ValidationRule rule) { return static_cast<int>(rule); };
+
+    // Liczba dni kolejnych miesięcy roku nieprzestępnego (pozycja 0 - dla niepoprawnego miesiąca).
+    static constexpr int monthDays[13] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+    for (size_t i = 0; i < count; ++i) {
+        const bool validMonth = (month[i] >= 1) & (month[i] <= 12);
+        const bool leap = ((year[i] % 4 == 0) & (year[i] % 100 != 0)) | (year[i] % 400 == 0);
+        const int lastDay = monthDays[month[i] * validMonth] + (leap & (month[i] == 2));
+        const bool invalid = !validMonth | (day[i] < 1) | (day[i] > lastDay) | (hour[i] < 0) | (hour[i] > 23) |
+                             (minute[i] < 0) | (minute[i] > 59);
+
+        violations[i] = static_cast<RuleSet>(invalid << bit(ValidationRule::InvalidTimestamp));
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const bool negative = (autoConsumption[i] < 0) | (exportW[i] < 0) | (import[i] < 0) |
+                              (consumption[i] < 0) | (generation[i] < 0);
+
+        violations[i] |= static_cast<RuleSet>(negative << bit(ValidationRule::NegativeValue));
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const double tolerance = max(BalanceTolerance, BalanceRelativeTolerance * fabs(consumption[i]));
+        const bool unbalanced = fabs(consumption[i] - (import[i] + autoConsumption[i])) > tolerance;
+
+        violations[i] |= static_cast<RuleSet>(unbalanced << bit(ValidationRule::ConsumptionBalance));
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const double tolerance = max(BalanceTolerance, BalanceRelativeTolerance * fabs(generation[i]));
+        const bool unbalanced = fabs(generation[i] - (autoConsumption[i] + exportW[i])) > tolerance;
+
+        violations[i] |= static_cast<RuleSet>(unbalanced << bit(ValidationRule::GenerationBalance));
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const bool night = ((hour[i] >= NightStartHour) | (hour[i] < NightEndHour)) &
+                           (generation[i] > NightGenerationLimit);
+
+        violations[i] |= static_cast<RuleSet>(night << bit(ValidationRule::NightGeneration));
+    }
+}
+
+/**
+ * @brief Zwraca reguły, których naruszenie odrzuca rekord.
+ *
+ * @return Zbiór reguł.
+ */
+RuleSet DataValidator::GetRejectedRules() const {
+    lock_guard lock(_mutex);
+
+    return _rejected;
+}
+
+/**
+ * @brief Zwraca liczbę sprawdzonych rekordów.
+ *
+ * @return Liczba rekordów.
+ */
+size_t DataValidator::GetCheckedCount() const {
+    lock_guard lock(_mutex);
+
+    return _checked;
+}
+
+/**
+ * @brief Zwraca liczbę rekordów naruszających regułę.
+ *
+ * @param rule Reguła.
+ * @return Liczba naruszeń.
+ */
+size_t DataValidator::GetViolationCount(const ValidationRule rule) const {
+    lock_guard lock(_mutex);
+
+    return _violations[static_cast<int>(rule)];
+}
+
+/**
+ * @brief Zwraca liczbę odrzuconych rekordów.
+ *
+ * @return Liczba rekordów.
+ */
+size_t DataValidator::GetRejectedCount() const {
+    lock_guard lock(_mutex);
+
+    return _rejectedCount;
+}
+
+/**
+ * @brief Zwraca kopię rekordów z kwarantanny.
+ *
+ * @return Odrzucone rekordy.
+ */
+vector<QuarantinedRecord> DataValidator::GetQuarantine() const {
+    lock_guard lock(_mutex);
+
+    return _quarantine;
+}
+
+/**
+ * @brief Zwraca nazwę reguły.
+ *
+ * @param rule Reguła.
+ * @return Nazwa reguły.
+ */
+const char *DataValidator::GetRuleName(const ValidationRule rule) {
+    switch (rule) {
+        case ValidationRule::InvalidTimestamp:
+            return "invalid timestamp";
+        case ValidationRule::NegativeValue:
+            return "negative value";
+        case ValidationRule::ConsumptionBalance:
+            return "consumption != import + autoconsumption";
+        case ValidationRule::GenerationBalance:
+            return "generation != autoconsumption + export";
+        case ValidationRule::NightGeneration:
+            return "generation at night";
+    }
+
+    return "unknown rule";
+}
@@ -1,5 +1,7 @@
 #include "../Headers/DateTime.hpp"
 
+#include <chrono>
+
 /**
  * @brief Konstruktor klasy DateTime.
  *
@@ -8,9 +10,11 @@
  * @param year Rok.
  * @param hour Godzina.
  * @param minute Minuta.
+ * @param repeated Znacznik drugiego wystąpienia godziny powtarzanej przy zmianie czasu.
  */
-DateTime::DateTime(const int day, const int month, const int year, const int hour, const int minute) : _day(day),
-    _month(month), _year(year), _hour(hour), _minute(minute) { }
+DateTime::DateTime(const int day, const int month, const int year, const int hour, const int minute,
+                   const bool repeated) : _day(day), _month(month), _year(year), _hour(hour), _minute(minute),
+                                          _repeated(repeated) { }
 
 /**
  * @brief Zwraca dzień.
@@ -57,6 +61,50 @@ int DateTime::GetMinute() const {
     return _minute;
 }
 
+/**
+ * @brief Sprawdza, czy jest to drugie wystąpienie godziny powtarzanej przy zmianie czasu.
+ *
+ * @return true dla drugiego wystąpienia, false w przeciwnym razie.
+ */
+bool DateTime::IsRepeated() const {
+    return _repeated;
+}
+
+/**
+ * @brief Sprawdza, czy data istnieje w kalendarzu, a godzina i minuta mieszczą się w dobie.
+ *
+ * @return true dla poprawnej daty i godziny, false w przeciwnym razie.
+ */
+bool DateTime::IsValid() const {
+    // Składowe chrono przechowują tylko mały zakres wartości, więc dzień i miesiąc są najpierw ograniczane.
+    if (_month < 1 || _month > 12 || _day < 1 || _day > 31 || _hour < 0 || _hour > 23 || _minute < 0 || _minute > 59)
+        return false;
+
+    return chrono::year_month_day(chrono::year(_year), chrono::month(_month), chrono::day(_day)).ok();
+}
+
+/**
+ * @brief Zwraca dzień tygodnia (0 - poniedziałek, 6 - niedziela).
+ *
+ * @return Dzień tygodnia.
+ */
+int DateTime::GetDayOfWeek() const {
+    // Algorytm Sakamoto - zwraca 0 dla niedzieli, więc przesuwamy wynik tak, by tydzień zaczynał się w poniedziałek.
+    static constexpr int offsets[] = {0, 3, 2, 5, 0, 3, 5, 1, 4, 6, 2, 4};
+    const int year = _month < 3 ? _year - 1 : _year;
+    const int sundayBased = (year + year / 4 - year / 100 + year / 400 + offsets[(_month - 1) % 12] + _day) % 7;
+    return (sundayBased + 6) % 7;
+}
+
+/**
+ * @brief Sprawdza, czy data jest ostatnią niedzielą października.
+ *
+ * @return true, jeśli jest to dzień zmiany czasu z letniego na zimowy.
+ */
+bool DateTime::IsFallBackDay() const {
+    return _month == 10 && _day > 31 - 7 && GetDayOfWeek() == 6;
+}
+
 /**
  * @brief Zwraca datę i godzinę w formacie string.
  *
@@ -69,4 +117,26 @@ string DateTime::ToString() const {
     // %04d - liczba całkowita z wiodącymi zerami, jeśli jest mniejsza niż 1000 (dla roku).
     snprintf(buffer, sizeof(buffer), "%02d.%02d.%04d %02d:%02d", _day, _month, _year, _hour, _minute);
     return string(buffer); // Zwracamy string utworzony z bufora.
+}
+
+/**
+ * @brief Zwraca spakowany znacznik czasu.
+ *
+ * @return Klucz sortowania zgodny z porządkiem chronologicznym.
+ */
+uint64_t DateTime::GetSortKey() const {
+    return static_cast<uint64_t>(_year) << 21 | static_cast<uint64_t>(_month) << 17 |
+           static_cast<uint64_t>(_day) << 12 | static_cast<uint64_t>(_hour) << 7 |
+           static_cast<uint64_t>(_repeated) << 6 | static_cast<uint64_t>(_minute);
+}
+
+/**
+ * @brief Odtwarza datę i godzinę ze spakowanego znacznika czasu.
+ *
+ * @param key Klucz zwrócony przez GetSortKey.
+ * @return Data i godzina zapisana w kluczu.
+ */
+DateTime DateTime::FromSortKey(const uint64_t key) {
+    return {static_cast<int>(key >> 12 & 0x1F), static_cast<int>(key >> 17 & 0xF), static_cast<int>(key >> 21),
+            static_cast<int>(key >> 7 & 0x1F), static_cast<int>(key & 0x3F), (key >> 6 & 1) != 0};
 }
\ No newline at end of file
@@ -1,28 +1,38 @@
 #include "../Headers/Day.hpp"
 
+#include <stdexcept>
+
 /**
  * @brief Konstruktor klasy Day.
  *
- * Tworzy obiekt reprezentujący dzień i inicjalizuje cztery kwadranse (poranny, południowy, popołudniowy, wieczorny).
+ * Tworzy obiekt reprezentujący dzień i dzieli go na kubełki o zadanej szerokości.
  *
  * @param day Numer dnia (np. 1-31).
+ * @param bucketMinutes Szerokość kubełka w minutach.
  */
-Day::Day(const int day) {
+Day::Day(const int day, const int bucketMinutes) {
+    if (!IsValidBucketMinutes(bucketMinutes))
+        throw invalid_argument("Invalid bucket width: " + to_string(bucketMinutes) + " minutes");
+
     _day = day;
+    _bucketMinutes = bucketMinutes;
+    _aggregate = new Aggregate();
+    _sketch = new QuantileSketch();
 
-    _quarters[0] = new Quarter(0, 5);   // Poranny (00:00 - 05:45)
-    _quarters[1] = new Quarter(6, 11);  // Południowy (06:00 - 11:45)
-    _quarters[2] = new Quarter(12, 17); // Popołudniowy (12:00 - 17:45)
-    _quarters[3] = new Quarter(18, 23); // Wieczorny (18:00 - 23:45)
+    CreateQuarters();
 }
 
 /**
  * @brief Destruktor klasy Day.
  *
- * Zwalnia pamięć zaalokowaną dla czterech obiektów Quarter.
+ * Zwalnia pamięć zaalokowaną dla obiektów Quarter, dla agregatu, dla szkicu oraz dla bloku skompresowanych danych.
  */
 Day::~Day() {
-    for (int i = 0; i < 4; i++) delete _quarters[i];
+    for (const Quarter* quarter : _quarters) delete quarter;
+
+    delete _aggregate;
+    delete _sketch;
+    delete _block;
 }
 
 /**
@@ -35,10 +45,172 @@ int Day::GetDay() const {
 }
 
 /**
- * @brief Zwraca tablicę czterech kwadransów.
+ * @brief Zwraca szerokość kubełka w minutach.
+ *
+ * @return Szerokość kubełka w minutach.
+ */
+int Day::GetBucketMinutes() const {
+    return _bucketMinutes;
+}
+
+/**
+ * @brief Zwraca slot odpowiadający czasowi pomiaru.
+ *
+ * @param time Czas pomiaru.
+ * @return Wskaźnik do slotu lub nullptr, jeśli czas jest niepoprawny.
+ */
+optional<Data>* Day::GetSlot(const Time& time) const {
+    Quarter* quarter = GetQuarter(time);
+
+    return quarter ? quarter->GetSlot(time) : nullptr;
+}
+
+/**
+ * @brief Zwraca kubełek odpowiadający czasowi pomiaru.
+ *
+ * @param time Czas pomiaru.
+ * @return Wskaźnik do kubełka lub nullptr, jeśli czas jest niepoprawny.
+ */
+Quarter* Day::GetQuarter(const Time& time) const {
+    // Drugie wystąpienie godziny powtarzanej przechowuje kubełek zawierający jej ostatnią minutę.
+    const int index = (time.IsRepeated() ? time.GetHour() * 60 + 59 : time.GetMinuteOfDay()) / _bucketMinutes;
+
+    if (time.GetMinute() < 0 || time.GetMinute() > 59 || index < 0 || index >= static_cast<int>(_quarters.size()))
+        return nullptr;
+
+    return _quarters[index];
+}
+
+/**
+ * @brief Zwraca kubełki dnia.
  *
- * @return Tablica wskaźników do obiektów Quarter.
+ * @return Wektor wskaźników do obiektów Quarter.
  */
-array<Quarter*, 4> Day::GetQuarters() const {
+const vector<Quarter*>& Day::GetQuarters() const {
     return _quarters;
+}
+
+/**
+ * @brief Zwraca agregat danych dnia.
+ *
+ * @return Referencja do agregatu.
+ */
+Aggregate& Day::GetAggregate() const {
+    return *_aggregate;
+}
+
+/**
+ * @brief Zwraca szkic rozkładu wartości danych dnia.
+ *
+ * @return Referencja do szkicu.
+ */
+QuantileSketch& Day::GetSketch() const {
+    return *_sketch;
+}
+
+/**
+ * @brief Sprawdza poprawność szerokości kubełka.
+ *
+ * @param bucketMinutes Szerokość kubełka w minutach.
+ * @return true, jeśli szerokość jest poprawna, false w przeciwnym razie.
+ */
+bool Day::IsValidBucketMinutes(const int bucketMinutes) {
+    return bucketMinutes >= Quarter::SlotMinutes && bucketMinutes % Quarter::SlotMinutes == 0 &&
+           24 * 60 % bucketMinutes == 0;
+}
+
+/**
+ * @brief Kompresuje dane dnia.
+ *
+ * Rekordy są zbierane z kubełków w porządku chronologicznym i zapisywane w jednym bloku.
+ */
+void Day::Compress() {
+    if (_block != nullptr) return;
+
+    vector<Data> data;
+    data.reserve(_aggregate->GetCount());
+
+    for (const Quarter* quarter : _quarters)
+        for (const optional<Data>& slot : quarter->GetData())
+            if (slot.has_value()) data.push_back(*slot);
+
+    _block = new CompressedBlock(data);
+
+    for (const Quarter* quarter : _quarters) delete quarter;
+
+    _quarters.clear();
+    _quarters.shrink_to_fit();
+}
+
+/**
+ * @brief Rozpakowuje dane dnia z powrotem do kubełków.
+ *
+ * Agregat dnia nie zmienia się; agregaty kubełków są odtwarzane z rozpakowanych rekordów.
+ */
+void Day::Decompress() {
+    if (_block == nullptr) return;
+
+    CreateQuarters();
+
+    for (const Data& data : _block->Decode()) {
+        Quarter* quarter = GetQuarter(data.GetTime());
+
+        quarter->GetSlot(data.GetTime())->emplace(data);
+        quarter->GetAggregate().Add(data);
+    }
+
+    delete _block;
+    _block = nullptr;
+}
+
+/**
+ * @brief Sprawdza, czy dane dnia są skompresowane.
+ *
+ * @return true, jeśli dzień jest skompresowany, false w przeciwnym razie.
+ */
+bool Day::IsCompressed() const {
+    return _block != nullptr;
+}
+
+/**
+ * @brief Zwraca blok skompresowanych danych dnia.
+ *
+ * @return Wskaźnik do bloku lub nullptr.
+ */
+const CompressedBlock* Day::GetBlock() const {
+    return _block;
+}
+
+/**
+ * @brief Zaznacza w mapie obecności slot odczytu o podanym czasie.
+ *
+ * @param time Czas odczytu.
+ */
+void Day::MarkPresent(const Time& time) {
+    if (time.IsRepeated() || time.GetMinute() < 0 || time.GetMinute() > 59) return;
+
+    const int slot = time.GetMinuteOfDay() / Quarter::SlotMinutes;
+
+    if (slot < 0 || slot >= SlotsPerDay) return;
+
+    _presence[slot / 64] |= uint64_t{1} << (slot % 64);
+}
+
+/**
+ * @brief Zwraca słowo mapy obecności.
+ *
+ * @param index Numer słowa.
+ * @return Bity obecności slotów.
+ */
+uint64_t Day::GetPresenceWord(const int index) const {
+    return _presence[index];
+}
+
+/**
+ * @brief Tworzy puste kubełki dnia.
+ */
+void Day::CreateQuarters() {
+    _quarters.reserve(24 * 60 / _bucketMinutes);
+    for (int start = 0; start < 24 * 60; start += _bucketMinutes)
+        _quarters.push_back(new Quarter(start, _bucketMinutes));
 }
\ No newline at end of file
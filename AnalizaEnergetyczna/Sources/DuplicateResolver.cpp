@@ -0,0 +1,88 @@
+#include "../Headers/DuplicateResolver.hpp"
+
+/**
+ * @brief Konstruktor klasy DuplicateResolver.
+ *
+ * @param policy Sposób rozstrzygania duplikatów.
+ * @param consumer Odbiorca rekordów wynikowych.
+ */
+DuplicateResolver::DuplicateResolver(const DuplicatePolicy policy, function<void(EnergyData &&, int)> consumer)
+    : _policy(policy), _consumer(std::move(consumer)) {
+}
+
+/**
+ * @brief Przetwarza kolejny rekord strumienia.
+ *
+ * @param record Rekord do przetworzenia.
+ */
+void DuplicateResolver::Push(EnergyData &&record) {
+    if (_pending.has_value() && _pending->GetDateTime().GetSortKey() == record.GetDateTime().GetSortKey()) {
+        _pending = Merge(_policy, *_pending, _pendingSamples, record, 1);
+        ++_pendingSamples;
+        ++_duplicateCount;
+        return;
+    }
+
+    Flush();
+
+    _pending.emplace(std::move(record));
+    _pendingSamples = 1;
+}
+
+/**
+ * @brief Przekazuje odbiorcy oczekujący rekord.
+ */
+void DuplicateResolver::Flush() {
+    if (!_pending.has_value()) return;
+
+    _consumer(std::move(*_pending), _pendingSamples);
+    _pending.reset();
+    _pendingSamples = 0;
+}
+
+/**
+ * @brief Zwraca liczbę wykrytych duplikatów.
+ *
+ * @return Liczba duplikatów.
+ */
+size_t DuplicateResolver::GetDuplicateCount() const {
+    return _duplicateCount;
+}
+
+/**
+ * @brief Łączy dwa odczyty o tym samym znaczniku czasu.
+ *
+ * Dla średniej każdy z odczytów ma wagę równą liczbie odczytów, z których powstał.
+ *
+ * @param policy Sposób rozstrzygania duplikatów.
+ * @param existing Odczyt wcześniejszy.
+ * @param existingSamples Liczba odczytów, z których powstał odczyt wcześniejszy.
+ * @param incoming Odczyt późniejszy.
+ * @param incomingSamples Liczba odczytów, z których powstał odczyt późniejszy.
+ * @return Odczyt wynikowy.
+ */
+EnergyData DuplicateResolver::Merge(const DuplicatePolicy policy, const EnergyData &existing,
+                                    const int existingSamples, const EnergyData &incoming,
+                                    const int incomingSamples) {
+    switch (policy) {
+        case DuplicatePolicy::KeepFirst:
+            return existing;
+        case DuplicatePolicy::KeepLast:
+            return incoming;
+        case DuplicatePolicy::Average:
+        default:
+            break;
+    }
+
+    const double total = existingSamples + incomingSamples;
+    const auto average = [&](const double a, const double b) {
+        return (a * existingSamples + b * incomingSamples) / total;
+    };
+
+    return {existing.GetDateTime(),
+            average(existing.GetAutoConsumption(), incoming.GetAutoConsumption()),
+            average(existing.GetExport(), incoming.GetExport()),
+            average(existing.GetImport(), incoming.GetImport()),
+            average(existing.GetConsumption(), incoming.GetConsumption()),
+            average(existing.GetGeneration(), incoming.GetGeneration())};
+}
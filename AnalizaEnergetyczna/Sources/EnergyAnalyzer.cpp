@@ -1,21 +1,100 @@
 #include "../Headers/EnergyAnalyzer.hpp"
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+#include "../Headers/CompressedInput.hpp"
+#include "../Headers/EnergyDataMerger.hpp"
+#include "../Headers/Snapshot.hpp"
+
+/**
+ * @brief Konstruktor klasy EnergyAnalyzer.
+ *
+ * Tworzy pustą strukturę danych.
+ *
+ * @param bucketMinutes Szerokość kubełka dnia w minutach.
+ * @param duplicatePolicy Sposób rozstrzygania odczytów o tym samym znaczniku czasu.
+ */
+EnergyAnalyzer::EnergyAnalyzer(const int bucketMinutes, const DuplicatePolicy duplicatePolicy)
+    : _bucketMinutes(bucketMinutes), _duplicatePolicy(duplicatePolicy) {
+    if (!Day::IsValidBucketMinutes(bucketMinutes))
+        throw invalid_argument("Invalid bucket width: " + to_string(bucketMinutes) + " minutes");
+
+    _years = new vector<Year *>();
+    _commandParser = new CommandParser(*this);
+}
 
 /**
  * @brief Konstruktor klasy EnergyAnalyzer.
  * 
- * Wczytuje dane z pliku i tworzy strukturę danych (lata, miesiące, dni, kwadranse, dane).
+ * Wczytuje dane z pliku i w jednym przebiegu tworzy strukturę danych (lata, miesiące, dni,
+ * kubełki, dane). Każdy sparsowany rekord trafia od razu do właściwego kubełka, więc
+ * w pamięci nigdy nie istnieją jednocześnie dwie kopie odczytów.
+ *
+ * Podczas wczytywania sprawdzane jest, czy rekordy przychodzą w porządku chronologicznym.
+ * Rekordy wcześniejsze niż najpóźniejszy dotąd wczytany (np. z połączonych eksportów) są
+ * odkładane na bok, porządkowane sortowaniem pozycyjnym i wstawiane na końcu wczytywania.
+ * Dla uporządkowanego pliku ten etap nic nie kosztuje.
+ *
+ * Oba uporządkowane strumienie przechodzą przez etap usuwania duplikatów (`DuplicateResolver`),
+ * który rozstrzyga powtórzone znaczniki czasu zgodnie z `duplicatePolicy`. Odczyty z godziny
+ * powtarzanej przy zmianie czasu są oznaczane już przy parsowaniu, więc nie są duplikatami.
+ *
+ * Przy włączonym przepróbkowaniu (`resampleGapSlots`) oba strumienie przechodzą zamiast tego przez
+ * `GridResampler`: odczyty o dowolnej kadencji są uśredniane w 15-minutowych slotach, a krótkie
+ * luki w strumieniu uporządkowanym - interpolowane. Do struktury danych trafia wtedy co najwyżej
+ * jeden rekord na slot, ze znacznikiem czasu początku slotu.
  * 
- * @param filepath Ścieżka do pliku z danymi.
+ * Zamiast pliku można podać katalog lub wzorzec nazw plików (patrz `EnergyDataMerger`) - pliki są
+ * wtedy wczytywane równolegle, a ich rekordy scalane w jeden uporządkowany strumień.
+ *
+ * @param filepath Ścieżka do pliku z danymi, katalogu lub wzorca nazw plików.
+ * @param bucketMinutes Szerokość kubełka dnia w minutach.
+ * @param duplicatePolicy Sposób rozstrzygania odczytów o tym samym znaczniku czasu.
+ * @param columns Kolumny wartości wczytywane z pliku.
+ * @param rejectedRules Reguły poprawności, których naruszenie odrzuca rekord z pliku.
+ * @param resampleGapSlots Największa liczba pustych slotów wypełnianych interpolacją (`NoResampling` - bez przepróbkowania).
  */
-EnergyAnalyzer::EnergyAnalyzer(const string &filepath) {
-    const vector<EnergyData *> *energyData = EnergyData::ReadEnergyData(filepath);
+EnergyAnalyzer::EnergyAnalyzer(const string &filepath, const int bucketMinutes,
+                               const DuplicatePolicy duplicatePolicy, const ColumnSet columns,
+                               const RuleSet rejectedRules, const int resampleGapSlots)
+    : EnergyAnalyzer(bucketMinutes, duplicatePolicy) {
+    if (resampleGapSlots < NoResampling)
+        throw invalid_argument("Invalid interpolation gap: " + to_string(resampleGapSlots) + " slots");
+
+    _columns = columns;
+    _validator.SetRejectedRules(rejectedRules);
+    _resampleGapSlots = resampleGapSlots;
+
+    // Katalog lub wzorzec - pliki są wczytywane równolegle i scalane w jeden uporządkowany strumień.
+    if (EnergyDataMerger::IsMultiFilePath(filepath)) {
+        const vector<string> files = EnergyDataMerger::ResolveFiles(filepath);
+
+        Load([&](const function<void(EnergyData &&)> &consumer) {
+            EnergyDataMerger::ReadEnergyData(files, consumer, columns);
+            return streamoff(0);
+        });
+
+        return;
+    }
 
-    _commandParser = new CommandParser(*this);
+    // Pliku skompresowanego nie da się śledzić - dopisywane są do niego całe człony, nie linie.
+    if (CompressedInput::DetectFormat(filepath) == CompressedInput::Format::None) _filepath = filepath;
 
-    _years = createYears(energyData);
+    _fileOffset = Load([&](const function<void(EnergyData &&)> &consumer) {
+        return EnergyData::ReadEnergyData(filepath, consumer, columns);
+    });
 }
 
 /**
@@ -24,650 +103,581 @@ EnergyAnalyzer::EnergyAnalyzer(const string &filepath) {
  * Zwalnia pamięć zaalokowaną dla struktury danych.
  */
 EnergyAnalyzer::~EnergyAnalyzer() {
+    StopFollowing();
+
+    if (_compactionThread.joinable()) _compactionThread.join();
+    _writeAheadLog.reset();
+
     for (const Year *year: *_years) delete year;
 
     delete _years;
     delete _commandParser;
 }
 
+thread_local vector<const EnergyAnalyzer *> EnergyAnalyzer::ReadLock::_held;
+
 /**
- * @brief Oblicza sumę autokonsumpcji w zadanym przedziale czasowym.
+ * @brief Zajmuje współdzielnie blokadę analizatora, jeśli bieżący wątek jeszcze jej nie trzyma.
  *
- * @param start Data i godzina początku przedziału.
- * @param end Data i godzina końca przedziału.
- * @return Suma autokonsumpcji w przedziale [kWh].
+ * @param analyzer Analizator, którego strukturę danych czyta zapytanie.
  */
-long double EnergyAnalyzer::CalculateAutoConsumptionSumInRange(const DateTime *start, const DateTime *end) const {
-    long double sum = 0;
-
-    for (const Year *year: *_years) {
-        if (year->GetYear() < start->GetYear() || year->GetYear() > end->GetYear()) continue;
+EnergyAnalyzer::ReadLock::ReadLock(const EnergyAnalyzer &analyzer) : _analyzer(&analyzer) {
+    if (ranges::find(_held, _analyzer) != _held.end()) return;
 
-        for (const Month *month: year->GetMonths()) {
-            if (year->GetYear() == start->GetYear() && month->GetMonth() < start->GetMonth()) continue;
-            if (year->GetYear() == end->GetYear() && month->GetMonth() > end->GetMonth()) continue;
-
-            for (const Day *day: month->GetDays()) {
-                if (year->GetYear() == start->GetYear() && month->GetMonth() == start->GetMonth() && day->GetDay() <
-                    start->GetDay())
-                    continue;
-                if (year->GetYear() == end->GetYear() && month->GetMonth() == end->GetMonth() && day->GetDay() > end->
-                    GetDay())
-                    continue;
+    _lock = shared_lock(analyzer._mutex);
+    _held.push_back(_analyzer);
+}
 
-                for (const Quarter *quoter: day->GetQuarters()) {
-                    for (const auto &data: quoter->GetData()) {
-                        if (data->GetTime().GetHour() < start->GetHour() || data->GetTime().GetHour() > end->GetHour())
-                            continue;
-                        if (data->GetTime().GetMinute() < start->GetMinute() || data->GetTime().GetMinute() > end->
-                            GetMinute())
-                            continue;
+/**
+ * @brief Zwalnia blokadę, jeśli została zajęta przez ten obiekt.
+ */
+EnergyAnalyzer::ReadLock::~ReadLock() {
+    if (_lock.owns_lock()) _held.erase(ranges::find(_held, _analyzer));
+}
 
-                        sum += data->GetAutoConsumption();
-                    }
-                }
-            }
-        }
-    }
+/**
+ * @brief Zwraca liczbę odrzuconych odczytów spoza siatki slotów.
+ *
+ * @return Liczba odrzuconych odczytów.
+ */
+size_t EnergyAnalyzer::GetOffGridCount() const {
+    const ReadLock lock(*this);
 
-    return sum;
+    return _offGridCount;
 }
 
 /**
- * @brief Oblicza sumę eksportu energii w zadanym przedziale czasowym.
+ * @brief Wstawia rekordy wczytywane z pliku CSV.
  *
- * @param start Data i godzina początku przedziału.
- * @param end Data i godzina końca przedziału.
- * @return Suma eksportu w przedziale [kWh].
+ * @param read Funkcja wczytująca rekordy i przekazująca je do podanego odbiorcy.
+ * @return Wynik funkcji `read`.
  */
-long double EnergyAnalyzer::CalculateEksportSumInRange(const DateTime *start, const DateTime *end) const {
-    long double sum = 0;
+streamoff EnergyAnalyzer::Load(const function<streamoff(const function<void(EnergyData &&)> &)> &read) {
+    const auto insert = [this](EnergyData &&record, const int samples) {
+        InsertData(record, _duplicatePolicy, samples);
+    };
 
-    for (const Year *year: *_years) {
-        if (year->GetYear() < start->GetYear() || year->GetYear() > end->GetYear()) continue;
+    uint64_t lastKey = 0;
+    vector<EnergyData> batch, outOfOrder;
+    DuplicateResolver inOrder(_duplicatePolicy, insert);
+    optional<GridResampler> resampler;
 
-        for (const Month *month: year->GetMonths()) {
-            if (year->GetYear() == start->GetYear() && month->GetMonth() < start->GetMonth()) continue;
-            if (year->GetYear() == end->GetYear() && month->GetMonth() > end->GetMonth()) continue;
+    if (_resampleGapSlots != NoResampling) resampler.emplace(_resampleGapSlots, insert);
 
-            for (const Day *day: month->GetDays()) {
-                if (year->GetYear() == start->GetYear() && month->GetMonth() == start->GetMonth() && day->GetDay() <
-                    start->GetDay())
-                    continue;
-                if (year->GetYear() == end->GetYear() && month->GetMonth() == end->GetMonth() && day->GetDay() > end->
-                    GetDay())
-                    continue;
+    batch.reserve(DataValidator::BatchSize);
 
-                for (const Quarter *quoter: day->GetQuarters()) {
-                    for (const auto &data: quoter->GetData()) {
-                        if (data->GetTime().GetHour() < start->GetHour() || data->GetTime().GetHour() > end->GetHour())
-                            continue;
-                        if (data->GetTime().GetMinute() < start->GetMinute() || data->GetTime().GetMinute() > end->
-                            GetMinute())
-                            continue;
+    const auto validate = [&] {
+        _validator.Validate(batch);
 
-                        sum += data->GetExport();
-                    }
-                }
+        for (EnergyData &record: batch) {
+            const uint64_t key = record.GetDateTime().GetSortKey();
+
+            if (key < lastKey) {
+                outOfOrder.push_back(std::move(record));
+                continue;
             }
+
+            lastKey = key;
+
+            if (resampler) resampler->Push(std::move(record));
+            else inOrder.Push(std::move(record));
         }
+
+        batch.clear();
+    };
+
+    const streamoff offset = read([&](EnergyData &&record) {
+        // Także odrzucony rekord jest potrzebny do rozpoznania godziny powtarzanej w dopisywanych liniach.
+        _lastRead = record.GetDateTime();
+
+        batch.push_back(std::move(record));
+
+        if (batch.size() == DataValidator::BatchSize) validate();
+    });
+
+    validate();
+    inOrder.Flush();
+
+    if (resampler) {
+        resampler->Flush();
+
+        // Spóźnione odczyty są tylko uśredniane - luki między nimi leżą zwykle w danych już wstawionych.
+        EnergyDataSorter::SortByDateTime(outOfOrder);
+
+        GridResampler late(0, insert);
+
+        for (EnergyData &record: outOfOrder) late.Push(std::move(record));
+
+        late.Flush();
+    } else if (!outOfOrder.empty()) {
+        InsertAll(outOfOrder, _duplicatePolicy);
     }
 
-    return sum;
+    return offset;
 }
 
 /**
- * @brief Oblicza sumę importu energii w zadanym przedziale czasowym.
+ * @brief Zwraca etap sprawdzania poprawności rekordów wczytywanych z pliku.
  *
- * @param start Data i godzina początku przedziału.
- * @param end Data i godzina końca przedziału.
- * @return Suma importu w przedziale [kWh].
+ * @return Referencja do etapu sprawdzania poprawności.
  */
-long double EnergyAnalyzer::CalculateImportSumInRange(const DateTime *start, const DateTime *end) const {
-    long double sum = 0;
+const DataValidator &EnergyAnalyzer::GetValidator() const {
+    return _validator;
+}
 
-    for (const Year *year: *_years) {
-        if (year->GetYear() < start->GetYear() || year->GetYear() > end->GetYear()) continue;
+/**
+ * @brief Zwija kostkę agregatów wszystkich odczytów.
+ *
+ * @param by Wymiar, według którego łączone są komórki.
+ * @param filter Ograniczenia pozostałych wymiarów.
+ * @return Agregaty kolejnych wartości wymiaru.
+ */
+map<int, Aggregate> EnergyAnalyzer::RollUpCube(const AggregateCube::Dimension by,
+                                               const AggregateCube::Filter &filter) const {
+    const ReadLock lock(*this);
 
-        for (const Month *month: year->GetMonths()) {
-            if (year->GetYear() == start->GetYear() && month->GetMonth() < start->GetMonth()) continue;
-            if (year->GetYear() == end->GetYear() && month->GetMonth() > end->GetMonth()) continue;
+    return _cube.RollUp(by, filter);
+}
 
-            for (const Day *day: month->GetDays()) {
-                if (year->GetYear() == start->GetYear() && month->GetMonth() == start->GetMonth() && day->GetDay() <
-                    start->GetDay())
-                    continue;
-                if (year->GetYear() == end->GetYear() && month->GetMonth() == end->GetMonth() && day->GetDay() > end->
-                    GetDay())
-                    continue;
+/**
+ * @brief Dopisuje nowe rekordy do struktury danych.
+ *
+ * Kolizje z istniejącymi odczytami rozstrzygane są zgodnie z polityką duplikatów analizatora.
+ * Przy włączonym trwałym zapisie metoda wraca dopiero po utrwaleniu partii w dzienniku.
+ *
+ * @param records Rekordy do dopisania.
+ * @return Liczba rekordów, które zostały dodane lub zmieniły istniejący odczyt.
+ * @throws invalid_argument Jeśli któryś rekord ma niepoprawną datę lub godzinę (partia nie jest wtedy wstawiana).
+ */
+size_t EnergyAnalyzer::Append(vector<EnergyData> records) {
+    CheckTimestamps(records);
 
-                for (const Quarter *quoter: day->GetQuarters()) {
-                    for (const auto &data: quoter->GetData()) {
-                        if (data->GetTime().GetHour() < start->GetHour() || data->GetTime().GetHour() > end->GetHour())
-                            continue;
-                        if (data->GetTime().GetMinute() < start->GetMinute() || data->GetTime().GetMinute() > end->
-                            GetMinute())
-                            continue;
+    return Commit(WriteAheadLog::Operation::Append, records);
+}
 
-                        sum += data->GetImport();
-                    }
-                }
-            }
-        }
-    }
+/**
+ * @brief Wstawia rekordy, zastępując istniejące odczyty o tych samych znacznikach czasu.
+ *
+ * @param records Rekordy do wstawienia.
+ * @return Liczba rekordów, które zostały dodane lub zmieniły istniejący odczyt.
+ * @throws invalid_argument Jeśli któryś rekord ma niepoprawną datę lub godzinę (partia nie jest wtedy wstawiana).
+ */
+size_t EnergyAnalyzer::Upsert(vector<EnergyData> records) {
+    CheckTimestamps(records);
 
-    return sum;
+    return Commit(WriteAheadLog::Operation::Upsert, records);
 }
 
 /**
- * @brief Oblicza sumę zużycia energii w zadanym przedziale czasowym.
+ * @brief Sprawdza, czy wszystkie rekordy partii mają poprawne daty i godziny.
  *
- * @param start Data i godzina początku przedziału.
- * @param end Data i godzina końca przedziału.
- * @return Suma zużycia w przedziale [kWh].
+ * @param records Rekordy partii.
+ * @throws invalid_argument Jeśli któryś rekord ma niepoprawną datę lub godzinę.
  */
-long double EnergyAnalyzer::CalculateConsumptionSumInRange(const DateTime *start, const DateTime *end) const {
-    long double sum = 0;
+void EnergyAnalyzer::CheckTimestamps(const vector<EnergyData> &records) {
+    for (const EnergyData &record: records)
+        if (!record.GetDateTime().IsValid())
+            throw invalid_argument("Invalid timestamp: " + record.GetDateTime().ToString());
+}
 
-    for (const Year *year: *_years) {
-        if (year->GetYear() < start->GetYear() || year->GetYear() > end->GetYear()) continue;
+/**
+ * @brief Zapisuje partię rekordów w dzienniku i wstawia ją do struktury danych.
+ *
+ * Wpis trafia do dziennika i do struktury danych pod tą samą blokadą, więc kolejność wpisów
+ * w dzienniku jest kolejnością ich zastosowania (odtworzenie daje ten sam stan). Na utrwalenie
+ * wpisu metoda czeka już po zwolnieniu blokady - partie zgłoszone w tym czasie przez inne
+ * wątki są zapisywane razem z nią, jednym wywołaniem fsync.
+ *
+ * @param operation Rodzaj operacji.
+ * @param records Rekordy do wstawienia.
+ * @return Liczba rekordów, które zostały dodane lub zmieniły istniejący odczyt.
+ */
+size_t EnergyAnalyzer::Commit(const WriteAheadLog::Operation operation, vector<EnergyData> &records) {
+    shared_ptr<WriteAheadLog> writeAheadLog;
+    uint64_t sequence = 0;
+    size_t changed;
 
-        for (const Month *month: year->GetMonths()) {
-            if (year->GetYear() == start->GetYear() && month->GetMonth() < start->GetMonth()) continue;
-            if (year->GetYear() == end->GetYear() && month->GetMonth() > end->GetMonth()) continue;
+    {
+        unique_lock lock(_mutex);
 
-            for (const Day *day: month->GetDays()) {
-                if (year->GetYear() == start->GetYear() && month->GetMonth() == start->GetMonth() && day->GetDay() <
-                    start->GetDay())
-                    continue;
-                if (year->GetYear() == end->GetYear() && month->GetMonth() == end->GetMonth() && day->GetDay() > end->
-                    GetDay())
-                    continue;
+        if (_writeAheadLog) {
+            writeAheadLog = _writeAheadLog;
+            sequence = writeAheadLog->Enqueue(operation, records);
+        }
 
-                for (const Quarter *quoter: day->GetQuarters()) {
-                    for (const auto &data: quoter->GetData()) {
-                        if (data->GetTime().GetHour() < start->GetHour() || data->GetTime().GetHour() > end->GetHour())
-                            continue;
-                        if (data->GetTime().GetMinute() < start->GetMinute() || data->GetTime().GetMinute() > end->
-                            GetMinute())
-                            continue;
+        changed = InsertAll(records, operation == WriteAheadLog::Operation::Upsert
+                                         ? DuplicatePolicy::KeepLast
+                                         : _duplicatePolicy);
 
-                        sum += data->GetConsumption();
-                    }
-                }
-            }
-        }
+        if (writeAheadLog && writeAheadLog->GetSize() >= _compactionBytes && !_compacting) StartCompaction();
     }
 
-    return sum;
+    if (writeAheadLog) writeAheadLog->WaitDurable(sequence);
+
+    return changed;
 }
 
 /**
- * @brief Oblicza sumę produkcji energii w zadanym przedziale czasowym.
+ * @brief Włącza trwały zapis danych dopisywanych w trakcie działania programu.
  *
- * @param start Data i godzina początku przedziału.
- * @param end Data i godzina końca przedziału.
- * @return Suma produkcji w przedziale [kWh].
+ * Pliki dziennika mają nazwy `wal_<pokolenie>.log`, a migawka - `snapshot.bin`. Odtwarzane są
+ * tylko pliki dziennika o pokoleniach nowszych niż zapisane w migawce; starsze (pozostałe po
+ * przerwanym sprzątaniu) są usuwane. Nowe wpisy trafiają zawsze do nowego pliku dziennika.
+ *
+ * @param directory Katalog na migawkę i pliki dziennika.
+ * @param compactionBytes Rozmiar dziennika, po którego przekroczeniu tworzona jest migawka.
+ * @throws logic_error Jeśli trwały zapis jest już włączony lub nie wczytano wszystkich kolumn.
+ * @throws runtime_error Jeśli migawka jest uszkodzona lub nie można utworzyć dziennika.
  */
-long double EnergyAnalyzer::CalculateGenerationSumInRange(const DateTime *start, const DateTime *end) const {
-    long double sum = 0;
+void EnergyAnalyzer::OpenStorage(const string &directory, const uintmax_t compactionBytes) {
+    unique_lock lock(_mutex);
 
-    for (const Year *year: *_years) {
-        if (year->GetYear() < start->GetYear() || year->GetYear() > end->GetYear()) continue;
+    if (_writeAheadLog) throw logic_error("Storage is already open");
 
-        for (const Month *month: year->GetMonths()) {
-            if (year->GetYear() == start->GetYear() && month->GetMonth() < start->GetMonth()) continue;
-            if (year->GetYear() == end->GetYear() && month->GetMonth() > end->GetMonth()) continue;
+    // Niewczytane kolumny mają wartość NaN - zapisane w migawce lub dzienniku zastąpiłyby
+    // przy odtwarzaniu poprawne wartości z pliku CSV.
+    if (_columns != AllColumns) throw logic_error("Storage requires all columns to be loaded");
 
-            for (const Day *day: month->GetDays()) {
-                if (year->GetYear() == start->GetYear() && month->GetMonth() == start->GetMonth() && day->GetDay() <
-                    start->GetDay())
-                    continue;
-                if (year->GetYear() == end->GetYear() && month->GetMonth() == end->GetMonth() && day->GetDay() > end->
-                    GetDay())
-                    continue;
+    filesystem::create_directories(directory);
 
-                for (const Quarter *quoter: day->GetQuarters()) {
-                    for (const auto &data: quoter->GetData()) {
-                        if (data->GetTime().GetHour() < start->GetHour() || data->GetTime().GetHour() > end->GetHour())
-                            continue;
-                        if (data->GetTime().GetMinute() < start->GetMinute() || data->GetTime().GetMinute() > end->
-                            GetMinute())
-                            continue;
+    _storageDirectory = directory;
+    _compactionBytes = compactionBytes;
 
-                        sum += data->GetGeneration();
-                    }
-                }
-            }
-        }
+    uint64_t snapshotGeneration = 0;
+
+    if (const filesystem::path snapshotPath = filesystem::path(directory) / "snapshot.bin"; exists(snapshotPath)) {
+        snapshotGeneration = Snapshot::Read(snapshotPath.string(), [this](vector<EnergyData> &&records) {
+            InsertAll(records, DuplicatePolicy::KeepLast);
+        });
     }
 
-    return sum;
-}
+    vector<uint64_t> generations;
 
-/**
- * @brief Oblicza średnią autokonsumpcji w zadanym przedziale czasowym.
- *
- * @param start Data i godzina początku przedziału.
- * @param end Data i godzina końca przedziału.
- * @return Średnia autokonsumpcja w przedziale [kWh].
- */
-long double EnergyAnalyzer::CalculateAutoConsumptionAvgInRange(const DateTime *start, const DateTime *end) const {
-    long double sum = 0;
-    int count = 0;
+    for (const filesystem::directory_entry &entry: filesystem::directory_iterator(directory)) {
+        const string name = entry.path().filename().string();
 
-    for (const Year *year: *_years) {
-        if (year->GetYear() < start->GetYear() || year->GetYear() > end->GetYear()) continue;
+        if (name.size() <= 8 || !name.starts_with("wal_") || !name.ends_with(".log")) continue;
 
-        for (const Month *month: year->GetMonths()) {
-            if (year->GetYear() == start->GetYear() && month->GetMonth() < start->GetMonth()) continue;
-            if (year->GetYear() == end->GetYear() && month->GetMonth() > end->GetMonth()) continue;
+        try {
+            generations.push_back(stoull(name.substr(4, name.size() - 8)));
+        } catch (exception &) {
+            // Plik o nazwie niepasującej do schematu nie należy do dziennika.
+        }
+    }
 
-            for (const Day *day: month->GetDays()) {
-                if (year->GetYear() == start->GetYear() && month->GetMonth() == start->GetMonth() && day->GetDay() <
-                    start->GetDay())
-                    continue;
-                if (year->GetYear() == end->GetYear() && month->GetMonth() == end->GetMonth() && day->GetDay() > end->
-                    GetDay())
-                    continue;
+    ranges::sort(generations);
 
-                for (const Quarter *quoter: day->GetQuarters()) {
-                    for (const auto &data: quoter->GetData()) {
-                        if (data->GetTime().GetHour() < start->GetHour() || data->GetTime().GetHour() > end->GetHour())
-                            continue;
-                        if (data->GetTime().GetMinute() < start->GetMinute() || data->GetTime().GetMinute() > end->
-                            GetMinute())
-                            continue;
+    uintmax_t replayedBytes = 0;
+    _walGeneration = snapshotGeneration;
 
-                        sum += data->GetAutoConsumption();
-                        ++count;
-                    }
-                }
-            }
+    for (const uint64_t generation: generations) {
+        if (generation <= snapshotGeneration) {
+            filesystem::remove(GetWalPath(generation));
+            continue;
         }
+
+        WriteAheadLog::Replay(GetWalPath(generation), [this](const WriteAheadLog::Operation operation,
+                                                              vector<EnergyData> &&records) {
+            InsertAll(records, operation == WriteAheadLog::Operation::Upsert
+                                   ? DuplicatePolicy::KeepLast
+                                   : _duplicatePolicy);
+        });
+
+        // Pusty plik (np. po uruchomieniu bez nowych danych) nie jest potrzebny.
+        if (const uintmax_t size = filesystem::file_size(GetWalPath(generation)); size == 0)
+            filesystem::remove(GetWalPath(generation));
+        else
+            replayedBytes += size;
+
+        _walGeneration = generation;
     }
 
-    return count == 0 ? 0 : sum / count;
+    _writeAheadLog = make_shared<WriteAheadLog>(GetWalPath(++_walGeneration));
+
+    if (replayedBytes >= _compactionBytes) StartCompaction();
 }
 
 /**
- * @brief Oblicza średni eksport energii w zadanym przedziale czasowym.
+ * @brief Rozpoczyna nowy plik dziennika i zapisuje w tle migawkę obejmującą poprzednie.
  *
- * @param start Data i godzina początku przedziału.
- * @param end Data i godzina końca przedziału.
- * @return Średni eksport w przedziale [kWh].
+ * Pod blokadą wykonywane jest tylko przełączenie dziennika i skopiowanie rekordów w pamięci;
+ * zapis migawki na dysk i usunięcie objętych nią plików dziennika odbywa się w osobnym wątku.
+ * Jeśli zapis migawki się nie powiedzie, pliki dziennika zostają na miejscu i dane są
+ * odtwarzane z nich przy kolejnym uruchomieniu.
  */
-long double EnergyAnalyzer::CalculateEksportAvgInRange(const DateTime *start, const DateTime *end) const {
-    long double sum = 0;
-    int count = 0;
+void EnergyAnalyzer::StartCompaction() {
+    if (_compactionThread.joinable()) _compactionThread.join();
 
-    for (const Year *year: *_years) {
-        if (year->GetYear() < start->GetYear() || year->GetYear() > end->GetYear()) continue;
+    _compacting = true;
 
-        for (const Month *month: year->GetMonths()) {
-            if (year->GetYear() == start->GetYear() && month->GetMonth() < start->GetMonth()) continue;
-            if (year->GetYear() == end->GetYear() && month->GetMonth() > end->GetMonth()) continue;
+    const uint64_t coveredGeneration = _walGeneration;
+    shared_ptr<WriteAheadLog> previous = std::move(_writeAheadLog);
 
-            for (const Day *day: month->GetDays()) {
-                if (year->GetYear() == start->GetYear() && month->GetMonth() == start->GetMonth() && day->GetDay() <
-                    start->GetDay())
-                    continue;
-                if (year->GetYear() == end->GetYear() && month->GetMonth() == end->GetMonth() && day->GetDay() > end->
-                    GetDay())
-                    continue;
+    _writeAheadLog = make_shared<WriteAheadLog>(GetWalPath(++_walGeneration));
 
-                for (const Quarter *quoter: day->GetQuarters()) {
-                    for (const auto &data: quoter->GetData()) {
-                        if (data->GetTime().GetHour() < start->GetHour() || data->GetTime().GetHour() > end->GetHour())
-                            continue;
-                        if (data->GetTime().GetMinute() < start->GetMinute() || data->GetTime().GetMinute() > end->
-                            GetMinute())
-                            continue;
+    _compactionThread = jthread([this, coveredGeneration, previous = std::move(previous), records = CollectAllData()] {
+        try {
+            previous->Flush();
 
-                        sum += data->GetExport();
-                        ++count;
-                    }
-                }
+            Snapshot::Write((filesystem::path(_storageDirectory) / "snapshot.bin").string(), coveredGeneration, records);
+
+            for (const filesystem::directory_entry &entry: filesystem::directory_iterator(_storageDirectory)) {
+                const string name = entry.path().filename().string();
+
+                if (name.size() <= 8 || !name.starts_with("wal_") || !name.ends_with(".log")) continue;
+
+                if (error_code error; stoull(name.substr(4, name.size() - 8)) <= coveredGeneration)
+                    filesystem::remove(entry.path(), error);
             }
+        } catch (exception &e) {
+            cerr << "Snapshot failed: " << e.what() << endl;
         }
-    }
 
-    return count == 0 ? 0 : sum / count;
+        _compacting = false;
+    });
 }
 
 /**
- * @brief Oblicza średni import energii w zadanym przedziale czasowym.
+ * @brief Zwraca kopię wszystkich rekordów.
  *
- * @param start Data i godzina początku przedziału.
- * @param end Data i godzina końca przedziału.
- * @return Średni import w przedziale [kWh].
+ * @return Wektor rekordów w porządku chronologicznym.
  */
-long double EnergyAnalyzer::CalculateImportAvgInRange(const DateTime *start, const DateTime *end) const {
-    long double sum = 0;
-    int count = 0;
+vector<EnergyData> EnergyAnalyzer::CollectAllData() const {
+    vector<EnergyData> records;
 
     for (const Year *year: *_years) {
-        if (year->GetYear() < start->GetYear() || year->GetYear() > end->GetYear()) continue;
-
         for (const Month *month: year->GetMonths()) {
-            if (year->GetYear() == start->GetYear() && month->GetMonth() < start->GetMonth()) continue;
-            if (year->GetYear() == end->GetYear() && month->GetMonth() > end->GetMonth()) continue;
-
             for (const Day *day: month->GetDays()) {
-                if (year->GetYear() == start->GetYear() && month->GetMonth() == start->GetMonth() && day->GetDay() <
-                    start->GetDay())
-                    continue;
-                if (year->GetYear() == end->GetYear() && month->GetMonth() == end->GetMonth() && day->GetDay() > end->
-                    GetDay())
-                    continue;
+                const auto collect = [&](const Data &data) {
+                    const Time &time = data.GetTime();
 
-                for (const Quarter *quoter: day->GetQuarters()) {
-                    for (const auto &data: quoter->GetData()) {
-                        if (data->GetTime().GetHour() < start->GetHour() || data->GetTime().GetHour() > end->GetHour())
-                            continue;
-                        if (data->GetTime().GetMinute() < start->GetMinute() || data->GetTime().GetMinute() > end->
-                            GetMinute())
-                            continue;
+                    records.emplace_back(DateTime(day->GetDay(), month->GetMonth(), year->GetYear(),
+                                                  time.GetHour(), time.GetMinute(), time.IsRepeated()),
+                                         data.GetAutoConsumption(), data.GetExport(), data.GetImport(),
+                                         data.GetConsumption(), data.GetGeneration());
+                };
+
+                if (day->IsCompressed()) {
+                    for (const Data &data: day->GetBlock()->Decode()) collect(data);
+                    continue;
+                }
 
-                        sum += data->GetImport();
-                        ++count;
+                for (const Quarter *quarter: day->GetQuarters()) {
+                    for (const optional<Data> &data: quarter->GetData()) {
+                        if (data.has_value()) collect(*data);
                     }
                 }
             }
         }
     }
 
-    return count == 0 ? 0 : sum / count;
+    return records;
 }
 
 /**
- * @brief Oblicza średnie zużycie energii (pobór) w zadanym przedziale czasowym.
+ * @brief Zwraca ścieżkę do pliku dziennika zapisów.
  *
- * Funkcja iteruje przez strukturę danych (lata, miesiące, dni, kwadranse)
- * i sumuje wartości zużycia energii (poboru) dla rekordów, które mieszczą się
- * w zadanym przedziale czasowym. Następnie dzieli sumę przez liczbę rekordów,
- * aby uzyskać średnie zużycie.
+ * @param generation Numer pokolenia.
+ * @return Ścieżka do pliku.
+ */
+string EnergyAnalyzer::GetWalPath(const uint64_t generation) const {
+    return (filesystem::path(_storageDirectory) / ("wal_" + to_string(generation) + ".log")).string();
+}
+
+/**
+ * @brief Kompresuje dane historyczne.
  *
- * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
- * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
- * @return Średnie zużycie energii w zadanym przedziale czasowym lub 0, jeśli w przedziale
- *         nie znaleziono żadnych rekordów.
+ * Dni wcześniejsze niż podana data są kompresowane (`Day::Compress`). Zapytania o sumy
+ * i średnie korzystają dalej z agregatów dni, miesięcy i lat, a rozpakowywane są tylko
+ * bloki dni przeciętych granicą przedziału zapytania.
+ *
+ * @param before Data, od której dane pozostają nieskompresowane.
+ * @return Liczba skompresowanych dni.
  */
-long double EnergyAnalyzer::CalculateConsumptionAvgInRange(const DateTime *start, const DateTime *end) const {
-    long double sum = 0;
-    int count = 0;
+size_t EnergyAnalyzer::CompressHistory(const DateTime *before) {
+    unique_lock lock(_mutex);
 
-    for (const Year *year: *_years) {
-        if (year->GetYear() < start->GetYear() || year->GetYear() > end->GetYear()) continue;
+    const int beforeDate = (before->GetYear() * 100 + before->GetMonth()) * 100 + before->GetDay();
+    size_t compressed = 0;
 
+    for (const Year *year: *_years) {
         for (const Month *month: year->GetMonths()) {
-            if (year->GetYear() == start->GetYear() && month->GetMonth() < start->GetMonth()) continue;
-            if (year->GetYear() == end->GetYear() && month->GetMonth() > end->GetMonth()) continue;
-
-            for (const Day *day: month->GetDays()) {
-                if (year->GetYear() == start->GetYear() && month->GetMonth() == start->GetMonth() && day->GetDay() <
-                    start->GetDay())
-                    continue;
-                if (year->GetYear() == end->GetYear() && month->GetMonth() == end->GetMonth() && day->GetDay() > end->
-                    GetDay())
+            for (Day *day: month->GetDays()) {
+                if ((year->GetYear() * 100 + month->GetMonth()) * 100 + day->GetDay() >= beforeDate ||
+                    day->IsCompressed())
                     continue;
 
-                for (const Quarter *quoter: day->GetQuarters()) {
-                    for (const auto &data: quoter->GetData()) {
-                        if (data->GetTime().GetHour() < start->GetHour() || data->GetTime().GetHour() > end->GetHour())
-                            continue;
-                        if (data->GetTime().GetMinute() < start->GetMinute() || data->GetTime().GetMinute() > end->
-                            GetMinute())
-                            continue;
-
-                        sum += data->GetConsumption();
-                        ++count;
-                    }
-                }
+                day->Compress();
+                ++compressed;
             }
         }
     }
 
-    return count == 0 ? 0 : sum / count;
+    return compressed;
 }
 
 /**
- * @brief Oblicza średnią produkcję energii w zadanym przedziale czasowym.
+ * @brief Włącza śledzenie pliku, z którego wczytano dane.
  *
- * @param start Data i godzina początku przedziału.
- * @param end Data i godzina końca przedziału.
- * @return Średnia produkcja w przedziale [kWh].
+ * Wątek śledzący parsuje nowe linie bez blokady, a blokadę na wyłączność zajmuje dopiero
+ * na czas wstawienia całej partii rekordów, więc polecenia czekają co najwyżej tyle,
+ * ile trwa wstawienie dopisanych linii. Ponowne wywołanie zastępuje poprzedni wątek.
+ *
+ * @param interval Odstęp między kolejnymi sprawdzeniami pliku.
+ * @throws logic_error Jeśli analizator nie został utworzony z pliku.
  */
-long double EnergyAnalyzer::CalculateGenerationAvgInRange(const DateTime *start, const DateTime *end) const {
-    long double sum = 0;
-    int count = 0;
+void EnergyAnalyzer::Follow(const chrono::milliseconds interval) {
+    if (_filepath.empty()) throw logic_error("Analyzer was not loaded from a file");
 
-    for (const Year *year: *_years) {
-        if (year->GetYear() < start->GetYear() || year->GetYear() > end->GetYear()) continue;
+    StopFollowing();
 
-        for (const Month *month: year->GetMonths()) {
-            if (year->GetYear() == start->GetYear() && month->GetMonth() < start->GetMonth()) continue;
-            if (year->GetYear() == end->GetYear() && month->GetMonth() > end->GetMonth()) continue;
+    _followThread = jthread([this, interval, follower = EnergyDataFollower(_filepath, _fileOffset, _lastRead, _columns)]
+    (const stop_token &stop) mutable {
+        mutex waitMutex;
+        condition_variable_any wakeUp;
+        vector<EnergyData> resampled;
+        optional<GridResampler> resampler;
 
-            for (const Day *day: month->GetDays()) {
-                if (year->GetYear() == start->GetYear() && month->GetMonth() == start->GetMonth() && day->GetDay() <
-                    start->GetDay())
-                    continue;
-                if (year->GetYear() == end->GetYear() && month->GetMonth() == end->GetMonth() && day->GetDay() > end->
-                    GetDay())
-                    continue;
+        // Slot ostatniego odczytu partii czeka w etapie przepróbkowania na odczyty z kolejnej partii.
+        if (_resampleGapSlots != NoResampling)
+            resampler.emplace(_resampleGapSlots, [&resampled](EnergyData &&record, int) {
+                resampled.push_back(std::move(record));
+            });
 
-                for (const Quarter *quoter: day->GetQuarters()) {
-                    for (const auto &data: quoter->GetData()) {
-                        if (data->GetTime().GetHour() < start->GetHour() || data->GetTime().GetHour() > end->GetHour())
-                            continue;
-                        if (data->GetTime().GetMinute() < start->GetMinute() || data->GetTime().GetMinute() > end->
-                            GetMinute())
-                            continue;
+        while (!stop.stop_requested()) {
+            vector<EnergyData> records;
 
-                        sum += data->GetGeneration();
-                        ++count;
-                    }
-                }
+            follower.Poll([&records](EnergyData &&record) { records.push_back(std::move(record)); });
+
+            if (!records.empty()) _validator.Validate(records);
+
+            if (resampler) {
+                for (EnergyData &record: records) resampler->Push(std::move(record));
+
+                records = std::move(resampled);
+                resampled.clear();
             }
-        }
-    }
 
-    return count == 0 ? 0 : sum / count;
+            if (!records.empty()) Append(std::move(records));
+
+            unique_lock lock(waitMutex);
+            wakeUp.wait_for(lock, stop, interval, [] { return false; });
+        }
+    });
 }
 
 /**
- * @brief Porównuje sumy autokonsumpcji dla dwóch przedziałów czasowych i wypisuje wynik na standardowe wyjście.
- *
- * @param start_1 Data i godzina początku pierwszego przedziału.
- * @param end_1 Data i godzina końca pierwszego przedziału.
- * @param start_2 Data i godzina początku drugiego przedziału.
- * @param end_2 Data i godzina końca drugiego przedziału.
+ * @brief Wyłącza śledzenie pliku.
  */
-void EnergyAnalyzer::CompareAutoConsumption(const DateTime *start_1, const DateTime *end_1, const DateTime *start_2, const DateTime *end_2) const {
-    const long double sum_1 = CalculateAutoConsumptionSumInRange(start_1, end_1);
+void EnergyAnalyzer::StopFollowing() {
+    if (!_followThread.joinable()) return;
 
-    if (const long double sum_2 = CalculateAutoConsumptionSumInRange(start_2, end_2); sum_1 > sum_2)
-        cout << fixed << setprecision(4) << "Okres od " << start_1->ToString() << " do " << end_1->ToString() << " ma większe zużycie energii o wartości " << sum_1 - sum_2 << " W" << endl;
-    else if (sum_1 < sum_2)
-        cout << fixed << setprecision(4) << "Okres od " << start_2->ToString() << " do " << end_2->ToString() << " ma większe zużycie energii o wartości " << sum_2 - sum_1 << " W" << endl;
-    else
-        cout << fixed << setprecision(4) << "Okresy mają takie same zużycie energii" << endl;
+    _followThread.request_stop();
+    _followThread.join();
 }
 
 /**
- * @brief Porównuje sumy eksportu energii dla dwóch przedziałów czasowych i wypisuje wynik na standardowe wyjście.
+ * @brief Wstawia rekordy do struktury danych.
  *
- * @param start_1 Data i godzina początku pierwszego przedziału.
- * @param end_1 Data i godzina końca pierwszego przedziału.
- * @param start_2 Data i godzina początku drugiego przedziału.
- * @param end_2 Data i godzina końca drugiego przedziału.
+ * Nieuporządkowane rekordy są najpierw sortowane (sortowanie pozycyjne), dzięki czemu
+ * duplikaty w obrębie partii sąsiadują ze sobą i są łączone przed wstawieniem, a kolejne
+ * rekordy trafiają zwykle do dnia zapamiętanego przy poprzednim wstawieniu.
+ *
+ * @param records Rekordy do wstawienia (mogą zostać przestawione).
+ * @param policy Sposób rozstrzygania odczytów o tym samym znaczniku czasu.
+ * @return Liczba rekordów, które zostały dodane lub zmieniły istniejący odczyt.
  */
-void EnergyAnalyzer::CompareEksport(const DateTime *start_1, const DateTime *end_1, const DateTime *start_2, const DateTime *end_2) const {
-    const long double sum_1 = CalculateEksportSumInRange(start_1, end_1);
+size_t EnergyAnalyzer::InsertAll(vector<EnergyData> &records, const DuplicatePolicy policy) {
+    if (!EnergyDataSorter::IsSorted(records)) EnergyDataSorter::SortByDateTime(records);
 
-    if (const long double sum_2 = CalculateEksportSumInRange(start_2, end_2); sum_1 > sum_2)
-        cout << fixed << setprecision(4) << "Okres od " << start_1->ToString() << " do " << end_1->ToString() << " ma większe eksportowanie energii o wartości " << sum_1 - sum_2 << " W" << endl;
-    else if (sum_1 < sum_2)
-        cout << fixed << setprecision(4) << "Okres od " << start_2->ToString() << " do " << end_2->ToString() << " ma większe eksportowanie energii o wartości " << sum_2 - sum_1 << " W" << endl;
-    else
-        cout << fixed << setprecision(4) << "Okresy mają takie same eksportowanie energii" << endl;
-}
+    size_t changed = 0;
+    DuplicateResolver resolver(policy, [this, policy, &changed](EnergyData &&record, const int samples) {
+        if (InsertData(record, policy, samples)) ++changed;
+    });
 
-/**
- * @brief Porównuje sumy importu energii dla dwóch przedziałów czasowych i wypisuje wynik na standardowe wyjście.
- *
- * @param start_1 Data i godzina początku pierwszego przedziału.
- * @param end_1 Data i godzina końca pierwszego przedziału.
- * @param start_2 Data i godzina początku drugiego przedziału.
- * @param end_2 Data i godzina końca drugiego przedziału.
- */
-void EnergyAnalyzer::CompareImport(const DateTime *start_1, const DateTime *end_1, const DateTime *start_2, const DateTime *end_2) const {
-    const long double sum_1 = CalculateImportSumInRange(start_1, end_1);
+    for (EnergyData &record: records) resolver.Push(std::move(record));
+
+    resolver.Flush();
 
-    if (const long double sum_2 = CalculateImportSumInRange(start_2, end_2); sum_1 > sum_2)
-        cout << fixed << setprecision(4) << "Okres od " << start_1->ToString() << " do " << end_1->ToString() << " ma większe importowanie energii o wartości " << sum_1 - sum_2 << " W" << endl;
-    else if (sum_1 < sum_2)
-        cout << fixed << setprecision(4) << "Okres od " << start_2->ToString() << " do " << end_2->ToString() << " ma większe importowanie energii o wartości " << sum_2 - sum_1 << " W" << endl;
-    else
-        cout << fixed << setprecision(4) << "Okresy mają takie same importowanie energii" << endl;
+    return changed;
 }
 
 /**
- * @brief Porównuje sumy zużycia energii dla dwóch przedziałów czasowych i wypisuje wynik na standardowe wyjście.
+ * @brief Wywołuje funkcję dla każdego rekordu z przedziału czasowego [start, end].
  *
- * @param start_1 Data i godzina początku pierwszego przedziału.
- * @param end_1 Data i godzina końca pierwszego przedziału.
- * @param start_2 Data i godzina początku drugiego przedziału.
- * @param end_2 Data i godzina końca drugiego przedziału.
+ * Przedział jest ciągły w czasie: w pierwszym dniu obejmuje rekordy od godziny początku,
+ * w ostatnim - do godziny końca, a dni pośrednie w całości. W dniach brzegowych odwiedzane są
+ * tylko kubełki, w które wpadają minuty początku lub końca - indeks kubełka wynika bezpośrednio
+ * z minuty dnia.
+ *
+ * @param start Data i godzina początku przedziału.
+ * @param end Data i godzina końca przedziału.
+ * @param visitor Funkcja wywoływana z datą rekordu i samym rekordem.
  */
-void EnergyAnalyzer::CompareConsumption(const DateTime *start_1, const DateTime *end_1, const DateTime *start_2, const DateTime *end_2) const {
-    const long double sum_1 = CalculateConsumptionSumInRange(start_1, end_1);
-
-    if (const long double sum_2 = CalculateConsumptionSumInRange(start_2, end_2); sum_1 > sum_2)
-        cout << fixed << setprecision(4) << "Okres od " << start_1->ToString() << " do " << end_1->ToString() << " ma większe zużycie energii o wartości " << sum_1 - sum_2 << " W" << endl;
-    else if (sum_1 < sum_2)
-        cout << fixed << setprecision(4) << "Okres od " << start_2->ToString() << " do " << end_2->ToString() << " ma większe zużycie energii o wartości " << sum_2 - sum_1 << " W" << endl;
-    else
-        cout << fixed << setprecision(4) << "Okresy mają takie same zużycie energii" << endl;
+template<typename Visitor>
+void EnergyAnalyzer::ForEachDataInRange(const DateTime *start, const DateTime *end, Visitor &&visitor) const {
+    ForEachDataInRange(start, end, std::forward<Visitor>(visitor), [](const Aggregate &) { return true; });
 }
 
 /**
- * @brief Porównuje sumy produkcji energii dla dwóch przedziałów czasowych i wypisuje wynik na standardowe wyjście.
+ * @brief Wywołuje funkcję dla rekordów z przedziału czasowego [start, end], pomijając całe węzły drzewa.
  *
- * @param start_1 Data i godzina początku pierwszego przedziału.
- * @param end_1 Data i godzina końca pierwszego przedziału.
- * @param start_2 Data i godzina początku drugiego przedziału.
- * @param end_2 Data i godzina końca drugiego przedziału.
+ * Agregat każdego roku, miesiąca, dnia (także skompresowanego) i kubełka jest sprawdzany przed
+ * zejściem w głąb - węzeł odrzucony przez `mayContain` nie jest odwiedzany ani rozpakowywany.
+ *
+ * @param start Data i godzina początku przedziału.
+ * @param end Data i godzina końca przedziału.
+ * @param visitor Funkcja wywoływana z datą rekordu i samym rekordem.
+ * @param mayContain Funkcja decydująca na podstawie agregatu, czy węzeł może zawierać szukane rekordy.
  */
-void EnergyAnalyzer::CompareGeneration(const DateTime *start_1, const DateTime *end_1, const DateTime *start_2, const DateTime *end_2) const {
-    const long double sum_1 = CalculateGenerationSumInRange(start_1, end_1);
+template<typename Visitor, typename Pruner>
+void EnergyAnalyzer::ForEachDataInRange(const DateTime *start, const DateTime *end, Visitor &&visitor,
+                                        Pruner &&mayContain) const {
+    const int startDate = (start->GetYear() * 100 + start->GetMonth()) * 100 + start->GetDay();
+    const int endDate = (end->GetYear() * 100 + end->GetMonth()) * 100 + end->GetDay();
 
-    if (const long double sum_2 = CalculateGenerationSumInRange(start_2, end_2); sum_1 > sum_2)
-        cout << fixed << setprecision(4) << "Okres od " << start_1->ToString() << " do " << end_1->ToString() << " ma większe generowanie energii o wartości " << sum_1 - sum_2 << " W" << endl;
-    else if (sum_1 < sum_2)
-        cout << fixed << setprecision(4) << "Okres od " << start_2->ToString() << " do " << end_2->ToString() << " ma większe generowanie energii o wartości " << sum_2 - sum_1 << " W" << endl;
-    else
-        cout << fixed << setprecision(4) << "Okresy mają takie same generowanie energii" << endl;
-}
+    for (const Year *year: *_years) {
+        if (year->GetYear() < start->GetYear() || year->GetYear() > end->GetYear() ||
+            !mayContain(year->GetAggregate()))
+            continue;
 
-/**
- * @brief Wyszukuje i wypisuje na ekran rekordy, w których wartość autokonsumpcji mieści się w zadanym zakresie z tolerancją, w określonym przedziale czasowym.
- *
- * @param target Szukana wartość autokonsumpcji.
- * @param tolerance Zakres tolerancji wokół szukanej wartości.
- * @param start Data i godzina początku przedziału czasowego.
- * @param end Data i godzina końca przedziału czasowego.
- */
-void EnergyAnalyzer::SearchByAutoConsumptionWithTolerance(const long double target, const long double tolerance, const DateTime *start, const DateTime *end) const {
-    cout << fixed << setprecision(4) << "Szukam autokonsumpcji w zakresie " << target - tolerance << " - " << target + tolerance
-         << " w przedziale czasowym od " << start->ToString() << " do " << end->ToString() << ":" << endl;
+        for (const Month *month: year->GetMonths()) {
+            const int monthDate = year->GetYear() * 100 + month->GetMonth();
 
-    for (const Year *year : *_years) {
-        if (year->GetYear() < start->GetYear() || year->GetYear() > end->GetYear()) continue;
+            if (monthDate < startDate / 100 || monthDate > endDate / 100 || !mayContain(month->GetAggregate())) continue;
 
-        for (const Month *month : year->GetMonths()) {
-            if (year->GetYear() == start->GetYear() && month->GetMonth() < start->GetMonth()) continue;
-            if (year->GetYear() == end->GetYear() && month->GetMonth() > end->GetMonth()) continue;
+            for (const Day *day: month->GetDays()) {
+                const int date = monthDate * 100 + day->GetDay();
 
-            for (const Day *day : month->GetDays()) {
-                if (year->GetYear() == start->GetYear() && month->GetMonth() == start->GetMonth() &&
-                    day->GetDay() < start->GetDay())
-                    continue;
-                if (year->GetYear() == end->GetYear() && month->GetMonth() == end->GetMonth() &&
-                    day->GetDay() > end->GetDay())
-                    continue;
+                if (date < startDate || date > endDate || !mayContain(day->GetAggregate())) continue;
 
-                for (const Quarter *quarter : day->GetQuarters()) {
-                    for (const auto &data : quarter->GetData()) {
-                        // Sprawdź, czy rekord mieści się w przedziale czasowym
-                        if (data->GetTime().GetHour() < start->GetHour() ||
-                            (data->GetTime().GetHour() == start->GetHour() &&
-                             data->GetTime().GetMinute() < start->GetMinute()))
-                            continue;
-                        if (data->GetTime().GetHour() > end->GetHour() ||
-                            (data->GetTime().GetHour() == end->GetHour() &&
-                             data->GetTime().GetMinute() > end->GetMinute()))
-                            continue;
+                const int fromMinute = date == startDate ? start->GetHour() * 60 + start->GetMinute() : 0;
+                const int toMinute = date == endDate ? end->GetHour() * 60 + end->GetMinute() : 24 * 60 - 1;
 
-                        // Sprawdź, czy autokonsumpcja mieści się w zakresie z tolerancją
-                        if (data->GetAutoConsumption() >= target - tolerance && data->GetAutoConsumption() <= target + tolerance) {
-                            cout << fixed << setprecision(4) << "  - Znaleziono rekord: Data i godzina: "
-                            << year->GetYear() << "-" << month->GetMonth() << "-" << day->GetDay() << " " << data->GetTime().GetHour() << ":" << data->GetTime().GetMinute()
-                            << ", Autokonsumpcja: " << data->GetAutoConsumption() << endl;
-                        }
-                    }
-                }
-            }
-        }
-    }
-}
+                if (fromMinute > toMinute) continue;
 
-/**
- * @brief Wyszukuje i wypisuje na ekran rekordy, w których wartość eksportu mieści się w zadanym zakresie z tolerancją, w określonym przedziale czasowym.
- *
- * @param target Szukana wartość eksportu.
- * @param tolerance Zakres tolerancji wokół szukanej wartości.
- * @param start Data i godzina początku przedziału czasowego.
- * @param end Data i godzina końca przedziału czasowego.
- */
-void EnergyAnalyzer::SearchByExportWithTolerance(const long double target, const long double tolerance, const DateTime *start, const DateTime *end) const {
-    cout << fixed << setprecision(4) << "Szukam eksportu w zakresie " << target - tolerance << " - " << target + tolerance
-         << " w przedziale czasowym od " << start->ToString() << " do " << end->ToString() << ":" << endl;
+                const auto visit = [&](const Data &data) {
+                    const Time &time = data.GetTime();
 
-    for (const Year *year : *_years) {
-        if (year->GetYear() < start->GetYear() || year->GetYear() > end->GetYear()) continue;
+                    if (time.GetMinuteOfDay() < fromMinute || time.GetMinuteOfDay() > toMinute) return;
 
-        for (const Month *month : year->GetMonths()) {
-            if (year->GetYear() == start->GetYear() && month->GetMonth() < start->GetMonth()) continue;
-            if (year->GetYear() == end->GetYear() && month->GetMonth() > end->GetMonth()) continue;
+                    visitor(DateTime(day->GetDay(), month->GetMonth(), year->GetYear(), time.GetHour(),
+                                     time.GetMinute(), time.IsRepeated()), data);
+                };
 
-            for (const Day *day : month->GetDays()) {
-                if (year->GetYear() == start->GetYear() && month->GetMonth() == start->GetMonth() &&
-                    day->GetDay() < start->GetDay())
-                    continue;
-                if (year->GetYear() == end->GetYear() && month->GetMonth() == end->GetMonth() &&
-                    day->GetDay() > end->GetDay())
+                if (day->IsCompressed()) {
+                    for (const Data &data: day->GetBlock()->Decode()) visit(data);
                     continue;
+                }
 
-                for (const Quarter *quarter : day->GetQuarters()) {
-                    for (const auto &data : quarter->GetData()) {
-                        // Sprawdź, czy rekord mieści się w przedziale czasowym
-                        if (data->GetTime().GetHour() < start->GetHour() ||
-                            (data->GetTime().GetHour() == start->GetHour() &&
-                             data->GetTime().GetMinute() < start->GetMinute()))
-                            continue;
-                        if (data->GetTime().GetHour() > end->GetHour() ||
-                            (data->GetTime().GetHour() == end->GetHour() &&
-                             data->GetTime().GetMinute() > end->GetMinute()))
-                            continue;
+                const vector<Quarter *> &quarters = day->GetQuarters();
+                const size_t lastQuarter = min<size_t>(toMinute / day->GetBucketMinutes(), quarters.size() - 1);
 
-                        // Sprawdź, czy eksport mieści się w zakresie z tolerancją
-                        if (data->GetExport() >= target - tolerance && data->GetExport() <= target + tolerance) {
-                            cout << fixed << setprecision(4) << "  - Znaleziono rekord: Data i godzina: "
-                                << year->GetYear() << "-" << month->GetMonth() << "-" << day->GetDay() << " " << data->GetTime().GetHour() << ":" << data->GetTime().GetMinute()
-                                << ", Eksport: " << data->GetExport() << endl;
-                        }
+                for (size_t i = fromMinute / day->GetBucketMinutes(); i <= lastQuarter; ++i) {
+                    if (!mayContain(quarters[i]->GetAggregate())) continue;
+
+                    for (const optional<Data> &data: quarters[i]->GetData()) {
+                        if (data.has_value()) visit(*data);
                     }
                 }
             }
@@ -676,285 +686,1646 @@ void EnergyAnalyzer::SearchByExportWithTolerance(const long double target, const
 }
 
 /**
- * @brief Wyszukuje i wypisuje na ekran rekordy, w których wartość importu mieści się w zadanym zakresie z tolerancją, w określonym przedziale czasowym.
+ * @brief Zwraca datę ostatniego dnia miesiąca.
  *
- * @param target Szukana wartość importu.
- * @param tolerance Zakres tolerancji wokół szukanej wartości.
- * @param start Data i godzina początku przedziału czasowego.
- * @param end Data i godzina końca przedziału czasowego.
+ * Pozwala rozpoznać miesiąc leżący w całości w przedziale kończącym się w jego ostatnim dniu,
+ * także gdy miesiąc ma mniej niż 31 dni.
+ *
+ * @param monthDate Miesiąc w postaci RRRRMM.
+ * @return Data ostatniego dnia miesiąca w postaci RRRRMMDD.
  */
-void EnergyAnalyzer::SearchByImportWithTolerance(const long double target, const long double tolerance, const DateTime *start, const DateTime *end) const {
-    cout << fixed << setprecision(4) << "Szukam importu w zakresie " << target - tolerance << " - " << target + tolerance
-         << " w przedziale czasowym od " << start->ToString() << " do " << end->ToString() << ":" << endl;
-
-    for (const Year *year : *_years) {
-        if (year->GetYear() < start->GetYear() || year->GetYear() > end->GetYear()) continue;
-
-        for (const Month *month : year->GetMonths()) {
-            if (year->GetYear() == start->GetYear() && month->GetMonth() < start->GetMonth()) continue;
-            if (year->GetYear() == end->GetYear() && month->GetMonth() > end->GetMonth()) continue;
-
-            for (const Day *day : month->GetDays()) {
-                if (year->GetYear() == start->GetYear() && month->GetMonth() == start->GetMonth() &&
-                    day->GetDay() < start->GetDay())
-                    continue;
-                if (year->GetYear() == end->GetYear() && month->GetMonth() == end->GetMonth() &&
-                    day->GetDay() > end->GetDay())
-                    continue;
-
-                for (const Quarter *quarter : day->GetQuarters()) {
-                    for (const auto &data : quarter->GetData()) {
-                        // Sprawdź, czy rekord mieści się w przedziale czasowym
-                        if (data->GetTime().GetHour() < start->GetHour() ||
-                            (data->GetTime().GetHour() == start->GetHour() &&
-                             data->GetTime().GetMinute() < start->GetMinute()))
-                            continue;
-                        if (data->GetTime().GetHour() > end->GetHour() ||
-                            (data->GetTime().GetHour() == end->GetHour() &&
-                             data->GetTime().GetMinute() > end->GetMinute()))
-                            continue;
+int EnergyAnalyzer::GetLastDate(const int monthDate) {
+    const chrono::year_month_day_last last(chrono::year(monthDate / 100),
+                                           chrono::month_day_last(chrono::month(monthDate % 100)));
 
-                        // Sprawdź, czy import mieści się w zakresie z tolerancją
-                        if (data->GetImport() >= target - tolerance && data->GetImport() <= target + tolerance) {
-                            cout << fixed << setprecision(4) << "  - Znaleziono rekord: Data i godzina: "
-                                 << year->GetYear() << "-" << month->GetMonth() << "-" << day->GetDay() << " " << data->GetTime().GetHour() << ":" << data->GetTime().GetMinute()
-                                 << ", Import: " << data->GetImport() << endl;
-                        }
-                    }
-                }
-            }
-        }
-    }
+    return monthDate * 100 + static_cast<int>(static_cast<unsigned>(last.day()));
 }
 
 /**
- * @brief Wyszukuje i wypisuje na ekran rekordy, w których wartość zużycia (poboru) mieści się w zadanym zakresie z tolerancją, w określonym przedziale czasowym.
+ * @brief Oblicza agregat danych z przedziału czasowego [start, end].
  *
- * @param target Szukana wartość zużycia.
- * @param tolerance Zakres tolerancji wokół szukanej wartości.
- * @param start Data i godzina początku przedziału czasowego.
- * @param end Data i godzina końca przedziału czasowego.
+ * Przedział jest rozumiany tak samo jak w `ForEachDataInRange`. Rok, miesiąc lub dzień,
+ * którego wszystkie minuty należą do przedziału, dokłada od razu swój agregat. W dniach
+ * brzegowych z agregatów korzystają kubełki zawarte w przedziale, a rekordy są odwiedzane
+ * tylko w co najwyżej dwóch kubełkach przeciętych granicą przedziału. Koszt zapytania nie
+ * zależy więc od liczby rekordów w przedziale.
+ *
+ * @param start Data i godzina początku przedziału.
+ * @param end Data i godzina końca przedziału.
+ * @return Agregat danych z przedziału.
  */
-void EnergyAnalyzer::SearchByConsumptionWithTolerance(const long double target, const long double tolerance, const DateTime *start, const DateTime *end) const {
-    cout << fixed << setprecision(4) << "Szukam zużycia w zakresie " << target - tolerance << " - " << target + tolerance
-         << " w przedziale czasowym od " << start->ToString() << " do " << end->ToString() << ":" << endl;
+Aggregate EnergyAnalyzer::AggregateInRange(const DateTime *start, const DateTime *end) const {
+    const int startDate = (start->GetYear() * 100 + start->GetMonth()) * 100 + start->GetDay();
+    const int endDate = (end->GetYear() * 100 + end->GetMonth()) * 100 + end->GetDay();
+    const int startMinute = start->GetHour() * 60 + start->GetMinute();
+    const int endMinute = end->GetHour() * 60 + end->GetMinute();
+
+    // Czy wszystkie minuty dni od firstDate do lastDate należą do przedziału.
+    const auto covers = [&](const int firstDate, const int lastDate) {
+        return (firstDate > startDate || (firstDate == startDate && startMinute <= 0)) &&
+               (lastDate < endDate || (lastDate == endDate && endMinute >= 24 * 60 - 1));
+    };
 
-    for (const Year *year : *_years) {
+    Aggregate result;
+
+    for (const Year *year: *_years) {
         if (year->GetYear() < start->GetYear() || year->GetYear() > end->GetYear()) continue;
 
-        for (const Month *month : year->GetMonths()) {
-            if (year->GetYear() == start->GetYear() && month->GetMonth() < start->GetMonth()) continue;
-            if (year->GetYear() == end->GetYear() && month->GetMonth() > end->GetMonth()) continue;
+        if (covers(year->GetYear() * 10000 + 101, year->GetYear() * 10000 + 1231)) {
+            result.Merge(year->GetAggregate());
+            continue;
+        }
 
-            for (const Day *day : month->GetDays()) {
-                if (year->GetYear() == start->GetYear() && month->GetMonth() == start->GetMonth() &&
-                    day->GetDay() < start->GetDay())
-                    continue;
-                if (year->GetYear() == end->GetYear() && month->GetMonth() == end->GetMonth() &&
-                    day->GetDay() > end->GetDay())
-                    continue;
+        for (const Month *month: year->GetMonths()) {
+            const int monthDate = year->GetYear() * 100 + month->GetMonth();
 
-                for (const Quarter *quarter : day->GetQuarters()) {
-                    for (const auto &data : quarter->GetData()) {
-                        // Sprawdź, czy rekord mieści się w przedziale czasowym
-                        if (data->GetTime().GetHour() < start->GetHour() ||
-                            (data->GetTime().GetHour() == start->GetHour() &&
-                             data->GetTime().GetMinute() < start->GetMinute()))
-                            continue;
-                        if (data->GetTime().GetHour() > end->GetHour() ||
-                            (data->GetTime().GetHour() == end->GetHour() &&
-                             data->GetTime().GetMinute() > end->GetMinute()))
-                            continue;
+            if (monthDate < startDate / 100 || monthDate > endDate / 100) continue;
 
-                        // Sprawdź, czy zużycie mieści się w zakresie z tolerancją
-                        if (data->GetConsumption() >= target - tolerance && data->GetConsumption() <= target + tolerance) {
-                            cout << fixed << setprecision(4) << "  - Znaleziono rekord: Data i godzina: "
-                                 << year->GetYear() << "-" << month->GetMonth() << "-" << day->GetDay() << " " << data->GetTime().GetHour() << ":" << data->GetTime().GetMinute()
-                                 << ", Zużycie: " << data->GetConsumption() << endl;
-                        }
-                    }
-                }
+            if (covers(monthDate * 100 + 1, GetLastDate(monthDate))) {
+                result.Merge(month->GetAggregate());
+                continue;
             }
-        }
-    }
-}
-
-/**
- * @brief Wyszukuje i wypisuje na ekran rekordy, w których wartość produkcji mieści się w zadanym zakresie z tolerancją, w określonym przedziale czasowym.
- *
- * @param target Szukana wartość produkcji.
- * @param tolerance Zakres tolerancji wokół szukanej wartości.
- * @param start Data i godzina początku przedziału czasowego.
- * @param end Data i godzina końca przedziału czasowego.
- */
-void EnergyAnalyzer::SearchByGenerationWithTolerance(const long double target, const long double tolerance, const DateTime *start, const DateTime *end) const {
-    cout << fixed << setprecision(4) << "Szukam produkcji w zakresie " << target - tolerance << " - " << target + tolerance
-         << " w przedziale czasowym od " << start->ToString() << " do " << end->ToString() << ":" << endl;
 
-    for (const Year *year : *_years) {
-        if (year->GetYear() < start->GetYear() || year->GetYear() > end->GetYear()) continue;
+            for (const Day *day: month->GetDays()) {
+                const int date = monthDate * 100 + day->GetDay();
 
-        for (const Month *month : year->GetMonths()) {
-            if (year->GetYear() == start->GetYear() && month->GetMonth() < start->GetMonth()) continue;
-            if (year->GetYear() == end->GetYear() && month->GetMonth() > end->GetMonth()) continue;
+                if (date < startDate || date > endDate) continue;
 
-            for (const Day *day : month->GetDays()) {
-                if (year->GetYear() == start->GetYear() && month->GetMonth() == start->GetMonth() &&
-                    day->GetDay() < start->GetDay())
+                if (covers(date, date)) {
+                    result.Merge(day->GetAggregate());
                     continue;
-                if (year->GetYear() == end->GetYear() && month->GetMonth() == end->GetMonth() &&
-                    day->GetDay() > end->GetDay())
+                }
+
+                const int fromMinute = date == startDate ? startMinute : 0;
+                const int toMinute = date == endDate ? endMinute : 24 * 60 - 1;
+
+                if (fromMinute > toMinute) continue;
+
+                // Skompresowany dzień brzegowy jest rozpakowywany w całości.
+                if (day->IsCompressed()) {
+                    for (const Data &data: day->GetBlock()->Decode()) {
+                        const int minute = data.GetTime().GetMinuteOfDay();
+
+                        if (minute >= fromMinute && minute <= toMinute) result.Add(data);
+                    }
+
                     continue;
+                }
 
-                for (const Quarter *quarter : day->GetQuarters()) {
-                    for (const auto &data : quarter->GetData()) {
-                        // Sprawdź, czy rekord mieści się w przedziale czasowym
-                        if (data->GetTime().GetHour() < start->GetHour() ||
-                            (data->GetTime().GetHour() == start->GetHour() &&
-                             data->GetTime().GetMinute() < start->GetMinute()))
-                            continue;
-                        if (data->GetTime().GetHour() > end->GetHour() ||
-                            (data->GetTime().GetHour() == end->GetHour() &&
-                             data->GetTime().GetMinute() > end->GetMinute()))
-                            continue;
+                const vector<Quarter *> &quarters = day->GetQuarters();
+                const int bucketMinutes = day->GetBucketMinutes();
+                const size_t lastQuarter = min<size_t>(toMinute / bucketMinutes, quarters.size() - 1);
+
+                for (size_t i = fromMinute / bucketMinutes; i <= lastQuarter; ++i) {
+                    const Quarter *quarter = quarters[i];
+                    const int repeatedHour = quarter->GetRepeatedHour();
+                    // Sloty godziny powtarzanej mogą zaczynać się przed początkiem kubełka.
+                    const int firstMinute = repeatedHour >= 0
+                                                ? min<int>(i * bucketMinutes, repeatedHour * 60)
+                                                : static_cast<int>(i * bucketMinutes);
+
+                    if (firstMinute >= fromMinute && static_cast<int>((i + 1) * bucketMinutes) - 1 <= toMinute) {
+                        result.Merge(quarter->GetAggregate());
+                        continue;
+                    }
 
-                        // Sprawdź, czy produkcja mieści się w zakresie z tolerancją
-                        if (data->GetGeneration() >= target - tolerance && data->GetGeneration() <= target + tolerance) {
-                            cout << fixed << setprecision(4) << "  - Znaleziono rekord: Data i godzina: "
-                                 << year->GetYear() << "-" << month->GetMonth() << "-" << day->GetDay() << " " << data->GetTime().GetHour() << ":" << data->GetTime().GetMinute()
-                                 << ", Produkcja: " << data->GetGeneration() << endl;
-                        }
+                    for (const optional<Data> &data: quarter->GetData()) {
+                        if (!data.has_value()) continue;
+
+                        const int minute = data->GetTime().GetMinuteOfDay();
+
+                        if (minute >= fromMinute && minute <= toMinute) result.Add(*data);
                     }
                 }
             }
         }
     }
+
+    return result;
 }
 
 /**
- * @brief Wypisuje wszystkie dane z zadanego przedziału czasowego.
+ * @brief Buduje szkic rozkładu wartości danych z przedziału czasowego [start, end].
  *
- * Funkcja iteruje przez strukturę danych (lata, miesiące, dni, kwadranse)
- * i wypisuje na standardowe wyjście wszystkie rekordy danych, które mieszczą się
- * w zadanym przedziale czasowym.
+ * Przedział jest rozumiany tak samo jak w `AggregateInRange`. Rok, miesiąc lub dzień, którego
+ * wszystkie minuty należą do przedziału, dokłada swój szkic, a w dniach brzegowych (które nie
+ * mają szkiców kubełków) odwiedzane są pojedyncze rekordy - najwyżej dwie doby odczytów.
  *
- * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
- * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+ * @param start Data i godzina początku przedziału.
+ * @param end Data i godzina końca przedziału.
+ * @return Szkic danych z przedziału.
  */
-void EnergyAnalyzer::PrintAllDataInRange(const DateTime *start, const DateTime *end) const {
+QuantileSketch EnergyAnalyzer::SketchInRange(const DateTime *start, const DateTime *end) const {
+    const int startDate = (start->GetYear() * 100 + start->GetMonth()) * 100 + start->GetDay();
+    const int endDate = (end->GetYear() * 100 + end->GetMonth()) * 100 + end->GetDay();
+    const int startMinute = start->GetHour() * 60 + start->GetMinute();
+    const int endMinute = end->GetHour() * 60 + end->GetMinute();
+
+    // Czy wszystkie minuty dni od firstDate do lastDate należą do przedziału.
+    const auto covers = [&](const int firstDate, const int lastDate) {
+        return (firstDate > startDate || (firstDate == startDate && startMinute <= 0)) &&
+               (lastDate < endDate || (lastDate == endDate && endMinute >= 24 * 60 - 1));
+    };
+
+    QuantileSketch result;
+
     for (const Year *year: *_years) {
         if (year->GetYear() < start->GetYear() || year->GetYear() > end->GetYear()) continue;
 
+        if (covers(year->GetYear() * 10000 + 101, year->GetYear() * 10000 + 1231)) {
+            result.Merge(year->GetSketch());
+            continue;
+        }
+
         for (const Month *month: year->GetMonths()) {
-            if (year->GetYear() == start->GetYear() && month->GetMonth() < start->GetMonth()) continue;
-            if (year->GetYear() == end->GetYear() && month->GetMonth() > end->GetMonth()) continue;
+            const int monthDate = year->GetYear() * 100 + month->GetMonth();
+
+            if (monthDate < startDate / 100 || monthDate > endDate / 100) continue;
+
+            if (covers(monthDate * 100 + 1, GetLastDate(monthDate))) {
+                result.Merge(month->GetSketch());
+                continue;
+            }
 
             for (const Day *day: month->GetDays()) {
-                if (year->GetYear() == start->GetYear() && month->GetMonth() == start->GetMonth() && day->GetDay() <
-                    start->GetDay())
-                    continue;
-                if (year->GetYear() == end->GetYear() && month->GetMonth() == end->GetMonth() && day->GetDay() > end->
-                    GetDay())
+                const int date = monthDate * 100 + day->GetDay();
+
+                if (date < startDate || date > endDate) continue;
+
+                if (covers(date, date)) {
+                    result.Merge(day->GetSketch());
                     continue;
+                }
 
-                for (const Quarter *quoter: day->GetQuarters()) {
-                    for (const auto &data: quoter->GetData()) {
-                        if (data->GetTime().GetHour() < start->GetHour() || data->GetTime().GetHour() > end->GetHour())
-                            continue;
-                        if (data->GetTime().GetMinute() < start->GetMinute() || data->GetTime().GetMinute() > end->
-                            GetMinute())
-                            continue;
+                const int fromMinute = date == startDate ? startMinute : 0;
+                const int toMinute = date == endDate ? endMinute : 24 * 60 - 1;
 
-                        cout << year->GetYear() << "-" << month->GetMonth() << "-" << day->GetDay() << " ";
-                        cout << data->GetTime().GetHour() << ":" << data->GetTime().GetMinute() << "";
-                        cout << ", Autokonsumpcja: " << fixed << setprecision(4) << data->GetAutoConsumption() << "";
-                        cout << ", Export: " << fixed << setprecision(4) << data->GetExport();
-                        cout << ", Import: " << fixed << setprecision(4) << data->GetImport() << "";
-                        cout << ", Pobór: " << fixed << setprecision(4) << data->GetConsumption() << "";
-                        cout << ", Produkcja: " << fixed << setprecision(4) << data->GetGeneration() << endl;
+                if (fromMinute > toMinute) continue;
+
+                const auto add = [&](const Data &data) {
+                    const int minute = data.GetTime().GetMinuteOfDay();
+
+                    if (minute >= fromMinute && minute <= toMinute) result.Add(data);
+                };
+
+                if (day->IsCompressed()) {
+                    for (const Data &data: day->GetBlock()->Decode()) add(data);
+                    continue;
+                }
+
+                for (const Quarter *quarter: day->GetQuarters()) {
+                    for (const optional<Data> &data: quarter->GetData()) {
+                        if (data.has_value()) add(*data);
                     }
                 }
             }
         }
     }
-}
 
-/**
-    * @brief Wykonuje polecenie na danych energetycznych.
-    *
-    * Ta funkcja przyjmuje polecenie jako ciąg znaków i wykonuje odpowiednią
-    * akcję na danych energetycznych. Konkretne polecenia i ich działania są
-    * zdefiniowane w implementacji tej funkcji.
-    *
-    * @param command Polecenie do wykonania.
-*/
-void EnergyAnalyzer::ExecuteCommand(const string &command) const {
-    _commandParser->ParseAndExecute(command);
+    return result;
 }
 
-
 /**
- * @brief Tworzy strukturę danych (lata, miesiące, dni, kwadranse, dane) na podstawie wektora obiektów EnergyData.
+ * @brief Wyszukuje wartość skrajną wielkości w przedziale czasowym [start, end].
+ *
+ * Wartość wyznacza `AggregateInRange`. Rekord z tą wartością jest szukany w węzłach, których
+ * agregat ją obejmuje (jak w wyszukiwaniu z tolerancją zerową), a po jego znalezieniu wszystkie
+ * dalsze węzły są pomijane - odwiedzana jest więc praktycznie jedna ścieżka drzewa.
  *
- * @param energyData Wektor wskaźników do obiektów EnergyData.
- * @return Wskaźnik do wektora lat.
+ * @param metric Wielkość.
+ * @param start Data i godzina początku przedziału.
+ * @param end Data i godzina końca przedziału.
+ * @param maximum true dla wartości największej, false dla najmniejszej.
+ * @return Wartość skrajna i czas jej pierwszego wystąpienia.
  */
-vector<Year *> *EnergyAnalyzer::createYears(const vector<EnergyData *> *energyData) {
-    auto *years = new vector<Year *>;
+optional<EnergyAnalyzer::Extremum> EnergyAnalyzer::FindExtremumInRange(const Metric metric, const DateTime *start,
+                                                                       const DateTime *end, const bool maximum) const {
+    const Aggregate aggregate = AggregateInRange(start, end);
+    const double value = maximum ? aggregate.GetMax(metric) : aggregate.GetMin(metric);
 
-    for (const EnergyData *data: *energyData) {
-        Year *year = nullptr;
-
-        for (Year *y: *years) {
-            if (y->GetYear() == data->GetDateTime().GetYear()) {
-                year = y;
-                break;
-            }
-        }
+    // Pusty przedział lub niewczytana kolumna (same NaN) zostawiają w agregacie nieskończoność.
+    if (!isfinite(value)) return nullopt;
 
-        if (year == nullptr) {
-            year = new Year(data->GetDateTime().GetYear());
-            years->push_back(year);
-        }
+    optional<Extremum> result;
 
-        Month *month = nullptr;
-        for (Month *m: year->GetMonths()) {
-            if (m->GetMonth() == data->GetDateTime().GetMonth()) {
-                month = m;
-                break;
-            }
-        }
+    ForEachDataInRange(start, end, [&](const DateTime &dateTime, const Data &data) {
+        if (!result.has_value() && data.GetValue(metric) == value) result = Extremum{dateTime, value};
+    }, [&](const Aggregate &node) {
+        return !result.has_value() && node.MayContain(metric, value, value);
+    });
 
-        if (month == nullptr) {
-            month = new Month(data->GetDateTime().GetMonth());
-            year->GetMonths().push_back(month);
-        }
+    return result;
+}
 
-        Day *day = nullptr;
-        for (Day *d: month->GetDays()) {
-            if (d->GetDay() == data->GetDateTime().GetDay()) {
-                day = d;
-                break;
-            }
-        }
+/**
+ * @brief Oblicza sumę autokonsumpcji w zadanym przedziale czasowym.
+ *
+ * @param start Data i godzina początku przedziału.
+ * @param end Data i godzina końca przedziału.
+ * @return Suma autokonsumpcji w przedziale [kWh].
+ */
+long double EnergyAnalyzer::CalculateAutoConsumptionSumInRange(const DateTime *start, const DateTime *end) const {
+    const ReadLock lock(*this);
 
-        if (day == nullptr) {
-            day = new Day(data->GetDateTime().GetDay());
-            month->GetDays().push_back(day);
-        }
+    return AggregateInRange(start, end).GetSum(Metric::AutoConsumption);
+}
 
-        for (auto quoters = day->GetQuarters(); const auto quoter: quoters) {
-            auto *time = new Time(data->GetDateTime().GetHour(), data->GetDateTime().GetMinute());
-            auto *newData = new Data(time, data->GetAutoConsumption(), data->GetExport(), data->GetImport(),
-                                     data->GetConsumption(), data->GetGeneration());
+/**
+ * @brief Oblicza sumę eksportu energii w zadanym przedziale czasowym.
+ *
+ * @param start Data i godzina początku przedziału.
+ * @param end Data i godzina końca przedziału.
+ * @return Suma eksportu w przedziale [kWh].
+ */
+long double EnergyAnalyzer::CalculateEksportSumInRange(const DateTime *start, const DateTime *end) const {
+    const ReadLock lock(*this);
 
-            if (quoter->AddData(*time, *newData)) break;
+    return AggregateInRange(start, end).GetSum(Metric::Export);
+}
 
-            delete newData;
-        }
-    }
+/**
+ * @brief Oblicza sumę importu energii w zadanym przedziale czasowym.
+ *
+ * @param start Data i godzina początku przedziału.
+ * @param end Data i godzina końca przedziału.
+ * @return Suma importu w przedziale [kWh].
+ */
+long double EnergyAnalyzer::CalculateImportSumInRange(const DateTime *start, const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    return AggregateInRange(start, end).GetSum(Metric::Import);
+}
+
+/**
+ * @brief Oblicza sumę zużycia energii w zadanym przedziale czasowym.
+ *
+ * @param start Data i godzina początku przedziału.
+ * @param end Data i godzina końca przedziału.
+ * @return Suma zużycia w przedziale [kWh].
+ */
+long double EnergyAnalyzer::CalculateConsumptionSumInRange(const DateTime *start, const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    return AggregateInRange(start, end).GetSum(Metric::Consumption);
+}
+
+/**
+ * @brief Oblicza sumę produkcji energii w zadanym przedziale czasowym.
+ *
+ * @param start Data i godzina początku przedziału.
+ * @param end Data i godzina końca przedziału.
+ * @return Suma produkcji w przedziale [kWh].
+ */
+long double EnergyAnalyzer::CalculateGenerationSumInRange(const DateTime *start, const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    return AggregateInRange(start, end).GetSum(Metric::Generation);
+}
+
+/**
+ * @brief Oblicza średnią autokonsumpcji w zadanym przedziale czasowym.
+ *
+ * @param start Data i godzina początku przedziału.
+ * @param end Data i godzina końca przedziału.
+ * @return Średnia autokonsumpcja w przedziale [kWh].
+ */
+long double EnergyAnalyzer::CalculateAutoConsumptionAvgInRange(const DateTime *start, const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    const Aggregate aggregate = AggregateInRange(start, end);
+
+    return aggregate.GetCount() == 0 ? 0 : aggregate.GetSum(Metric::AutoConsumption) / aggregate.GetCount();
+}
+
+/**
+ * @brief Oblicza średni eksport energii w zadanym przedziale czasowym.
+ *
+ * @param start Data i godzina początku przedziału.
+ * @param end Data i godzina końca przedziału.
+ * @return Średni eksport w przedziale [kWh].
+ */
+long double EnergyAnalyzer::CalculateEksportAvgInRange(const DateTime *start, const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    const Aggregate aggregate = AggregateInRange(start, end);
+
+    return aggregate.GetCount() == 0 ? 0 : aggregate.GetSum(Metric::Export) / aggregate.GetCount();
+}
+
+/**
+ * @brief Oblicza średni import energii w zadanym przedziale czasowym.
+ *
+ * @param start Data i godzina początku przedziału.
+ * @param end Data i godzina końca przedziału.
+ * @return Średni import w przedziale [kWh].
+ */
+long double EnergyAnalyzer::CalculateImportAvgInRange(const DateTime *start, const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    const Aggregate aggregate = AggregateInRange(start, end);
+
+    return aggregate.GetCount() == 0 ? 0 : aggregate.GetSum(Metric::Import) / aggregate.GetCount();
+}
+
+/**
+ * @brief Oblicza średnie zużycie energii (pobór) w zadanym przedziale czasowym.
+ *
+ * Funkcja wyznacza agregat danych z zadanego przedziału czasowego (patrz
+ * `AggregateInRange`) i dzieli sumę zużycia energii (poboru) przez liczbę rekordów,
+ * aby uzyskać średnie zużycie.
+ *
+ * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+ * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+ * @return Średnie zużycie energii w zadanym przedziale czasowym lub 0, jeśli w przedziale
+ *         nie znaleziono żadnych rekordów.
+ */
+long double EnergyAnalyzer::CalculateConsumptionAvgInRange(const DateTime *start, const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    const Aggregate aggregate = AggregateInRange(start, end);
+
+    return aggregate.GetCount() == 0 ? 0 : aggregate.GetSum(Metric::Consumption) / aggregate.GetCount();
+}
+
+/**
+ * @brief Oblicza średnią produkcję energii w zadanym przedziale czasowym.
+ *
+ * @param start Data i godzina początku przedziału.
+ * @param end Data i godzina końca przedziału.
+ * @return Średnia produkcja w przedziale [kWh].
+ */
+long double EnergyAnalyzer::CalculateGenerationAvgInRange(const DateTime *start, const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    const Aggregate aggregate = AggregateInRange(start, end);
+
+    return aggregate.GetCount() == 0 ? 0 : aggregate.GetSum(Metric::Generation) / aggregate.GetCount();
+}
+
+/**
+ * @brief Porównuje sumy autokonsumpcji dla dwóch przedziałów czasowych i wypisuje wynik na standardowe wyjście.
+ *
+ * @param start_1 Data i godzina początku pierwszego przedziału.
+ * @param end_1 Data i godzina końca pierwszego przedziału.
+ * @param start_2 Data i godzina początku drugiego przedziału.
+ * @param end_2 Data i godzina końca drugiego przedziału.
+ */
+void EnergyAnalyzer::CompareAutoConsumption(const DateTime *start_1, const DateTime *end_1, const DateTime *start_2, const DateTime *end_2) const {
+    const ReadLock lock(*this);
+
+    CommandParser::PrintComparison(Metric::AutoConsumption, *start_1, *end_1, CalculateAutoConsumptionSumInRange(start_1, end_1), *start_2, *end_2,
+                                   CalculateAutoConsumptionSumInRange(start_2, end_2));
+}
+
+/**
+ * @brief Porównuje sumy eksportu energii dla dwóch przedziałów czasowych i wypisuje wynik na standardowe wyjście.
+ *
+ * @param start_1 Data i godzina początku pierwszego przedziału.
+ * @param end_1 Data i godzina końca pierwszego przedziału.
+ * @param start_2 Data i godzina początku drugiego przedziału.
+ * @param end_2 Data i godzina końca drugiego przedziału.
+ */
+void EnergyAnalyzer::CompareEksport(const DateTime *start_1, const DateTime *end_1, const DateTime *start_2, const DateTime *end_2) const {
+    const ReadLock lock(*this);
+
+    CommandParser::PrintComparison(Metric::Export, *start_1, *end_1, CalculateEksportSumInRange(start_1, end_1), *start_2, *end_2,
+                                   CalculateEksportSumInRange(start_2, end_2));
+}
+
+/**
+ * @brief Porównuje sumy importu energii dla dwóch przedziałów czasowych i wypisuje wynik na standardowe wyjście.
+ *
+ * @param start_1 Data i godzina początku pierwszego przedziału.
+ * @param end_1 Data i godzina końca pierwszego przedziału.
+ * @param start_2 Data i godzina początku drugiego przedziału.
+ * @param end_2 Data i godzina końca drugiego przedziału.
+ */
+void EnergyAnalyzer::CompareImport(const DateTime *start_1, const DateTime *end_1, const DateTime *start_2, const DateTime *end_2) const {
+    const ReadLock lock(*this);
+
+    CommandParser::PrintComparison(Metric::Import, *start_1, *end_1, CalculateImportSumInRange(start_1, end_1), *start_2, *end_2,
+                                   CalculateImportSumInRange(start_2, end_2));
+}
+
+/**
+ * @brief Porównuje sumy zużycia energii dla dwóch przedziałów czasowych i wypisuje wynik na standardowe wyjście.
+ *
+ * @param start_1 Data i godzina początku pierwszego przedziału.
+ * @param end_1 Data i godzina końca pierwszego przedziału.
+ * @param start_2 Data i godzina początku drugiego przedziału.
+ * @param end_2 Data i godzina końca drugiego przedziału.
+ */
+void EnergyAnalyzer::CompareConsumption(const DateTime *start_1, const DateTime *end_1, const DateTime *start_2, const DateTime *end_2) const {
+    const ReadLock lock(*this);
+
+    CommandParser::PrintComparison(Metric::Consumption, *start_1, *end_1, CalculateConsumptionSumInRange(start_1, end_1), *start_2, *end_2,
+                                   CalculateConsumptionSumInRange(start_2, end_2));
+}
+
+/**
+ * @brief Porównuje sumy produkcji energii dla dwóch przedziałów czasowych i wypisuje wynik na standardowe wyjście.
+ *
+ * @param start_1 Data i godzina początku pierwszego przedziału.
+ * @param end_1 Data i godzina końca pierwszego przedziału.
+ * @param start_2 Data i godzina początku drugiego przedziału.
+ * @param end_2 Data i godzina końca drugiego przedziału.
+ */
+void EnergyAnalyzer::CompareGeneration(const DateTime *start_1, const DateTime *end_1, const DateTime *start_2, const DateTime *end_2) const {
+    const ReadLock lock(*this);
+
+    CommandParser::PrintComparison(Metric::Generation, *start_1, *end_1, CalculateGenerationSumInRange(start_1, end_1), *start_2, *end_2,
+                                   CalculateGenerationSumInRange(start_2, end_2));
+}
+
+/**
+ * @brief Wyszukuje i wypisuje na ekran rekordy, w których wartość autokonsumpcji mieści się w zadanym zakresie z tolerancją, w określonym przedziale czasowym.
+ *
+ * @param target Szukana wartość autokonsumpcji.
+ * @param tolerance Zakres tolerancji wokół szukanej wartości.
+ * @param start Data i godzina początku przedziału czasowego.
+ * @param end Data i godzina końca przedziału czasowego.
+ */
+void EnergyAnalyzer::SearchByAutoConsumptionWithTolerance(const long double target, const long double tolerance, const DateTime *start, const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    cout << fixed << setprecision(4) << "Szukam autokonsumpcji w zakresie " << target - tolerance << " - " << target + tolerance
+         << " w przedziale czasowym od " << start->ToString() << " do " << end->ToString() << ":" << endl;
+
+    ForEachDataInRange(start, end, [&](const DateTime &dateTime, const Data &data) {
+        // Sprawdź, czy wartość mieści się w zakresie z tolerancją
+        if (data.GetAutoConsumption() >= target - tolerance && data.GetAutoConsumption() <= target + tolerance) {
+            cout << fixed << setprecision(4) << "  - Znaleziono rekord: Data i godzina: "
+                 << dateTime.GetYear() << "-" << dateTime.GetMonth() << "-" << dateTime.GetDay() << " "
+                 << dateTime.GetHour() << ":" << dateTime.GetMinute()
+                 << ", Autokonsumpcja: " << data.GetAutoConsumption() << endl;
+        }
+    }, [&](const Aggregate &aggregate) {
+        // Pomiń lata, miesiące, dni i kubełki, których zakres wartości nie obejmuje szukanego.
+        return aggregate.MayContain(Metric::AutoConsumption, target - tolerance, target + tolerance);
+    });
+}
+
+/**
+ * @brief Wyszukuje i wypisuje na ekran rekordy, w których wartość eksportu mieści się w zadanym zakresie z tolerancją, w określonym przedziale czasowym.
+ *
+ * @param target Szukana wartość eksportu.
+ * @param tolerance Zakres tolerancji wokół szukanej wartości.
+ * @param start Data i godzina początku przedziału czasowego.
+ * @param end Data i godzina końca przedziału czasowego.
+ */
+void EnergyAnalyzer::SearchByExportWithTolerance(const long double target, const long double tolerance, const DateTime *start, const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    cout << fixed << setprecision(4) << "Szukam eksportu w zakresie " << target - tolerance << " - " << target + tolerance
+         << " w przedziale czasowym od " << start->ToString() << " do " << end->ToString() << ":" << endl;
+
+    ForEachDataInRange(start, end, [&](const DateTime &dateTime, const Data &data) {
+        // Sprawdź, czy wartość mieści się w zakresie z tolerancją
+        if (data.GetExport() >= target - tolerance && data.GetExport() <= target + tolerance) {
+            cout << fixed << setprecision(4) << "  - Znaleziono rekord: Data i godzina: "
+                 << dateTime.GetYear() << "-" << dateTime.GetMonth() << "-" << dateTime.GetDay() << " "
+                 << dateTime.GetHour() << ":" << dateTime.GetMinute()
+                 << ", Eksport: " << data.GetExport() << endl;
+        }
+    }, [&](const Aggregate &aggregate) {
+        // Pomiń lata, miesiące, dni i kubełki, których zakres wartości nie obejmuje szukanego.
+        return aggregate.MayContain(Metric::Export, target - tolerance, target + tolerance);
+    });
+}
+
+/**
+ * @brief Wyszukuje i wypisuje na ekran rekordy, w których wartość importu mieści się w zadanym zakresie z tolerancją, w określonym przedziale czasowym.
+ *
+ * @param target Szukana wartość importu.
+ * @param tolerance Zakres tolerancji wokół szukanej wartości.
+ * @param start Data i godzina początku przedziału czasowego.
+ * @param end Data i godzina końca przedziału czasowego.
+ */
+void EnergyAnalyzer::SearchByImportWithTolerance(const long double target, const long double tolerance, const DateTime *start, const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    cout << fixed << setprecision(4) << "Szukam importu w zakresie " << target - tolerance << " - " << target + tolerance
+         << " w przedziale czasowym od " << start->ToString() << " do " << end->ToString() << ":" << endl;
+
+    ForEachDataInRange(start, end, [&](const DateTime &dateTime, const Data &data) {
+        // Sprawdź, czy wartość mieści się w zakresie z tolerancją
+        if (data.GetImport() >= target - tolerance && data.GetImport() <= target + tolerance) {
+            cout << fixed << setprecision(4) << "  - Znaleziono rekord: Data i godzina: "
+                 << dateTime.GetYear() << "-" << dateTime.GetMonth() << "-" << dateTime.GetDay() << " "
+                 << dateTime.GetHour() << ":" << dateTime.GetMinute()
+                 << ", Import: " << data.GetImport() << endl;
+        }
+    }, [&](const Aggregate &aggregate) {
+        // Pomiń lata, miesiące, dni i kubełki, których zakres wartości nie obejmuje szukanego.
+        return aggregate.MayContain(Metric::Import, target - tolerance, target + tolerance);
+    });
+}
+
+/**
+ * @brief Wyszukuje i wypisuje na ekran rekordy, w których wartość zużycia (poboru) mieści się w zadanym zakresie z tolerancją, w określonym przedziale czasowym.
+ *
+ * @param target Szukana wartość zużycia.
+ * @param tolerance Zakres tolerancji wokół szukanej wartości.
+ * @param start Data i godzina początku przedziału czasowego.
+ * @param end Data i godzina końca przedziału czasowego.
+ */
+void EnergyAnalyzer::SearchByConsumptionWithTolerance(const long double target, const long double tolerance, const DateTime *start, const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    cout << fixed << setprecision(4) << "Szukam zużycia w zakresie " << target - tolerance << " - " << target + tolerance
+         << " w przedziale czasowym od " << start->ToString() << " do " << end->ToString() << ":" << endl;
+
+    ForEachDataInRange(start, end, [&](const DateTime &dateTime, const Data &data) {
+        // Sprawdź, czy wartość mieści się w zakresie z tolerancją
+        if (data.GetConsumption() >= target - tolerance && data.GetConsumption() <= target + tolerance) {
+            cout << fixed << setprecision(4) << "  - Znaleziono rekord: Data i godzina: "
+                 << dateTime.GetYear() << "-" << dateTime.GetMonth() << "-" << dateTime.GetDay() << " "
+                 << dateTime.GetHour() << ":" << dateTime.GetMinute()
+                 << ", Zużycie: " << data.GetConsumption() << endl;
+        }
+    }, [&](const Aggregate &aggregate) {
+        // Pomiń lata, miesiące, dni i kubełki, których zakres wartości nie obejmuje szukanego.
+        return aggregate.MayContain(Metric::Consumption, target - tolerance, target + tolerance);
+    });
+}
+
+/**
+ * @brief Wyszukuje i wypisuje na ekran rekordy, w których wartość produkcji mieści się w zadanym zakresie z tolerancją, w określonym przedziale czasowym.
+ *
+ * @param target Szukana wartość produkcji.
+ * @param tolerance Zakres tolerancji wokół szukanej wartości.
+ * @param start Data i godzina początku przedziału czasowego.
+ * @param end Data i godzina końca przedziału czasowego.
+ */
+void EnergyAnalyzer::SearchByGenerationWithTolerance(const long double target, const long double tolerance, const DateTime *start, const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    cout << fixed << setprecision(4) << "Szukam produkcji w zakresie " << target - tolerance << " - " << target + tolerance
+         << " w przedziale czasowym od " << start->ToString() << " do " << end->ToString() << ":" << endl;
+
+    ForEachDataInRange(start, end, [&](const DateTime &dateTime, const Data &data) {
+        // Sprawdź, czy wartość mieści się w zakresie z tolerancją
+        if (data.GetGeneration() >= target - tolerance && data.GetGeneration() <= target + tolerance) {
+            cout << fixed << setprecision(4) << "  - Znaleziono rekord: Data i godzina: "
+                 << dateTime.GetYear() << "-" << dateTime.GetMonth() << "-" << dateTime.GetDay() << " "
+                 << dateTime.GetHour() << ":" << dateTime.GetMinute()
+                 << ", Produkcja: " << data.GetGeneration() << endl;
+        }
+    }, [&](const Aggregate &aggregate) {
+        // Pomiń lata, miesiące, dni i kubełki, których zakres wartości nie obejmuje szukanego.
+        return aggregate.MayContain(Metric::Generation, target - tolerance, target + tolerance);
+    });
+}
+
+/**
+ * @brief Wypisuje wszystkie dane z zadanego przedziału czasowego.
+ *
+ * Funkcja iteruje przez strukturę danych (lata, miesiące, dni, kwadranse)
+ * i wypisuje na standardowe wyjście wszystkie rekordy danych, które mieszczą się
+ * w zadanym przedziale czasowym.
+ *
+ * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+ * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+ */
+void EnergyAnalyzer::PrintAllDataInRange(const DateTime *start, const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    ForEachDataInRange(start, end, [](const DateTime &dateTime, const Data &data) {
+        cout << dateTime.GetYear() << "-" << dateTime.GetMonth() << "-" << dateTime.GetDay() << " ";
+        cout << dateTime.GetHour() << ":" << dateTime.GetMinute() << "";
+        cout << ", Autokonsumpcja: " << fixed << setprecision(4) << data.GetAutoConsumption() << "";
+        cout << ", Export: " << fixed << setprecision(4) << data.GetExport();
+        cout << ", Import: " << fixed << setprecision(4) << data.GetImport() << "";
+        cout << ", Pobór: " << fixed << setprecision(4) << data.GetConsumption() << "";
+        cout << ", Produkcja: " << fixed << setprecision(4) << data.GetGeneration() << endl;
+    });
+}
+
+/**
+ * @brief Wywołuje funkcję dla każdego słowa map obecności dni z przedziału czasowego [start, end].
+ *
+ * Dni istniejące w strukturze danych są najpierw zbierane w kolejności chronologicznej,
+ * a następnie kalendarz przedziału jest przechodzony dzień po dniu z kursorem na tej liście.
+ *
+ * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+ * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+ * @param visitor Funkcja wywoływana jako `visitor(int64_t firstSlot, uint64_t present, uint64_t expected)`.
+ */
+template<typename Visitor>
+void EnergyAnalyzer::ForEachPresenceWord(const DateTime *start, const DateTime *end, Visitor &&visitor) const {
+    const auto toDays = [](const DateTime *dateTime) {
+        return chrono::sys_days(chrono::year(dateTime->GetYear()) / dateTime->GetMonth() / dateTime->GetDay());
+    };
+
+    const chrono::sys_days first = toDays(start), last = toDays(end);
+    // Pierwszy slot zaczynający się nie wcześniej niż `start` i ostatni zaczynający się nie później niż `end`.
+    const int firstSlot = (start->GetHour() * 60 + start->GetMinute() + Quarter::SlotMinutes - 1) / Quarter::SlotMinutes;
+    const int lastSlot = (end->GetHour() * 60 + end->GetMinute()) / Quarter::SlotMinutes;
+
+    if (first > last) return;
+
+    const int startDate = (start->GetYear() * 100 + start->GetMonth()) * 100 + start->GetDay();
+    const int endDate = (end->GetYear() * 100 + end->GetMonth()) * 100 + end->GetDay();
+    vector<pair<chrono::sys_days, const Day *> > stored;
+
+    for (const Year *year: *_years) {
+        if (year->GetYear() < start->GetYear() || year->GetYear() > end->GetYear()) continue;
+
+        for (const Month *month: year->GetMonths()) {
+            const int monthDate = year->GetYear() * 100 + month->GetMonth();
+
+            if (monthDate < startDate / 100 || monthDate > endDate / 100) continue;
+
+            for (const Day *day: month->GetDays()) {
+                if (const int date = monthDate * 100 + day->GetDay(); date >= startDate && date <= endDate)
+                    stored.emplace_back(chrono::year(year->GetYear()) / month->GetMonth() / day->GetDay(), day);
+            }
+        }
+    }
+
+    size_t cursor = 0;
+
+    for (chrono::sys_days date = first; date <= last; date += chrono::days(1)) {
+        const Day *day = nullptr;
+
+        if (cursor < stored.size() && stored[cursor].first == date) day = stored[cursor++].second;
+
+        const int from = date == first ? firstSlot : 0;
+        const int to = date == last ? lastSlot : Day::SlotsPerDay - 1;
+        const int64_t dayBase = (date - first).count() * static_cast<int64_t>(Day::SlotsPerDay);
+
+        for (int word = 0; word < Day::PresenceWords; ++word) {
+            const int low = max(from, word * 64), high = min(to, word * 64 + 63);
+
+            if (low > high) continue;
+
+            const int width = high - low + 1;
+            const uint64_t expected = (width == 64 ? ~uint64_t{0} : (uint64_t{1} << width) - 1) << (low - word * 64);
+            const uint64_t present = day ? day->GetPresenceWord(word) & expected : 0;
+
+            visitor(dayBase + word * 64, present, expected);
+        }
+    }
+}
+
+/**
+ * @brief Wyznacza przedziały brakujących odczytów w siatce 15-minutowych slotów.
+ *
+ * Ciągi brakujących slotów w słowie są wyznaczane instrukcjami zliczania zer i jedynek
+ * (`countr_zero`, `countr_one`), a ciąg kończący się na końcu słowa lub dnia jest
+ * przedłużany przez kolejne słowa.
+ *
+ * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+ * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+ * @return Przedziały brakujących slotów.
+ */
+vector<EnergyAnalyzer::MissingInterval> EnergyAnalyzer::FindMissingIntervals(const DateTime *start,
+                                                                            const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    const chrono::sys_days origin(chrono::year(start->GetYear()) / start->GetMonth() / start->GetDay());
+    vector<MissingInterval> intervals;
+    int64_t runStart = -1, runEnd = -1; // Bieżący ciąg brakujących slotów [runStart, runEnd).
+
+    const auto toDateTime = [&origin](const int64_t slot) {
+        const chrono::year_month_day date(origin + chrono::days(slot / Day::SlotsPerDay));
+        const int minute = static_cast<int>(slot % Day::SlotsPerDay) * Quarter::SlotMinutes;
+
+        return DateTime(static_cast<int>(static_cast<unsigned>(date.day())),
+                        static_cast<int>(static_cast<unsigned>(date.month())), static_cast<int>(date.year()),
+                        minute / 60, minute % 60);
+    };
+
+    const auto flush = [&] {
+        if (runStart >= 0)
+            intervals.push_back({toDateTime(runStart), toDateTime(runEnd - 1), static_cast<size_t>(runEnd - runStart)});
+    };
+
+    ForEachPresenceWord(start, end, [&](const int64_t firstSlot, const uint64_t present, const uint64_t expected) {
+        uint64_t missing = ~present & expected;
+
+        while (missing != 0) {
+            const int bit = countr_zero(missing);
+            const int length = countr_one(missing >> bit);
+            const int64_t slot = firstSlot + bit;
+
+            if (slot == runEnd) {
+                runEnd += length;
+            } else {
+                flush();
+                runStart = slot;
+                runEnd = slot + length;
+            }
+
+            missing = bit + length >= 64 ? 0 : missing & (~uint64_t{0} << (bit + length));
+        }
+    });
+
+    flush();
+
+    return intervals;
+}
+
+/**
+ * @brief Oblicza pokrycie przedziału czasowego odczytami.
+ *
+ * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+ * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+ * @return Liczba obecnych i oczekiwanych slotów.
+ */
+EnergyAnalyzer::Coverage EnergyAnalyzer::CalculateCoverage(const DateTime *start, const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    Coverage coverage{0, 0};
+
+    ForEachPresenceWord(start, end, [&coverage](int64_t, const uint64_t present, const uint64_t expected) {
+        coverage.Present += popcount(present);
+        coverage.Expected += popcount(expected);
+    });
+
+    return coverage;
+}
+
+/**
+ * @brief Wyszukuje największą wartość wielkości w przedziale czasowym.
+ *
+ * @param metric Wielkość.
+ * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+ * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+ * @return Wartość największa i czas jej wystąpienia.
+ */
+optional<EnergyAnalyzer::Extremum> EnergyAnalyzer::FindMaxInRange(const Metric metric, const DateTime *start,
+                                                                  const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    return FindExtremumInRange(metric, start, end, true);
+}
+
+/**
+ * @brief Wyszukuje najmniejszą wartość wielkości w przedziale czasowym.
+ *
+ * @param metric Wielkość.
+ * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+ * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+ * @return Wartość najmniejsza i czas jej wystąpienia.
+ */
+optional<EnergyAnalyzer::Extremum> EnergyAnalyzer::FindMinInRange(const Metric metric, const DateTime *start,
+                                                                  const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    return FindExtremumInRange(metric, start, end, false);
+}
+
+/**
+ * @brief Dzieli przedział czasowy na ciągłe fragmenty do równoległego przeszukiwania.
+ *
+ * Dni kalendarza przedziału są dzielone po równo, a liczba fragmentów nie przekracza liczby
+ * rdzeni procesora ani liczby dni podzielonej przez `ParallelScanDays`. Pierwszy fragment
+ * zaczyna się początkiem przedziału, ostatni kończy jego końcem, a pozostałe granice leżą
+ * o północy.
+ *
+ * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+ * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+ * @return Początki i końce kolejnych fragmentów (pusty wektor dla pustego przedziału).
+ */
+vector<pair<DateTime, DateTime> > EnergyAnalyzer::SplitRange(const DateTime *start, const DateTime *end) {
+    const chrono::sys_days first(chrono::year(start->GetYear()) / start->GetMonth() / start->GetDay());
+    const chrono::sys_days last(chrono::year(end->GetYear()) / end->GetMonth() / end->GetDay());
+
+    if (first > last) return {};
+
+    const auto toDateTime = [](const chrono::sys_days date, const int hour, const int minute) {
+        const chrono::year_month_day ymd(date);
+
+        return DateTime(static_cast<int>(static_cast<unsigned>(ymd.day())),
+                        static_cast<int>(static_cast<unsigned>(ymd.month())), static_cast<int>(ymd.year()),
+                        hour, minute);
+    };
+
+    const int64_t days = (last - first).count() + 1;
+    const int64_t count = clamp<int64_t>(days / ParallelScanDays, 1, max(1u, thread::hardware_concurrency()));
+    vector<pair<DateTime, DateTime> > parts;
+
+    for (int64_t part = 0; part < count; ++part) {
+        // Fragment obejmuje dni [first + days * part / count, first + days * (part + 1) / count).
+        const chrono::sys_days from = first + chrono::days(days * part / count);
+        const chrono::sys_days to = first + chrono::days(days * (part + 1) / count - 1);
+
+        parts.emplace_back(part == 0 ? *start : toDateTime(from, 0, 0),
+                           part == count - 1 ? *end : toDateTime(to, 23, 59));
+    }
+
+    return parts;
+}
+
+/**
+ * @brief Wywołuje funkcję dla każdego fragmentu przedziału, każdy fragment w osobnym wątku.
+ *
+ * Pojedynczy fragment jest przetwarzany w wątku wywołującym.
+ *
+ * @param count Liczba fragmentów.
+ * @param scan Funkcja wywoływana z numerem fragmentu.
+ */
+template<typename Scanner>
+void EnergyAnalyzer::RunParts(const size_t count, Scanner &&scan) {
+    if (count == 1) {
+        scan(size_t{0});
+        return;
+    }
+
+    vector<jthread> workers;
+
+    for (size_t part = 0; part < count; ++part) workers.emplace_back(scan, part);
+}
+
+/**
+ * @brief Kopiuje wartości wielkości z przedziału czasowego do jednej tablicy.
+ *
+ * Każdy fragment przedziału (`SplitRange`) jest kopiowany przez osobny wątek do własnej
+ * tablicy, a tablice fragmentów są na końcu łączone w porządku chronologicznym.
+ *
+ * @param metric Wielkość.
+ * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+ * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+ * @return Wartości z przedziału.
+ */
+vector<double> EnergyAnalyzer::ExtractValuesInRange(const Metric metric, const DateTime *start,
+                                                    const DateTime *end) const {
+    const vector<pair<DateTime, DateTime> > parts = SplitRange(start, end);
+    vector<vector<double> > slices(parts.size());
+
+    RunParts(parts.size(), [&](const size_t part) {
+        ForEachDataInRange(&parts[part].first, &parts[part].second, [&](const DateTime &, const Data &data) {
+            if (const double value = data.GetValue(metric); isfinite(value)) slices[part].push_back(value);
+        });
+    });
+
+    if (slices.size() == 1) return std::move(slices.front());
+
+    size_t total = 0;
+
+    for (const vector<double> &slice: slices) total += slice.size();
+
+    vector<double> values;
+    values.reserve(total);
+
+    for (const vector<double> &slice: slices) values.insert(values.end(), slice.begin(), slice.end());
+
+    return values;
+}
+
+/**
+ * @brief Sortuje wartości malejąco sortowaniem pozycyjnym po bitach liczb zmiennoprzecinkowych.
+ *
+ * Każda wartość jest zamieniana na 64-bitowy klucz, którego porządek jako liczby bez znaku
+ * jest odwrotny do porządku wartości: w liczbach nieujemnych odwracane są wszystkie bity poza
+ * bitem znaku, a liczby ujemne pozostają bez zmian. Klucze są sortowane stabilnie po kolejnych
+ * bajtach, od najmłodszego. Liczniki wszystkich bajtów są zbierane w jednym przebiegu, a bajty
+ * wspólne dla wszystkich kluczy (zwykle starsze bajty wykładnika) są pomijane.
+ *
+ * @param values Wartości do posortowania.
+ */
+void EnergyAnalyzer::RadixSortDescending(vector<double> &values) {
+    constexpr int DigitBits = 8;
+    constexpr int Digits = 64 / DigitBits;
+    constexpr size_t Radix = size_t{1} << DigitBits;
+    constexpr uint64_t SignBit = uint64_t{1} << 63;
+
+    // Zamiana jest odwracalna tą samą operacją.
+    const auto toggle = [](const uint64_t bits) { return bits & SignBit ? bits : bits ^ ~SignBit; };
+
+    if (values.size() < 2) return;
+
+    vector<uint64_t> keys(values.size()), buffer(values.size());
+    array<array<size_t, Radix>, Digits> counts{};
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        keys[i] = toggle(bit_cast<uint64_t>(values[i]));
+
+        for (int digit = 0; digit < Digits; ++digit) ++counts[digit][keys[i] >> digit * DigitBits & (Radix - 1)];
+    }
+
+    for (int digit = 0; digit < Digits; ++digit) {
+        const int shift = digit * DigitBits;
+        array<size_t, Radix> &offsets = counts[digit];
+
+        if (offsets[keys.front() >> shift & (Radix - 1)] == keys.size()) continue;
+
+        size_t offset = 0;
+
+        for (size_t &count: offsets) offset += exchange(count, offset);
+
+        for (const uint64_t key: keys) buffer[offsets[key >> shift & (Radix - 1)]++] = key;
+
+        keys.swap(buffer);
+    }
+
+    for (size_t i = 0; i < values.size(); ++i) values[i] = bit_cast<double>(toggle(keys[i]));
+}
+
+/**
+ * @brief Wyszukuje odczyty o największych wartościach wielkości w przedziale czasowym.
+ *
+ * Fragmenty przedziału (`SplitRange`) są przeszukiwane równolegle. Kopiec wątku ma na szczycie
+ * najgorszy z zachowanych odczytów, więc sprawdzenie, czy węzeł drzewa może go poprawić,
+ * to jedno porównanie z wartością maksymalną agregatu węzła.
+ *
+ * @param metric Wielkość.
+ * @param count Liczba szukanych odczytów.
+ * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+ * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+ * @return Odczyty uporządkowane malejąco według wartości.
+ */
+vector<EnergyAnalyzer::Extremum> EnergyAnalyzer::FindTopInRange(const Metric metric, const size_t count,
+                                                                const DateTime *start, const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    // Porządek odczytów: większa wartość, a przy równych - wcześniejszy odczyt.
+    const auto better = [](const Extremum &a, const Extremum &b) {
+        return a.Value > b.Value || (a.Value == b.Value && a.When.GetSortKey() < b.When.GetSortKey());
+    };
+
+    if (count == 0) return {};
+
+    const vector<pair<DateTime, DateTime> > parts = SplitRange(start, end);
+    vector<vector<Extremum> > heaps(parts.size());
+
+    const auto scan = [&](const size_t part) {
+        const DateTime &partStart = parts[part].first, &partEnd = parts[part].second;
+        vector<Extremum> &heap = heaps[part];
+
+        ForEachDataInRange(&partStart, &partEnd, [&](const DateTime &dateTime, const Data &data) {
+            const Extremum candidate{dateTime, data.GetValue(metric)};
+
+            if (isnan(candidate.Value)) return;
+
+            if (heap.size() < count) {
+                heap.push_back(candidate);
+                ranges::push_heap(heap, better);
+            } else if (better(candidate, heap.front())) {
+                ranges::pop_heap(heap, better);
+                heap.back() = candidate;
+                ranges::push_heap(heap, better);
+            }
+        }, [&](const Aggregate &aggregate) {
+            return aggregate.GetCount() > 0 && (heap.size() < count || aggregate.GetMax(metric) > heap.front().Value);
+        });
+    };
+
+    RunParts(parts.size(), scan);
+
+    vector<Extremum> result;
+
+    for (const vector<Extremum> &heap: heaps) result.insert(result.end(), heap.begin(), heap.end());
+
+    ranges::sort(result, better);
+
+    if (result.size() > count) result.erase(result.begin() + static_cast<ptrdiff_t>(count), result.end());
+
+    return result;
+}
+
+/**
+ * @brief Grupuje odczyty z przedziału czasowego według czasu i oblicza agregat każdej grupy.
+ *
+ * Przejście drzewa odpowiada `AggregateInRange`: klucz grupy jest wyznaczany raz dla miesiąca
+ * i dnia, a dla odczytów i kubełków - tylko przy grupowaniu po godzinach. Agregaty węzłów są
+ * dokładane do grupy, gdy węzeł leży w całości w przedziale i w jednej grupie; pozostałe
+ * odczyty są dodawane pojedynczo.
+ *
+ * @param grouping Sposób grupowania.
+ * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+ * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+ * @return Niepuste grupy uporządkowane rosnąco według klucza.
+ */
+vector<EnergyAnalyzer::Group> EnergyAnalyzer::GroupInRange(const Grouping grouping, const DateTime *start,
+                                                           const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    const vector<pair<DateTime, DateTime> > parts = SplitRange(start, end);
+    vector<map<int, Aggregate> > tables(parts.size());
+
+    const auto scan = [&](const size_t part) {
+        const DateTime &partStart = parts[part].first, &partEnd = parts[part].second;
+        const int startDate = (partStart.GetYear() * 100 + partStart.GetMonth()) * 100 + partStart.GetDay();
+        const int endDate = (partEnd.GetYear() * 100 + partEnd.GetMonth()) * 100 + partEnd.GetDay();
+        const int startMinute = partStart.GetHour() * 60 + partStart.GetMinute();
+        const int endMinute = partEnd.GetHour() * 60 + partEnd.GetMinute();
+        map<int, Aggregate> &table = tables[part];
+
+        // Czy wszystkie minuty dni od firstDate do lastDate należą do przedziału.
+        const auto covers = [&](const int firstDate, const int lastDate) {
+            return (firstDate > startDate || (firstDate == startDate && startMinute <= 0)) &&
+                   (lastDate < endDate || (lastDate == endDate && endMinute >= 24 * 60 - 1));
+        };
+
+        for (const Year *year: *_years) {
+            if (year->GetYear() < partStart.GetYear() || year->GetYear() > partEnd.GetYear()) continue;
+
+            for (const Month *month: year->GetMonths()) {
+                const int monthDate = year->GetYear() * 100 + month->GetMonth();
+
+                if (monthDate < startDate / 100 || monthDate > endDate / 100) continue;
+
+                if (grouping == Grouping::Month && covers(monthDate * 100 + 1, GetLastDate(monthDate))) {
+                    table[monthDate].Merge(month->GetAggregate());
+                    continue;
+                }
+
+                for (const Day *day: month->GetDays()) {
+                    const int date = monthDate * 100 + day->GetDay();
+
+                    if (date < startDate || date > endDate) continue;
+
+                    int dayKey = -1;
+
+                    if (grouping == Grouping::Day) dayKey = date;
+                    else if (grouping == Grouping::Month) dayKey = monthDate;
+                    else if (grouping == Grouping::DayOfWeek)
+                        dayKey = DateTime(day->GetDay(), month->GetMonth(), year->GetYear(), 0, 0).GetDayOfWeek();
+
+                    if (grouping != Grouping::HourOfDay && covers(date, date)) {
+                        table[dayKey].Merge(day->GetAggregate());
+                        continue;
+                    }
+
+                    const int fromMinute = date == startDate ? startMinute : 0;
+                    const int toMinute = date == endDate ? endMinute : 24 * 60 - 1;
+
+                    if (fromMinute > toMinute) continue;
+
+                    const auto add = [&](const Data &data) {
+                        const int minute = data.GetTime().GetMinuteOfDay();
+
+                        if (minute >= fromMinute && minute <= toMinute)
+                            table[grouping == Grouping::HourOfDay ? data.GetTime().GetHour() : dayKey].Add(data);
+                    };
+
+                    if (day->IsCompressed()) {
+                        for (const Data &data: day->GetBlock()->Decode()) add(data);
+                        continue;
+                    }
+
+                    const vector<Quarter *> &quarters = day->GetQuarters();
+                    const int bucketMinutes = day->GetBucketMinutes();
+                    // Kubełek mieści się w jednej godzinie (także z dołożonymi slotami godziny powtarzanej).
+                    const bool hourly = bucketMinutes <= 60 && 60 % bucketMinutes == 0;
+                    const size_t lastQuarter = min<size_t>(toMinute / bucketMinutes, quarters.size() - 1);
+
+                    for (size_t i = fromMinute / bucketMinutes; i <= lastQuarter; ++i) {
+                        const Quarter *quarter = quarters[i];
+                        const int repeatedHour = quarter->GetRepeatedHour();
+                        const int firstMinute = repeatedHour >= 0
+                                                    ? min<int>(i * bucketMinutes, repeatedHour * 60)
+                                                    : static_cast<int>(i * bucketMinutes);
+
+                        if ((grouping != Grouping::HourOfDay || hourly) && firstMinute >= fromMinute &&
+                            static_cast<int>((i + 1) * bucketMinutes) - 1 <= toMinute) {
+                            table[grouping == Grouping::HourOfDay ? static_cast<int>(i * bucketMinutes / 60) : dayKey]
+                                    .Merge(quarter->GetAggregate());
+                            continue;
+                        }
+
+                        for (const optional<Data> &data: quarter->GetData()) {
+                            if (data.has_value()) add(*data);
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    RunParts(parts.size(), scan);
+
+    map<int, Aggregate> merged;
+
+    for (const map<int, Aggregate> &table: tables) {
+        for (const auto &[key, aggregate]: table) merged[key].Merge(aggregate);
+    }
+
+    vector<Group> groups;
+
+    for (const auto &[key, aggregate]: merged) {
+        if (aggregate.GetCount() > 0) groups.push_back({key, aggregate});
+    }
+
+    return groups;
+}
+
+/**
+ * @brief Szacuje percentyl wartości wielkości w przedziale czasowym [start, end].
+ *
+ * @param metric Wielkość.
+ * @param percentile Percentyl (0-100).
+ * @param start Data i godzina początku przedziału.
+ * @param end Data i godzina końca przedziału.
+ * @return Szacunek percentyla lub `nullopt`, jeśli w przedziale nie ma danych.
+ */
+optional<double> EnergyAnalyzer::EstimatePercentileInRange(const Metric metric, const double percentile,
+                                                           const DateTime *start, const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    const QuantileSketch sketch = SketchInRange(start, end);
+
+    if (sketch.GetCount(metric) == 0) return nullopt;
+
+    return sketch.GetPercentile(metric, percentile);
+}
+
+/**
+ * @brief Oblicza dokładny percentyl wartości wielkości w przedziale czasowym [start, end].
+ *
+ * @param metric Wielkość.
+ * @param percentile Percentyl (0-100).
+ * @param start Data i godzina początku przedziału.
+ * @param end Data i godzina końca przedziału.
+ * @return Percentyl lub `nullopt`, jeśli w przedziale nie ma danych.
+ */
+optional<double> EnergyAnalyzer::CalculatePercentileInRange(const Metric metric, const double percentile,
+                                                            const DateTime *start, const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    vector<double> values = ExtractValuesInRange(metric, start, end);
+
+    if (values.empty()) return nullopt;
+
+    const auto nth = values.begin() + static_cast<ptrdiff_t>(QuantileSketch::GetRank(percentile, values.size()) - 1);
+
+    nth_element(values.begin(), nth, values.end());
+
+    return *nth;
+}
+
+/**
+ * @brief Oblicza histogram wartości wielkości w przedziale czasowym [start, end].
+ *
+ * Numery przedziałów są liczone blokami w pętli bez zależności między iteracjami (kompilator
+ * może ją wektoryzować), a liczniki przedziałów są zwiększane w osobnej pętli po bloku.
+ *
+ * @param metric Wielkość.
+ * @param binCount Liczba przedziałów histogramu.
+ * @param start Data i godzina początku przedziału.
+ * @param end Data i godzina końca przedziału.
+ * @return Histogram lub `nullopt`, jeśli w przedziale nie ma danych.
+ */
+optional<EnergyAnalyzer::Histogram> EnergyAnalyzer::HistogramInRange(const Metric metric, const size_t binCount,
+                                                                     const DateTime *start,
+                                                                     const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    constexpr size_t BlockSize = 256;
+
+    if (binCount == 0 || binCount > MaxHistogramBins)
+        throw invalid_argument("Invalid histogram bin count: " + to_string(binCount));
+
+    const Aggregate aggregate = AggregateInRange(start, end);
+    const double low = aggregate.GetMin(metric);
+    const double high = aggregate.GetMax(metric);
+
+    if (!isfinite(low) || !isfinite(high)) return nullopt;
+
+    const vector<double> values = ExtractValuesInRange(metric, start, end);
+
+    if (values.empty()) return nullopt;
+
+    Histogram histogram{low, (high - low) / static_cast<double>(binCount), vector<size_t>(binCount)};
+    const double scale = histogram.Width > 0 ? 1 / histogram.Width : 0;
+    const auto lastBin = static_cast<uint32_t>(binCount - 1);
+    array<uint32_t, BlockSize> bins{};
+
+    for (size_t offset = 0; offset < values.size(); offset += BlockSize) {
+        const size_t size = min(BlockSize, values.size() - offset);
+
+        for (size_t i = 0; i < size; ++i)
+            bins[i] = min(static_cast<uint32_t>((values[offset + i] - low) * scale), lastBin);
+
+        for (size_t i = 0; i < size; ++i) ++histogram.Counts[bins[i]];
+    }
+
+    return histogram;
+}
+
+/**
+ * @brief Wyznacza krzywą trwania obciążenia w przedziale czasowym [start, end].
+ *
+ * Punkt `i` z `n` leży na pozycji `i · (N - 1) / (n - 1)` wartości posortowanych malejąco,
+ * gdzie `N` to liczba odczytów, więc krzywa zawsze zaczyna się wartością największą
+ * i kończy najmniejszą.
+ *
+ * @param metric Wielkość.
+ * @param pointCount Liczba punktów krzywej.
+ * @param start Data i godzina początku przedziału.
+ * @param end Data i godzina końca przedziału.
+ * @return Punkty krzywej.
+ */
+vector<EnergyAnalyzer::DurationPoint> EnergyAnalyzer::DurationCurveInRange(const Metric metric,
+                                                                            const size_t pointCount,
+                                                                            const DateTime *start,
+                                                                            const DateTime *end) const {
+    const ReadLock lock(*this);
+
+    vector<double> values = ExtractValuesInRange(metric, start, end);
+
+    if (values.empty() || pointCount == 0) return {};
+
+    RadixSortDescending(values);
+
+    const size_t count = min(pointCount, values.size());
+    vector<DurationPoint> curve;
+    curve.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const size_t position = count == 1 ? 0 : i * (values.size() - 1) / (count - 1);
+
+        curve.push_back({100.0 * static_cast<double>(position + 1) / static_cast<double>(values.size()),
+                         values[position]});
+    }
+
+    return curve;
+}
+
+/**
+ * @brief Oblicza statystyki okna kroczącego dla każdego odczytu z przedziału czasowego [start, end].
+ *
+ * Przeglądanie zaczyna się `widthMinutes - 1` minut przed `start`, aby pierwsze okna przedziału
+ * były pełne. Kolejka `window` przechowuje odczyty okna, a kolejki `minimums` i `maximums` -
+ * tylko odczyty, które mogą jeszcze zostać wartością skrajną okna (wartości rosnące, odpowiednio
+ * malejące). Każdy odczyt trafia do każdej kolejki i jest z niej usuwany co najwyżej raz.
+ *
+ * @param metric Wielkość.
+ * @param widthMinutes Szerokość okna w minutach.
+ * @param start Data i godzina początku przedziału.
+ * @param end Data i godzina końca przedziału.
+ * @param consumer Funkcja wywoływana dla kolejnych okien.
+ */
+void EnergyAnalyzer::ForEachWindowInRange(const Metric metric, const int widthMinutes, const DateTime *start,
+                                          const DateTime *end,
+                                          const function<void(const WindowPoint &)> &consumer) const {
+    const ReadLock lock(*this);
+
+    if (widthMinutes < 1 || widthMinutes > MaxWindowMinutes)
+        throw invalid_argument("Invalid window width: " + to_string(widthMinutes) + " minutes");
+
+    const auto toTime = [](const DateTime &dateTime) {
+        return chrono::sys_days(chrono::year(dateTime.GetYear()) / dateTime.GetMonth() / dateTime.GetDay()) +
+               chrono::hours(dateTime.GetHour()) + chrono::minutes(dateTime.GetMinute());
+    };
+
+    const chrono::sys_time<chrono::minutes> scanTime = toTime(*start) - chrono::minutes(widthMinutes - 1);
+    const chrono::sys_days scanDay = chrono::floor<chrono::days>(scanTime);
+    const chrono::year_month_day scanDate(scanDay);
+    const chrono::hh_mm_ss scanClock(scanTime - scanDay);
+    const DateTime scanStart(static_cast<int>(static_cast<unsigned>(scanDate.day())),
+                             static_cast<int>(static_cast<unsigned>(scanDate.month())),
+                             static_cast<int>(scanDate.year()), static_cast<int>(scanClock.hours().count()),
+                             static_cast<int>(scanClock.minutes().count()));
+
+    const uint64_t firstKey = start->GetSortKey();
+    deque<pair<chrono::sys_time<chrono::minutes>, double> > window, minimums, maximums;
+    chrono::sys_time<chrono::minutes> last = scanTime;
+    long double sum = 0;
+
+    ForEachDataInRange(&scanStart, end, [&](const DateTime &dateTime, const Data &data) {
+        const double value = data.GetValue(metric);
+
+        if (!isfinite(value)) return;
+
+        last = max(last, toTime(dateTime));
+
+        const chrono::sys_time<chrono::minutes> windowStart = last - chrono::minutes(widthMinutes);
+
+        window.emplace_back(last, value);
+        sum += value;
+
+        while (window.front().first <= windowStart) {
+            sum -= window.front().second;
+            window.pop_front();
+        }
+
+        while (!minimums.empty() && minimums.back().second >= value) minimums.pop_back();
+        while (!maximums.empty() && maximums.back().second <= value) maximums.pop_back();
+
+        minimums.emplace_back(last, value);
+        maximums.emplace_back(last, value);
+
+        while (minimums.front().first <= windowStart) minimums.pop_front();
+        while (maximums.front().first <= windowStart) maximums.pop_front();
+
+        if (dateTime.GetSortKey() >= firstKey)
+            consumer({dateTime, sum, minimums.front().second, maximums.front().second, window.size()});
+    });
+}
+
+/**
+    * @brief Wykonuje polecenie na danych energetycznych.
+    *
+    * Ta funkcja przyjmuje polecenie jako ciąg znaków i wykonuje odpowiednią
+    * akcję na danych energetycznych. Konkretne polecenia i ich działania są
+    * zdefiniowane w implementacji tej funkcji.
+    *
+    * @param command Polecenie do wykonania.
+*/
+void EnergyAnalyzer::ExecuteCommand(const string &command) const {
+    const ReadLock lock(*this);
+
+    _commandParser->ParseAndExecute(command);
+}
+
+
+/**
+ * @brief Wykonuje polecenie bez wczytywania całego pliku CSV.
+ *
+ * Polecenie jest wykonywane na tymczasowym analizatorze, do którego trafia tylko fragment
+ * pliku wskazany przez indeks. Polecenie bez poprawnej daty jest wykonywane na pustym
+ * analizatorze - zgłasza wtedy ten sam błąd co zwykłe wykonanie.
+ *
+ * @param filepath Ścieżka do pliku CSV z danymi.
+ * @param index Indeks pliku.
+ * @param command Polecenie do wykonania.
+ * @param bucketMinutes Szerokość kubełka dnia w minutach.
+ * @param duplicatePolicy Sposób rozstrzygania odczytów o tym samym znaczniku czasu.
+ */
+void EnergyAnalyzer::ExecuteIndexedCommand(const string &filepath, const SparseIndex &index, const string &command,
+                                           const int bucketMinutes, const DuplicatePolicy duplicatePolicy) {
+    if (!index.IsCurrent(filepath)) throw runtime_error("Sparse index is out of date: " + filepath);
+
+    EnergyAnalyzer analyzer(bucketMinutes, duplicatePolicy);
+    DateTime start(1, 1, 1970, 0, 0);
+    DateTime end = start;
+
+    if (CommandParser::GetCommandRange(command, start, end)) {
+        const SparseIndex::Slice slice = index.Locate(&start, &end);
+
+        analyzer.Load([&](const function<void(EnergyData &&)> &consumer) {
+            return EnergyData::ReadEnergyDataSlice(filepath, slice.Begin, slice.End, slice.Previous, consumer,
+                                                   AllColumns, LineLogging::None);
+        });
+    }
+
+    analyzer.ExecuteCommand(command);
+}
+
+
+/**
+ * @brief Wstawia rekord do struktury danych.
+ *
+ * Kolejne rekordy trafiają zwykle do tego samego dnia - jest on zapamiętywany (wraz z rokiem
+ * i miesiącem), aby nie wyszukiwać roku, miesiąca i dnia dla każdego rekordu. Jeśli slot jest
+ * już zajęty, rekordy są łączone zgodnie z polityką duplikatów (istniejący odczyt liczony
+ * jest jako jedna próbka). Odczyt spoza siatki slotów (np. 2:05) nie jest duplikatem odczytu
+ * z 2:00 - jest odrzucany i zliczany (`GetOffGridCount`).
+ *
+ * Agregaty kubełka, dnia, miesiąca i roku są aktualizowane od razu: nowy odczyt jest do nich
+ * dodawany w stałym czasie, a po zastąpieniu odczytu zmieniają się o różnicę wartości
+ * (`RebuildAggregates`).
+ * Ze szkiców dnia, miesiąca i roku zastąpiony odczyt jest po prostu usuwany.
+ *
+ * @param record Rekord do wstawienia.
+ * @param policy Sposób rozstrzygania kolizji z odczytem już zapisanym w slocie.
+ * @param samples Liczba odczytów, z których powstał rekord.
+ * @return true, jeśli rekord został dodany lub zmienił istniejący odczyt, false w przeciwnym razie.
+ */
+bool EnergyAnalyzer::InsertData(const EnergyData &record, const DuplicatePolicy policy, const int samples) {
+    const DateTime &dateTime = record.GetDateTime();
+
+    if (!dateTime.IsValid()) return false;
+
+    if (dateTime.GetMinute() % Quarter::SlotMinutes != 0) {
+        ++_offGridCount;
+        return false;
+    }
+
+    if (const int date = (dateTime.GetYear() * 100 + dateTime.GetMonth()) * 100 + dateTime.GetDay();
+        _currentDay == nullptr || date != _currentDate) {
+        MoveCursor(dateTime);
+        _currentDate = date;
+    }
+
+    // Nowy dzień trafia do struktury dopiero po przyjęciu rekordu, więc odrzucony rekord nie zostawia pustych węzłów.
+    Day *created = _currentDay == nullptr ? new Day(dateTime.GetDay(), _bucketMinutes) : nullptr;
+    Day *day = created ? created : _currentDay;
+
+    // Do skompresowanego dnia (dane historyczne) można wstawić rekord dopiero po jego rozpakowaniu.
+    day->Decompress();
+
+    const Time time(dateTime.GetHour(), dateTime.GetMinute(), dateTime.IsRepeated());
+    Quarter *quarter = day->GetQuarter(time);
+    optional<Data> *slot = quarter ? quarter->GetSlot(time) : nullptr;
+
+    if (slot == nullptr) {
+        delete created;
+        return false;
+    }
+
+    if (created) AttachDay(dateTime, created);
+
+    if (!slot->has_value()) {
+        slot->emplace(time, record.GetAutoConsumption(), record.GetExport(), record.GetImport(),
+                      record.GetConsumption(), record.GetGeneration());
+        _currentDay->MarkPresent(time);
+        _cube.Add(dateTime, **slot);
+
+        for (Aggregate *aggregate: {
+                 &quarter->GetAggregate(), &_currentDay->GetAggregate(), &_currentMonth->GetAggregate(),
+                 &_currentYear->GetAggregate()
+             })
+            aggregate->Add(**slot);
+
+        for (QuantileSketch *sketch: {
+                 &_currentDay->GetSketch(), &_currentMonth->GetSketch(), &_currentYear->GetSketch()
+             })
+            sketch->Add(**slot);
+
+        return true;
+    }
+
+    if (policy == DuplicatePolicy::KeepFirst) return false;
+
+    const Data previous = **slot;
+    const EnergyData merged = DuplicateResolver::Merge(policy,
+                                                       EnergyData(dateTime, previous.GetAutoConsumption(),
+                                                                  previous.GetExport(), previous.GetImport(),
+                                                                  previous.GetConsumption(), previous.GetGeneration()),
+                                                       1, record, samples);
+    const initializer_list<QuantileSketch *> sketches = {
+        &_currentDay->GetSketch(), &_currentMonth->GetSketch(), &_currentYear->GetSketch()
+    };
+
+    for (QuantileSketch *sketch: sketches) sketch->Remove(previous);
+
+    slot->emplace(time, merged.GetAutoConsumption(), merged.GetExport(), merged.GetImport(),
+                  merged.GetConsumption(), merged.GetGeneration());
+
+    for (QuantileSketch *sketch: sketches) sketch->Add(**slot);
+
+    RebuildAggregates(*quarter, previous, **slot);
+    RebuildCubeCell(dateTime, previous, **slot);
+
+    return true;
+}
+
+/**
+ * @brief Aktualizuje agregaty po zastąpieniu odczytu w kubełku.
+ *
+ * Sumy każdego poziomu (kubełek, dzień, miesiąc, rok) zmieniają się o różnicę wartości,
+ * w stałym czasie. Wartości skrajne są składane na nowo z elementów podrzędnych tylko na
+ * poziomach, na których zastąpiona wartość była wartością skrajną. Jeśli wartości skrajne
+ * poziomu się nie zmieniły, wyższe poziomy wymagają już tylko zmiany sum - każdy z nich
+ * zawiera ten poziom, więc jego wartości skrajne nadal są osiągane.
+ *
+ * @param quarter Kubełek bieżącego dnia, w którym zastąpiono odczyt.
+ * @param previous Zastąpiony odczyt.
+ * @param current Nowy odczyt.
+ */
+void EnergyAnalyzer::RebuildAggregates(const Quarter &quarter, const Data &previous, const Data &current) const {
+    const array<pair<Aggregate *, function<void(Aggregate &)> >, 4> levels = {
+        {
+            {
+                &quarter.GetAggregate(), [&quarter](Aggregate &rebuilt) {
+                    for (const optional<Data> &data: quarter.GetData())
+                        if (data.has_value()) rebuilt.Add(*data);
+                }
+            },
+            {
+                &_currentDay->GetAggregate(), [this](Aggregate &rebuilt) {
+                    for (const Quarter *dayQuarter: _currentDay->GetQuarters()) rebuilt.Merge(dayQuarter->GetAggregate());
+                }
+            },
+            {
+                &_currentMonth->GetAggregate(), [this](Aggregate &rebuilt) {
+                    for (const Day *day: _currentMonth->GetDays()) rebuilt.Merge(day->GetAggregate());
+                }
+            },
+            {
+                &_currentYear->GetAggregate(), [this](Aggregate &rebuilt) {
+                    for (const Month *month: _currentYear->GetMonths()) rebuilt.Merge(month->GetAggregate());
+                }
+            }
+        }
+    };
+    bool extremesChanged = true;
+
+    for (const auto &[aggregate, collect]: levels) {
+        const Aggregate before = *aggregate;
+
+        if (!aggregate->Replace(previous, current) || !extremesChanged) {
+            extremesChanged = extremesChanged && !aggregate->HasSameExtremes(before);
+            continue;
+        }
+
+        Aggregate rebuilt;
+        collect(rebuilt);
+        aggregate->SetExtremes(rebuilt);
+
+        extremesChanged = !aggregate->HasSameExtremes(before);
+    }
+}
+
+/**
+ * @brief Aktualizuje komórkę kostki agregatów po zastąpieniu odczytu.
+ *
+ * Sumy komórki zmieniają się o różnicę wartości. Tylko jeśli zastąpiona wartość była
+ * wartością skrajną komórki, wartości skrajne są składane na nowo z odczytów tego slotu
+ * doby w dniach bieżącego miesiąca przypadających w ten sam dzień tygodnia - odczyty te
+ * są pobierane bezpośrednio ze slotów (`Day::GetSlot`), a rozpakowywane są jedynie dni
+ * skompresowane.
+ *
+ * @param dateTime Data i godzina zastąpionego odczytu.
+ * @param previous Zastąpiony odczyt.
+ * @param current Nowy odczyt.
+ */
+void EnergyAnalyzer::RebuildCubeCell(const DateTime &dateTime, const Data &previous, const Data &current) {
+    Aggregate &cell = _cube.GetCell(dateTime);
+
+    if (!cell.Replace(previous, current)) return;
+
+    const int hour = dateTime.GetHour();
+    const int slot = (hour * 60 + dateTime.GetMinute()) / Quarter::SlotMinutes;
+    const Time slotTime(hour, slot * Quarter::SlotMinutes % 60);
+    const Time repeatedTime(hour, slotTime.GetMinute(), true);
+    Aggregate rebuilt;
+
+    for (const Day *day: _currentMonth->GetDays()) {
+        if ((day->GetDay() - dateTime.GetDay()) % 7 != 0) continue;
+
+        if (day->IsCompressed()) {
+            for (const Data &data: day->GetBlock()->Decode()) {
+                if (data.GetTime().GetMinuteOfDay() / Quarter::SlotMinutes == slot) rebuilt.Add(data);
+            }
+            continue;
+        }
+
+        if (const optional<Data> *data = day->GetSlot(slotTime); data && data->has_value()) rebuilt.Add(**data);
+
+        // Slot drugiego wystąpienia godziny istnieje tylko w kubełku, który ją przechowuje
+        // (`Quarter::GetSlot` utworzyłby go w pozostałych).
+        if (const Quarter *quarter = day->GetQuarter(repeatedTime); quarter && quarter->GetRepeatedHour() == hour) {
+            if (const optional<Data> *data = day->GetSlot(repeatedTime); data->has_value()) rebuilt.Add(**data);
+        }
+    }
+
+    cell.SetExtremes(rebuilt);
+}
+
+/**
+ * @brief Ustawia rok, miesiąc i dzień bieżącego rekordu na elementy już istniejące w strukturze.
+ *
+ * Brakujące elementy nie są tworzone - kursor wskazuje wtedy `nullptr`, a nowy dzień jest
+ * dołączany do struktury (`AttachDay`) dopiero po przyjęciu rekordu.
+ *
+ * @param dateTime Data pomiaru.
+ */
+void EnergyAnalyzer::MoveCursor(const DateTime &dateTime) {
+    _currentYear = nullptr;
+    _currentMonth = nullptr;
+    _currentDay = nullptr;
+
+    const auto yearIt = ranges::lower_bound(*_years, dateTime.GetYear(), {}, &Year::GetYear);
+    if (yearIt == _years->end() || (*yearIt)->GetYear() != dateTime.GetYear()) return;
+
+    _currentYear = *yearIt;
+
+    const vector<Month *> &months = _currentYear->GetMonths();
+    const auto monthIt = ranges::lower_bound(months, dateTime.GetMonth(), {}, &Month::GetMonth);
+    if (monthIt == months.end() || (*monthIt)->GetMonth() != dateTime.GetMonth()) return;
+
+    _currentMonth = *monthIt;
+
+    const vector<Day *> &days = _currentMonth->GetDays();
+    const auto dayIt = ranges::lower_bound(days, dateTime.GetDay(), {}, &Day::GetDay);
+    if (dayIt == days.end() || (*dayIt)->GetDay() != dateTime.GetDay()) return;
+
+    _currentDay = *dayIt;
+}
+
+/**
+ * @brief Dołącza nowy dzień do struktury, tworząc brakujący rok i miesiąc, i ustawia na nim kursor.
+ *
+ * Lata, miesiące i dni są przechowywane w porządku rosnącym - nowe elementy są wstawiane
+ * we właściwe miejsce (wyszukiwanie binarne), więc kolejność struktury nie zależy od
+ * kolejności rekordów w pliku.
+ *
+ * @param dateTime Data pomiaru.
+ * @param day Nowy dzień (struktura przejmuje go na własność).
+ */
+void EnergyAnalyzer::AttachDay(const DateTime &dateTime, Day *day) {
+    vector<Year *> &years = *_years;
+
+    auto yearIt = ranges::lower_bound(years, dateTime.GetYear(), {}, &Year::GetYear);
+    if (yearIt == years.end() || (*yearIt)->GetYear() != dateTime.GetYear())
+        yearIt = years.insert(yearIt, new Year(dateTime.GetYear()));
+
+    vector<Month *> &months = (*yearIt)->GetMonths();
+
+    auto monthIt = ranges::lower_bound(months, dateTime.GetMonth(), {}, &Month::GetMonth);
+    if (monthIt == months.end() || (*monthIt)->GetMonth() != dateTime.GetMonth())
+        monthIt = months.insert(monthIt, new Month(dateTime.GetMonth()));
+
+    vector<Day *> &days = (*monthIt)->GetDays();
 
-    delete energyData;
+    days.insert(ranges::lower_bound(days, dateTime.GetDay(), {}, &Day::GetDay), day);
 
-    return years;
+    _currentYear = *yearIt;
+    _currentMonth = *monthIt;
+    _currentDay = day;
 }
\ No newline at end of file
@@ -3,44 +3,40 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <optional>
 #include <algorithm>
+#include <charconv>
+#include <limits>
+#include <mutex>
 #include <stdexcept>
 #include <filesystem>
 
 #include "../Headers/EnergyData.hpp"
+#include "../Headers/CompressedInput.hpp"
 
 /**
  * @brief Konstruktor klasy EnergyData.
  *
- * @param dateTime Wskaźnik do obiektu DateTime reprezentującego datę i czas pomiaru.
+ * @param dateTime Data i czas pomiaru.
  * @param autoConsumption Autokonsumpcja energii [kWh].
  * @param exportW Eksport energii [kWh].
  * @param import Import energii [kWh].
  * @param consumption Całkowite zużycie energii [kWh].
  * @param generation Produkcja energii [kWh].
  */
-EnergyData::EnergyData(DateTime *dateTime, const double autoConsumption, const double exportW,
+EnergyData::EnergyData(const DateTime &dateTime, const double autoConsumption, const double exportW,
                        const double import, const double consumption, const double generation): _dateTime(dateTime),
     _autoConsumption(autoConsumption), _export(exportW), _import(import), _consumption(consumption),
     _generation(generation) {
 }
 
-/**
- * @brief Destruktor klasy EnergyData.
- *
- * Zwalnia pamięć zajmowaną przez obiekt DateTime.
- */
-EnergyData::~EnergyData() {
-    delete _dateTime;
-}
-
 /**
  * @brief Zwraca referencję do obiektu DateTime.
  *
  * @return Referencja do obiektu DateTime.
  */
-DateTime &EnergyData::GetDateTime() const {
-    return *_dateTime;
+const DateTime &EnergyData::GetDateTime() const {
+    return _dateTime;
 }
 
 /**
@@ -92,11 +88,29 @@ double EnergyData::GetGeneration() const {
  * @brief Wczytuje dane o zużyciu energii z pliku CSV.
  *
  * @param filepath Ścieżka do pliku CSV.
- * @return Wskaźnik do wektora obiektów EnergyData.
- * @throws runtime_error Jeśli nie udało się otworzyć pliku.
+ * @param consumer Odbiorca, do którego trafia każdy sparsowany rekord.
+ * @param columns Kolumny wartości do wczytania.
+ * @param logging Zakres zapisu wczytywanych linii w plikach logów.
+ * @return Pozycja w pliku tuż za ostatnią wczytaną kompletną linią (0 dla pliku skompresowanego).
+ * @throws runtime_error Jeśli nie udało się otworzyć pliku lub plik skompresowany jest uszkodzony.
  */
-vector<EnergyData *> *EnergyData::ReadEnergyData(const string &filepath) {
-    auto *energyData = new vector<EnergyData *>();
+streamoff EnergyData::ReadEnergyData(const string &filepath, const function<void(EnergyData &&)> &consumer,
+                                     const ColumnSet columns, const LineLogging logging) {
+    // Odmiana pliku jest rozpoznawana raz - każda linia trafia do parsera wyspecjalizowanego dla niej.
+    const LineParser parser = GetLineParser(CsvDialect::DetectFile(filepath));
+
+    // Plik skompresowany jest rozpakowywany w osobnym wątku, równolegle z parsowaniem.
+    if (const CompressedInput::Format format = CompressedInput::DetectFormat(filepath);
+        format != CompressedInput::Format::None) {
+        CompressedInput input(filepath, format);
+        string_view header;
+
+        input.ReadLine(header); // Pomiń pierwszy wiersz (nagłówek)
+        ReadLines([&input](string_view &line) { return input.ReadLine(line); }, parser, nullopt, consumer, columns,
+                  logging);
+
+        return 0;
+    }
 
     ifstream inputFile(filepath);
 
@@ -104,86 +118,367 @@ vector<EnergyData *> *EnergyData::ReadEnergyData(const string &filepath) {
 
     getline(inputFile, line); // Pomiń pierwszy wiersz (nagłówek)
 
-    if (inputFile.is_open()) {
-        auto timeStr = GetCurrentDateTimeFormatted();
-
-        auto logFile = CreateFileInExecutionDir("log_" + timeStr + ".txt");
-        auto errorFile = CreateFileInExecutionDir("log_error_" + timeStr + ".txt");
-
-        while (getline(inputFile, line)) {
-            stringstream ss(line);
-
-            string dateTime, autoConsumption, exportW, import, consumption, generation;
-
-            // Pobierz poszczególne wartości z linii, rozdzielone przecinkami.
-            getline(ss, dateTime, ',');
-            getline(ss, autoConsumption, ',');
-            getline(ss, exportW, ',');
-            getline(ss, import, ',');
-            getline(ss, consumption, ',');
-            getline(ss, generation, ',');
-
-            stringstream dateTimeSS(dateTime);
-
-            string day, month, year, hour, minute;
-
-            // Rozdziel datę i godzinę na poszczególne składowe.
-            getline(dateTimeSS, day, '.');
-            getline(dateTimeSS, month, '.');
-            getline(dateTimeSS, year, ' ');
-            getline(dateTimeSS, hour, ':');
-            getline(dateTimeSS, minute, ':');
-
-            // Zamień kropki na przecinki w wartościach numerycznych.
-            ranges::replace(autoConsumption, '.', ',');
-            ranges::replace(exportW, '.', ',');
-            ranges::replace(import, '.', ',');
-            ranges::replace(consumption, '.', ',');
-            ranges::replace(generation, '.', ',');
-
-            // Usuń cudzysłowy z poszczególnych wartości.
-            erase(dateTime, '\"');
-            erase(autoConsumption, '\"');
-            erase(exportW, '\"');
-            erase(import, '\"');
-            erase(consumption, '\"');
-            erase(generation, '\"');
-
-            erase(day, '\"');
-            erase(month, '\"');
-            erase(year, '\"');
-            erase(hour, '\"');
-            erase(minute, '\"');
-
-            try {
-                // Utwórz obiekt DateTime.
-                auto *dateTimeObj = new DateTime(stoi(day), stoi(month), stoi(year), stoi(hour), stoi(minute));
-
-                // Utwórz obiekt EnergyData i dodaj go do wektora.
-                // ReSharper disable once CppDFAMemoryLeak - Uzasadnienie: Pamięć jest zwalniana w destruktorze klasy, która zarządza wektorem
-                auto *ed = new EnergyData(dateTimeObj, stod(autoConsumption), stod(exportW), stod(import),
-                                          stod(consumption), stod(generation));
-
-                energyData->push_back(ed);
-
-                logFile << "Parsed line: " << line << endl;
-            } catch (exception &e) {
-                logFile << "Error while parsing line: " << line << endl;
-                errorFile << e.what() << ": " << line << endl;
-            }
+    if (inputFile.is_open()) return ReadStream(inputFile, parser, -1, nullopt, consumer, columns, logging);
+
+    throw runtime_error("Could not open file");
+}
+
+/**
+ * @brief Wczytuje dane o zużyciu energii z fragmentu pliku CSV.
+ *
+ * @param filepath Ścieżka do pliku CSV.
+ * @param begin Pozycja początku pierwszej linii fragmentu.
+ * @param end Pozycja, od której linie nie są już wczytywane (-1 oznacza koniec pliku).
+ * @param previous Znacznik czasu linii poprzedzającej fragment.
+ * @param consumer Odbiorca, do którego trafia każdy sparsowany rekord.
+ * @param columns Kolumny wartości do wczytania.
+ * @param logging Zakres zapisu wczytywanych linii w plikach logów.
+ * @return Pozycja w pliku tuż za ostatnią wczytaną kompletną linią.
+ * @throws runtime_error Jeśli nie udało się otworzyć pliku.
+ */
+streamoff EnergyData::ReadEnergyDataSlice(const string &filepath, const streamoff begin, const streamoff end,
+                                          optional<DateTime> previous,
+                                          const function<void(EnergyData &&)> &consumer, const ColumnSet columns,
+                                          const LineLogging logging) {
+    ifstream inputFile(filepath);
+
+    if (!inputFile.is_open()) throw runtime_error("Could not open file");
+
+    inputFile.seekg(begin);
+
+    return ReadStream(inputFile, GetLineParser(CsvDialect::DetectFile(filepath)), end, std::move(previous), consumer,
+                      columns, logging);
+}
+
+/**
+ * @brief Wczytuje kolejne linie z otwartego pliku CSV.
+ *
+ * @param inputFile Plik ustawiony na początku pierwszej linii do wczytania.
+ * @param parser Parser linii odmiany pliku.
+ * @param end Pozycja, od której linie nie są już wczytywane (-1 oznacza koniec pliku).
+ * @param previous Znacznik czasu linii poprzedzającej pierwszą wczytywaną linię.
+ * @param consumer Odbiorca, do którego trafia każdy sparsowany rekord.
+ * @param columns Kolumny wartości do wczytania.
+ * @param logging Zakres zapisu wczytywanych linii w plikach logów.
+ * @return Pozycja w pliku tuż za ostatnią wczytaną kompletną linią.
+ */
+streamoff EnergyData::ReadStream(ifstream &inputFile, const LineParser parser, const streamoff end,
+                                 optional<DateTime> previous,
+                                 const function<void(EnergyData &&)> &consumer, const ColumnSet columns,
+                                 const LineLogging logging) {
+    string buffer;
+    streamoff offset = inputFile.tellg();
+
+    ReadLines([&](string_view &line) {
+        if ((end >= 0 && offset >= end) || !getline(inputFile, buffer)) return false;
+
+        // Linia bez znaku końca linii mogła zostać zapisana tylko częściowo - pozycja jej nie obejmuje.
+        if (!inputFile.eof()) offset = inputFile.tellg();
+
+        line = buffer;
+        return true;
+    }, parser, std::move(previous), consumer, columns, logging);
+
+    inputFile.close();
 
+    return offset;
+}
+
+/**
+ * @brief Parsuje kolejne linie pliku CSV i zapisuje przebieg wczytywania w plikach logów.
+ *
+ * Przy `LineLogging::ErrorsOnly` pliki logów są tworzone dopiero przy pierwszej błędnej linii,
+ * więc plik bez błędów nie tworzy ich wcale.
+ *
+ * @param nextLine Funkcja zwracająca kolejną linię (false na końcu danych).
+ * @param parser Parser linii odmiany pliku.
+ * @param previous Znacznik czasu linii poprzedzającej pierwszą wczytywaną linię.
+ * @param consumer Odbiorca, do którego trafia każdy sparsowany rekord.
+ * @param columns Kolumny wartości do wczytania.
+ * @param logging Zakres zapisu wczytywanych linii w plikach logów.
+ */
+void EnergyData::ReadLines(const function<bool(string_view &)> &nextLine, const LineParser parser,
+                           optional<DateTime> previous,
+                           const function<void(EnergyData &&)> &consumer, const ColumnSet columns,
+                           const LineLogging logging) {
+    ofstream logFile, errorFile;
+    bool logsCreated = false;
+
+    const auto createLogs = [&] {
+        // Pliki wczytywane równolegle (patrz `EnergyDataMerger`) w tej samej sekundzie nie mogą nadpisywać swoich logów.
+        static mutex logMutex;
+        lock_guard lock(logMutex);
+
+        const string timeStr = GetCurrentDateTimeFormatted();
+        string name = timeStr;
+
+        for (int i = 1; filesystem::exists(filesystem::current_path() / ("log_" + name + ".txt")); ++i)
+            name = timeStr + "_" + to_string(i);
+
+        logFile = CreateFileInExecutionDir("log_" + name + ".txt");
+        errorFile = CreateFileInExecutionDir("log_error_" + name + ".txt");
+        logsCreated = true;
+    };
+
+    if (logging == LineLogging::All) createLogs();
+
+    string_view line;
+    string error;
+
+    // `previous` to ostatni poprawnie sparsowany znacznik czasu - potrzebny do rozpoznania godziny powtarzanej przy zmianie czasu.
+    while (nextLine(line)) {
+        // Niepoprawna linia nie zgłasza wyjątku - jej obsługa kosztuje tyle co poprawnej.
+        if (optional<EnergyData> record = parser(line, previous, columns, &error)) {
+            // Przekaż rekord od razu do odbiorcy - bez pośredniego wektora.
+            consumer(std::move(*record));
+
+            if (logging == LineLogging::All) logFile << "Parsed line: " << line << '\n';
+        } else if (logging != LineLogging::None) {
+            if (!logsCreated) createLogs();
+
+            logFile << "Error while parsing line: " << line << '\n';
+            errorFile << error << ": " << line << '\n';
+        }
+
+        if (logging == LineLogging::All) {
             logFile.flush();
             errorFile.flush();
         }
+    }
+
+    logFile.close();
+    errorFile.close();
+}
+
+/**
+ * @brief Parsuje pojedynczą linię pliku CSV w odmianie eksportu falownika.
+ *
+ * @param line Linia pliku CSV.
+ * @param previous Znacznik czasu poprzedniej poprawnie sparsowanej linii (aktualizowany).
+ * @param columns Kolumny wartości do wczytania.
+ * @return Sparsowany rekord.
+ * @throws invalid_argument Jeśli linia nie zawiera poprawnych wartości.
+ */
+EnergyData EnergyData::ParseLine(const string_view line, optional<DateTime> &previous, const ColumnSet columns) {
+    string error;
+    optional<EnergyData> record = ParseLineAs<ExporterDialect.Separator, ExporterDialect.Quoted,
+        ExporterDialect.Decimal, ExporterDialect.Layout>(line, previous, columns, &error);
+
+    if (!record) throw invalid_argument(error);
 
-        inputFile.close();
-        logFile.close();
-        errorFile.close();
+    return std::move(*record);
+}
 
-        return energyData;
+/**
+ * @brief Zwraca parser linii wyspecjalizowany dla odmiany pliku CSV.
+ *
+ * @param dialect Odmiana pliku.
+ * @return Parser linii.
+ */
+EnergyData::LineParser EnergyData::GetLineParser(const CsvDialect &dialect) {
+    switch (dialect.Separator) {
+        case ';':
+            return SelectParser<';'>(dialect);
+        case '\t':
+            return SelectParser<'\t'>(dialect);
+        default:
+            return SelectParser<','>(dialect);
     }
+}
 
-    throw runtime_error("Could not open file");
+/**
+ * @brief Wybiera parser dla odmiany o danym separatorze pól.
+ *
+ * @tparam Separator Znak oddzielający pola.
+ * @param dialect Odmiana pliku.
+ * @return Parser linii.
+ */
+template <char Separator>
+EnergyData::LineParser EnergyData::SelectParser(const CsvDialect &dialect) {
+    const bool iso = dialect.Layout == DateLayout::Iso;
+
+    if (dialect.Quoted) {
+        if (dialect.Decimal == ',')
+            return iso ? &ParseLineAs<Separator, true, ',', DateLayout::Iso>
+                       : &ParseLineAs<Separator, true, ',', DateLayout::DayMonthYear>;
+
+        return iso ? &ParseLineAs<Separator, true, '.', DateLayout::Iso>
+                   : &ParseLineAs<Separator, true, '.', DateLayout::DayMonthYear>;
+    }
+
+    if (dialect.Decimal == ',')
+        return iso ? &ParseLineAs<Separator, false, ',', DateLayout::Iso>
+                   : &ParseLineAs<Separator, false, ',', DateLayout::DayMonthYear>;
+
+    return iso ? &ParseLineAs<Separator, false, '.', DateLayout::Iso>
+               : &ParseLineAs<Separator, false, '.', DateLayout::DayMonthYear>;
+}
+
+/**
+ * @brief Parsuje pojedynczą linię pliku CSV podanej odmiany.
+ *
+ * @tparam Separator Znak oddzielający pola.
+ * @tparam Quoted Czy pola mogą być ujęte w cudzysłowy.
+ * @tparam Decimal Separator dziesiętny.
+ * @tparam Layout Układ daty i godziny.
+ * @param line Linia pliku CSV.
+ * @param previous Znacznik czasu poprzedniej poprawnie sparsowanej linii (aktualizowany).
+ * @param columns Kolumny wartości do wczytania.
+ * @param error Miejsce na opis błędu (może być `nullptr`).
+ * @return Sparsowany rekord lub pusty wynik, jeśli linia nie zawiera poprawnych wartości.
+ */
+template <char Separator, bool Quoted, char Decimal, DateLayout Layout>
+optional<EnergyData> EnergyData::ParseLineAs(string_view line, optional<DateTime> &previous, const ColumnSet columns,
+                                             string *error) {
+    string_view dateTime = NextField<Separator, Quoted>(line);
+    int day = 0, month = 0, year = 0, hour = 0, minute = 0;
+
+    if constexpr (Layout == DateLayout::Iso) {
+        // Data w formacie RRRR-MM-DD, oddzielona od godziny spacją lub literą T.
+        if (!ParseInt(NextField<'-'>(dateTime), year, error) || !ParseInt(NextField<'-'>(dateTime), month, error))
+            return nullopt;
+
+        const size_t split = dateTime.find_first_of(" T");
+
+        if (!ParseInt(dateTime.substr(0, split), day, error)) return nullopt;
+        dateTime.remove_prefix(split == string_view::npos ? dateTime.size() : split + 1);
+    } else {
+        // Data w formacie DD.MM.RRRR, oddzielona od godziny spacją.
+        if (!ParseInt(NextField<'.'>(dateTime), day, error) || !ParseInt(NextField<'.'>(dateTime), month, error) ||
+            !ParseInt(NextField<' '>(dateTime), year, error))
+            return nullopt;
+    }
+
+    // Godzina w formacie GG:MM (ewentualne sekundy są pomijane).
+    if (!ParseInt(NextField<':'>(dateTime), hour, error) || !ParseInt(NextField<':'>(dateTime), minute, error))
+        return nullopt;
+
+    // Kolumny spoza projekcji są tylko przeskakiwane - bez konwersji na liczbę.
+    double values[MetricCount];
+
+    for (int i = 0; i < MetricCount; ++i) {
+        const string_view field = NextField<Separator, Quoted>(line);
+
+        values[i] = numeric_limits<double>::quiet_NaN();
+
+        if (columns & ColumnOf(static_cast<Metric>(i)) && !ParseDouble<Decimal>(field, values[i], error))
+            return nullopt;
+    }
+
+    const DateTime parsed = ResolveRepeatedHour(DateTime(day, month, year, hour, minute), previous);
+
+    previous = parsed;
+
+    return EnergyData(parsed, values[0], values[1], values[2], values[3], values[4]);
+}
+
+/**
+ * @brief Oznacza znacznik czasu jako drugie wystąpienie godziny powtarzanej przy zmianie czasu, jeśli nim jest.
+ *
+ * @param parsed Sparsowany znacznik czasu.
+ * @param previous Znacznik czasu poprzedniej poprawnie sparsowanej linii.
+ * @return Znacznik czasu rekordu.
+ */
+DateTime EnergyData::ResolveRepeatedHour(const DateTime &parsed, const optional<DateTime> &previous) {
+    // W dniu zmiany czasu z letniego na zimowy eksport zawiera godzinę 2:00-2:45 dwukrotnie.
+    // Cofnięcie się zegara w obrębie tej godziny oznacza początek jej drugiego wystąpienia.
+    if (parsed.IsFallBackDay() && parsed.GetHour() == DateTime::FallBackHour && previous.has_value() &&
+        previous->GetYear() == parsed.GetYear() && previous->GetMonth() == parsed.GetMonth() &&
+        previous->GetDay() == parsed.GetDay() && previous->GetHour() == DateTime::FallBackHour &&
+        (previous->IsRepeated() || parsed.GetMinute() <= previous->GetMinute())) {
+        return {parsed.GetDay(), parsed.GetMonth(), parsed.GetYear(), parsed.GetHour(), parsed.GetMinute(), true};
+    }
+
+    return parsed;
+}
+
+/**
+ * @brief Odcina z początku linii kolejne pole.
+ *
+ * Pole zaczynające się od cudzysłowu kończy się na cudzysłowie zamykającym, jeśli odmiana
+ * dopuszcza cudzysłowy - separator wewnątrz niego (np. przecinek dziesiętny) nie dzieli pola.
+ *
+ * @tparam Separator Znak kończący pole.
+ * @tparam Quoted Czy pole ujęte w cudzysłowy może zawierać separator.
+ * @param rest Pozostała część linii.
+ * @return Widok na zawartość pola (bez cudzysłowów i białych znaków na brzegach).
+ */
+template <char Separator, bool Quoted>
+string_view EnergyData::NextField(string_view &rest) {
+    size_t position = 0;
+
+    if constexpr (Quoted) {
+        const size_t start = rest.find_first_not_of(" \t");
+
+        if (start != string_view::npos && rest[start] == '"') position = rest.find('"', start + 1);
+        if (position == string_view::npos) position = rest.size();
+    }
+
+    position = rest.find(Separator, position);
+    string_view field = rest.substr(0, position);
+
+    rest.remove_prefix(position == string_view::npos ? rest.size() : position + 1);
+
+    const auto isPadding = [](const char c) { return c == '"' || c == ' ' || c == '\t' || c == '\r'; };
+
+    while (!field.empty() && isPadding(field.front())) field.remove_prefix(1);
+    while (!field.empty() && isPadding(field.back())) field.remove_suffix(1);
+
+    return field;
+}
+
+/**
+ * @brief Konwertuje pole na liczbę całkowitą.
+ *
+ * @param field Pole tekstowe.
+ * @param value Wartość pola.
+ * @param error Miejsce na opis błędu (może być `nullptr`).
+ * @return false, jeśli pole nie jest w całości liczbą całkowitą, true w przeciwnym razie.
+ */
+bool EnergyData::ParseInt(const string_view field, int &value, string *error) {
+    if (const auto [end, result] = from_chars(field.data(), field.data() + field.size(), value);
+        result == errc() && !field.empty() && end == field.data() + field.size())
+        return true;
+
+    if (error != nullptr) *error = "Invalid integer: '" + string(field) + "'";
+
+    return false;
+}
+
+/**
+ * @brief Konwertuje pole na liczbę zmiennoprzecinkową.
+ *
+ * Konwersja nie zależy od ustawień regionalnych programu. Przy przecinku dziesiętnym pole jest
+ * kopiowane do bufora na stosie, w którym przecinek jest zamieniany na kropkę. Pole musi być
+ * liczbą w całości - np. `1,5` przy kropce dziesiętnej jest błędem, a nie wartością 1.
+ *
+ * @tparam Decimal Separator dziesiętny.
+ * @param field Pole tekstowe.
+ * @param value Wartość pola.
+ * @param error Miejsce na opis błędu (może być `nullptr`).
+ * @return false, jeśli pole nie jest w całości liczbą, true w przeciwnym razie.
+ */
+template <char Decimal>
+bool EnergyData::ParseDouble(const string_view field, double &value, string *error) {
+    char buffer[64];
+    string_view digits = field;
+
+    if constexpr (Decimal != '.') {
+        if (field.size() <= sizeof(buffer)) {
+            ranges::replace_copy(field, buffer, Decimal, '.');
+            digits = string_view(buffer, field.size());
+        } else {
+            digits = {};
+        }
+    }
+
+    if (const auto [end, result] = from_chars(digits.data(), digits.data() + digits.size(), value);
+        result == errc() && !digits.empty() && end == digits.data() + digits.size())
+        return true;
+
+    if (error != nullptr) *error = "Invalid number: '" + string(field) + "'";
+
+    return false;
 }
 
 string EnergyData::GetCurrentDateTimeFormatted() {
@@ -0,0 +1,91 @@
+#include "../Headers/EnergyDataFollower.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+/**
+ * @brief Konstruktor klasy EnergyDataFollower.
+ *
+ * @param filepath Ścieżka do śledzonego pliku CSV.
+ * @param offset Pozycja w pliku, od której należy czytać.
+ * @param previous Znacznik czasu ostatniego rekordu przed pozycją `offset`.
+ * @param columns Kolumny wartości do wczytania.
+ */
+EnergyDataFollower::EnergyDataFollower(string filepath, const streamoff offset, optional<DateTime> previous,
+                                       const ColumnSet columns)
+    : _filepath(std::move(filepath)), _offset(offset), _previous(std::move(previous)), _columns(columns) {
+}
+
+/**
+ * @brief Parsuje linie dopisane do pliku od poprzedniego wywołania.
+ *
+ * @param consumer Funkcja wywoływana dla każdego poprawnie sparsowanego rekordu.
+ * @return Liczba przekazanych rekordów.
+ */
+size_t EnergyDataFollower::Poll(const function<void(EnergyData &&)> &consumer) {
+    error_code error;
+    const auto size = filesystem::file_size(_filepath, error);
+
+    if (error || static_cast<streamoff>(size) == _offset) return 0;
+
+    // Plik krótszy niż zapamiętana pozycja został skrócony lub zastąpiony - zacznij od początku.
+    if (static_cast<streamoff>(size) < _offset) {
+        _offset = 0;
+        _previous.reset();
+        _parser = nullptr;
+    }
+
+    ifstream inputFile(_filepath);
+
+    if (!inputFile.is_open()) return 0;
+
+    string line;
+
+    if (_offset == 0) {
+        // Pomiń nagłówek, ale tylko jeśli został już zapisany w całości.
+        if (!getline(inputFile, line) || inputFile.eof()) return 0;
+
+        _offset = inputFile.tellg();
+    } else {
+        inputFile.seekg(_offset);
+    }
+
+    // Odmiana pliku jest rozpoznawana, gdy zawiera on już pierwszą linię danych.
+    if (_parser == nullptr) _parser = EnergyData::GetLineParser(CsvDialect::DetectFile(_filepath));
+
+    size_t count = 0;
+
+    while (getline(inputFile, line)) {
+        // Niekompletna linia zostanie przetworzona, gdy zostanie dopisany jej koniec.
+        if (inputFile.eof()) break;
+
+        _offset = inputFile.tellg();
+
+        if (optional<EnergyData> record = _parser(line, _previous, _columns, nullptr)) {
+            consumer(std::move(*record));
+            ++count;
+        } else {
+            ++_skippedLines;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Zwraca pozycję w pliku tuż za ostatnią przetworzoną linią.
+ *
+ * @return Pozycja w bajtach.
+ */
+streamoff EnergyDataFollower::GetOffset() const {
+    return _offset;
+}
+
+/**
+ * @brief Zwraca liczbę pominiętych linii.
+ *
+ * @return Liczba pominiętych linii.
+ */
+size_t EnergyDataFollower::GetSkippedLines() const {
+    return _skippedLines;
+}
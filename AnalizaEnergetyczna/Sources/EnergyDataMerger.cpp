@@ -0,0 +1,304 @@
+#include "../Headers/EnergyDataMerger.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "../Headers/EnergyDataSorter.hpp"
+
+/**
+ * @brief Sprawdza, czy ścieżka wskazuje wiele plików.
+ *
+ * @param path Ścieżka do sprawdzenia.
+ * @return true, jeśli ścieżka jest katalogiem lub wzorcem, false w przeciwnym razie.
+ */
+bool EnergyDataMerger::IsMultiFilePath(const string &path) {
+    return filesystem::is_directory(path) ||
+           filesystem::path(path).filename().string().find_first_of("*?") != string::npos;
+}
+
+/**
+ * @brief Zwraca pliki wskazywane przez ścieżkę.
+ *
+ * @param path Katalog, wzorzec lub ścieżka do pojedynczego pliku.
+ * @return Ścieżki plików uporządkowane według ścieżki.
+ * @throws runtime_error Jeśli żaden plik nie pasuje do ścieżki.
+ */
+vector<string> EnergyDataMerger::ResolveFiles(const string &path) {
+    if (!IsMultiFilePath(path)) return {path};
+
+    const bool isDirectory = filesystem::is_directory(path);
+    const filesystem::path directory = isDirectory ? filesystem::path(path) : filesystem::path(path).parent_path();
+    const string pattern = isDirectory ? "*" : filesystem::path(path).filename().string();
+
+    const filesystem::path searched = directory.empty() ? filesystem::path(".") : directory;
+
+    vector<string> files;
+
+    if (filesystem::is_directory(searched)) {
+        for (const auto &entry: filesystem::directory_iterator(searched)) {
+            if (!entry.is_regular_file()) continue;
+
+            const string name = entry.path().filename().string();
+            string lowercase = name;
+
+            ranges::transform(lowercase, lowercase.begin(), [](const unsigned char c) { return tolower(c); });
+
+            if (isDirectory && !lowercase.ends_with(".csv") && !lowercase.ends_with(".csv.gz") &&
+                !lowercase.ends_with(".csv.zst"))
+                continue;
+            if (!MatchesPattern(name, pattern)) continue;
+
+            files.push_back((directory / name).string());
+        }
+    }
+
+    if (files.empty()) throw runtime_error("No CSV files match: " + path);
+
+    ranges::sort(files);
+
+    return files;
+}
+
+/**
+ * @brief Wczytuje pliki CSV i przekazuje ich rekordy do odbiorcy w porządku chronologicznym.
+ *
+ * Wątki robocze najpierw sprawdzają porządek każdego pliku, parsując same znaczniki czasu
+ * (bez wartości i bez logów). Plik nieuporządkowany jest od razu wczytywany w całości
+ * i sortowany. Następnie wszystkie pliki są scalane kopcem po znaczniku czasu - pliki
+ * uporządkowane są przy tym czytane leniwie (`FileStream`), więc scalanie nie trzyma w pamięci
+ * ich rekordów, a odbiorca buduje strukturę danych na bieżąco. Przy remisie pierwszeństwo ma
+ * plik o wcześniejszej ścieżce, a w obrębie pliku - rekord wcześniejszy w pliku (sortowanie
+ * jest stabilne). Logi zawierają tylko błędne linie (`LineLogging::ErrorsOnly`).
+ *
+ * @param files Ścieżki plików.
+ * @param consumer Funkcja wywoływana dla każdego rekordu scalonego strumienia.
+ * @param columns Kolumny wartości do wczytania.
+ * @param threads Największa liczba plików jednocześnie sprawdzanych i sortowanych (0 - liczba rdzeni procesora).
+ * @return Liczba przekazanych rekordów.
+ * @throws runtime_error Jeśli nie można otworzyć któregoś z plików.
+ */
+size_t EnergyDataMerger::ReadEnergyData(const vector<string> &files, const function<void(EnergyData &&)> &consumer,
+                                        const ColumnSet columns, unsigned threads) {
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+
+    vector<vector<EnergyData> > unordered(files.size());
+    vector<char> ordered(files.size(), true);
+    vector<exception_ptr> errors(files.size());
+    atomic<size_t> next = 0;
+
+    {
+        vector<jthread> workers;
+
+        for (unsigned i = 0; i < min<size_t>(threads, files.size()); ++i) {
+            workers.emplace_back([&] {
+                for (size_t file = next++; file < files.size(); file = next++) {
+                    try {
+                        uint64_t last = 0;
+
+                        EnergyData::ReadEnergyData(files[file], [&](EnergyData &&record) {
+                            const uint64_t key = record.GetDateTime().GetSortKey();
+
+                            if (key < last) ordered[file] = false;
+                            last = key;
+                        }, ColumnSet{0}, LineLogging::None);
+
+                        if (ordered[file]) continue;
+
+                        EnergyData::ReadEnergyData(files[file], [&records = unordered[file]](EnergyData &&record) {
+                            records.push_back(std::move(record));
+                        }, columns, LineLogging::ErrorsOnly);
+
+                        EnergyDataSorter::SortByDateTime(unordered[file]);
+                    } catch (...) {
+                        errors[file] = current_exception();
+                    }
+                }
+            });
+        }
+    }
+
+    for (const exception_ptr &error: errors)
+        if (error) rethrow_exception(error);
+
+    vector<unique_ptr<FileStream> > streams;
+    streams.reserve(files.size());
+
+    for (size_t file = 0; file < files.size(); ++file) {
+        if (ordered[file]) streams.push_back(make_unique<FileStream>(files[file], columns));
+        else streams.push_back(make_unique<FileStream>(std::move(unordered[file])));
+    }
+
+    // Kopiec (znacznik czasu, numer pliku) - najmniejszy element na szczycie.
+    using Head = pair<uint64_t, size_t>;
+    priority_queue<Head, vector<Head>, greater<> > heads;
+
+    for (size_t file = 0; file < streams.size(); ++file)
+        if (const EnergyData *record = streams[file]->Peek()) heads.emplace(record->GetDateTime().GetSortKey(), file);
+
+    size_t count = 0;
+
+    while (!heads.empty()) {
+        const size_t file = heads.top().second;
+        heads.pop();
+
+        consumer(std::move(*streams[file]->Peek()));
+        streams[file]->Pop();
+        ++count;
+
+        if (const EnergyData *record = streams[file]->Peek()) heads.emplace(record->GetDateTime().GetSortKey(), file);
+        else streams[file].reset(); // Zakończ wątek i zwolnij pamięć wyczerpanego pliku.
+    }
+
+    return count;
+}
+
+/**
+ * @brief Uruchamia wątek parsujący uporządkowany plik.
+ *
+ * Wątek przekazuje rekordy blokami po `BlockSize`; jeśli strumień jest niszczony przed końcem
+ * pliku, parsowanie jest przerywane przy następnym bloku.
+ *
+ * @param filepath Ścieżka do pliku.
+ * @param columns Kolumny wartości do wczytania.
+ */
+EnergyDataMerger::FileStream::FileStream(const string &filepath, const ColumnSet columns) : _finished(false) {
+    _thread = jthread([this, filepath, columns](const stop_token &token) {
+        // Wyjątek przerywający parsowanie po żądaniu zatrzymania.
+        struct Stopped {
+        };
+
+        try {
+            vector<EnergyData> block;
+            block.reserve(BlockSize);
+
+            EnergyData::ReadEnergyData(filepath, [&](EnergyData &&record) {
+                block.push_back(std::move(record));
+
+                if (block.size() < BlockSize) return;
+                if (!Push(token, std::move(block))) throw Stopped();
+
+                block = vector<EnergyData>();
+                block.reserve(BlockSize);
+            }, columns, LineLogging::ErrorsOnly);
+
+            if (!block.empty()) Push(token, std::move(block));
+        } catch (const Stopped &) {
+        } catch (...) {
+            lock_guard lock(_mutex);
+            _error = current_exception();
+        }
+
+        lock_guard lock(_mutex);
+        _finished = true;
+        _changed.notify_all();
+    });
+}
+
+/**
+ * @brief Tworzy strumień z rekordów wczytanych już w całości.
+ *
+ * @param records Rekordy uporządkowane chronologicznie.
+ */
+EnergyDataMerger::FileStream::FileStream(vector<EnergyData> &&records) : _current(std::move(records)) {
+}
+
+/**
+ * @brief Zatrzymuje wątek parsujący i czeka na jego zakończenie.
+ */
+EnergyDataMerger::FileStream::~FileStream() {
+    _thread.request_stop();
+
+    if (_thread.joinable()) _thread.join();
+}
+
+/**
+ * @brief Zwraca bieżący rekord strumienia, w razie potrzeby czekając na kolejny blok.
+ *
+ * @return Wskaźnik do rekordu lub nullptr na końcu strumienia.
+ * @throws runtime_error Jeśli wątek parsujący zgłosił błąd.
+ */
+EnergyData *EnergyDataMerger::FileStream::Peek() {
+    if (_position < _current.size()) return &_current[_position];
+
+    unique_lock lock(_mutex);
+
+    _changed.wait(lock, [this] { return !_blocks.empty() || _finished; });
+
+    if (_blocks.empty()) {
+        if (_error) rethrow_exception(_error);
+        return nullptr;
+    }
+
+    _current = std::move(_blocks.front());
+    _blocks.pop_front();
+    _position = 0;
+    _changed.notify_all();
+
+    return &_current[0];
+}
+
+/**
+ * @brief Przechodzi do następnego rekordu strumienia.
+ */
+void EnergyDataMerger::FileStream::Pop() {
+    ++_position;
+}
+
+/**
+ * @brief Przekazuje sparsowany blok do kolejki.
+ *
+ * @param token Token zatrzymania wątku parsującego.
+ * @param block Blok rekordów.
+ * @return false, jeśli zażądano zatrzymania wątku, true w przeciwnym razie.
+ */
+bool EnergyDataMerger::FileStream::Push(const stop_token &token, vector<EnergyData> &&block) {
+    unique_lock lock(_mutex);
+
+    if (!_changed.wait(lock, token, [this] { return _blocks.size() < MaxQueuedBlocks; })) return false;
+
+    _blocks.push_back(std::move(block));
+    _changed.notify_all();
+
+    return true;
+}
+
+/**
+ * @brief Sprawdza, czy nazwa pasuje do wzorca z symbolami `*` i `?`.
+ *
+ * Dopasowanie zachłanne z powrotem do ostatniej gwiazdki - działa w czasie O(n * m).
+ *
+ * @param name Nazwa pliku.
+ * @param pattern Wzorzec.
+ * @return true, jeśli nazwa pasuje do wzorca, false w przeciwnym razie.
+ */
+bool EnergyDataMerger::MatchesPattern(const string_view name, const string_view pattern) {
+    size_t n = 0, p = 0;
+    size_t starPattern = string_view::npos, starName = 0;
+
+    while (n < name.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+            ++n;
+            ++p;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            starPattern = p++;
+            starName = n;
+        } else if (starPattern != string_view::npos) {
+            p = starPattern + 1;
+            n = ++starName;
+        } else {
+            return false;
+        }
+    }
+
+    while (p < pattern.size() && pattern[p] == '*') ++p;
+
+    return p == pattern.size();
+}
@@ -0,0 +1,75 @@
+#include "../Headers/EnergyDataSorter.hpp"
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+/**
+ * @brief Sprawdza, czy rekordy są uporządkowane rosnąco w czasie.
+ *
+ * @param records Wektor rekordów.
+ * @return true, jeśli rekordy są uporządkowane, false w przeciwnym razie.
+ */
+bool EnergyDataSorter::IsSorted(const vector<EnergyData> &records) {
+    for (size_t i = 1; i < records.size(); ++i) {
+        if (records[i].GetDateTime().GetSortKey() < records[i - 1].GetDateTime().GetSortKey()) return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Sortuje rekordy pozycyjnie (LSD) po spakowanym znaczniku czasu.
+ *
+ * Sortowane są pary (klucz, indeks rekordu), a same rekordy są przestawiane tylko raz,
+ * na końcu - dzięki temu każdy przebieg przenosi 16 bajtów zamiast całego rekordu.
+ *
+ * @param records Wektor rekordów do posortowania.
+ */
+void EnergyDataSorter::SortByDateTime(vector<EnergyData> &records) {
+    if (IsSorted(records)) return;
+
+    constexpr int digitBits = 8;
+    constexpr int digitCount = 64 / digitBits;
+    constexpr size_t radix = size_t{1} << digitBits;
+
+    vector<pair<uint64_t, uint32_t>> keys(records.size());
+    // Histogramy wszystkich cyfr liczone są w jednym przebiegu po danych.
+    vector<array<size_t, radix>> histograms(digitCount, array<size_t, radix>{});
+
+    for (size_t i = 0; i < records.size(); ++i) {
+        const uint64_t key = records[i].GetDateTime().GetSortKey();
+        keys[i] = {key, static_cast<uint32_t>(i)};
+
+        for (int digit = 0; digit < digitCount; ++digit)
+            ++histograms[digit][(key >> (digit * digitBits)) & (radix - 1)];
+    }
+
+    vector<pair<uint64_t, uint32_t>> buffer(records.size());
+
+    for (int digit = 0; digit < digitCount; ++digit) {
+        array<size_t, radix> &histogram = histograms[digit];
+
+        // Cyfra wspólna dla wszystkich rekordów nie zmienia kolejności - pomijamy przebieg.
+        if (histogram[(keys[0].first >> (digit * digitBits)) & (radix - 1)] == keys.size()) continue;
+
+        size_t offset = 0;
+        for (size_t &count: histogram) {
+            const size_t bucketSize = count;
+            count = offset;
+            offset += bucketSize;
+        }
+
+        for (const auto &entry: keys)
+            buffer[histogram[(entry.first >> (digit * digitBits)) & (radix - 1)]++] = entry;
+
+        keys.swap(buffer);
+    }
+
+    vector<EnergyData> sorted;
+    sorted.reserve(records.size());
+
+    for (const auto &entry: keys) sorted.push_back(std::move(records[entry.second]));
+
+    records.swap(sorted);
+}
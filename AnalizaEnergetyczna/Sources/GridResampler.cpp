@@ -0,0 +1,105 @@
+#include "../Headers/GridResampler.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+#include "../Headers/Day.hpp"
+
+/**
+ * @brief Konstruktor klasy GridResampler.
+ *
+ * @param maxGapSlots Największa liczba kolejnych pustych slotów wypełnianych interpolacją.
+ * @param consumer Odbiorca rekordów wynikowych.
+ */
+GridResampler::GridResampler(const int maxGapSlots, function<void(EnergyData &&, int)> consumer)
+    : _maxGapSlots(maxGapSlots), _consumer(std::move(consumer)) {
+    if (maxGapSlots < 0) throw invalid_argument("Invalid interpolation gap: " + to_string(maxGapSlots) + " slots");
+}
+
+/**
+ * @brief Przetwarza kolejny rekord strumienia.
+ *
+ * Odczyt z bieżącego slotu jest dodawany do jego sum, a odczyt z innego slotu zamyka bieżący slot.
+ *
+ * @param record Rekord do przetworzenia.
+ */
+void GridResampler::Push(EnergyData &&record) {
+    const DateTime &dateTime = record.GetDateTime();
+    const chrono::sys_days date(chrono::year(dateTime.GetYear()) / dateTime.GetMonth() / dateTime.GetDay());
+    const int64_t index = date.time_since_epoch().count() * Day::SlotsPerDay +
+                          (dateTime.GetHour() * 60 + dateTime.GetMinute()) / Quarter::SlotMinutes;
+    const array<double, ValueCount> values{
+        record.GetAutoConsumption(), record.GetExport(), record.GetImport(), record.GetConsumption(),
+        record.GetGeneration()
+    };
+
+    if (_current.has_value() && _current->Index == index && _current->Repeated == dateTime.IsRepeated()) {
+        for (int i = 0; i < ValueCount; ++i) _current->Values[i] += values[i];
+
+        ++_currentSamples;
+        return;
+    }
+
+    Flush();
+
+    _current = Slot{index, dateTime.IsRepeated(), values};
+    _currentSamples = 1;
+}
+
+/**
+ * @brief Zamyka bieżący slot: wypełnia lukę za ostatnio wysłanym slotem i wysyła średnią bieżącego slotu.
+ */
+void GridResampler::Flush() {
+    if (!_current.has_value()) return;
+
+    Slot slot = *_current;
+
+    for (double &value: slot.Values) value /= _currentSamples;
+
+    if (_last.has_value() && !_last->Repeated && !slot.Repeated) {
+        if (const int64_t span = slot.Index - _last->Index; span > 1 && span - 1 <= _maxGapSlots) {
+            for (int64_t step = 1; step < span; ++step) {
+                Slot interpolated{_last->Index + step, false, {}};
+
+                for (int i = 0; i < ValueCount; ++i)
+                    interpolated.Values[i] = _last->Values[i] + (slot.Values[i] - _last->Values[i]) * step / span;
+
+                Emit(interpolated, 1);
+                ++_interpolatedCount;
+            }
+        }
+    }
+
+    Emit(slot, _currentSamples);
+
+    _last = slot;
+    _current.reset();
+    _currentSamples = 0;
+}
+
+/**
+ * @brief Zwraca liczbę slotów wypełnionych interpolacją.
+ *
+ * @return Liczba slotów.
+ */
+size_t GridResampler::GetInterpolatedCount() const {
+    return _interpolatedCount;
+}
+
+/**
+ * @brief Wysyła odbiorcy rekord slotu ze znacznikiem czasu początku slotu.
+ *
+ * @param slot Slot ze średnimi wartościami wielkości.
+ * @param samples Liczba odczytów, z których powstał rekord.
+ */
+void GridResampler::Emit(const Slot &slot, const int samples) {
+    const chrono::year_month_day date{chrono::sys_days(chrono::days(slot.Index / Day::SlotsPerDay))};
+    const int minute = static_cast<int>(slot.Index % Day::SlotsPerDay) * Quarter::SlotMinutes;
+    const DateTime dateTime(static_cast<int>(static_cast<unsigned>(date.day())),
+                            static_cast<int>(static_cast<unsigned>(date.month())), static_cast<int>(date.year()),
+                            minute / 60, minute % 60, slot.Repeated);
+
+    _consumer(EnergyData(dateTime, slot.Values[0], slot.Values[1], slot.Values[2], slot.Values[3], slot.Values[4]),
+              samples);
+}
@@ -10,17 +10,21 @@
 Month::Month(const int month) {
     _month = month;
     _days = new vector<Day*>();
+    _aggregate = new Aggregate();
+    _sketch = new QuantileSketch();
 }
 
 /**
  * @brief Destruktor klasy Month.
  * 
- * Zwalnia pamięć zaalokowaną dla obiektów Day przechowywanych w wektorze oraz dla samego wektora.
+ * Zwalnia pamięć zaalokowaną dla obiektów Day przechowywanych w wektorze, dla samego wektora, dla agregatu oraz dla szkicu.
  */
 Month::~Month() {
     for (const Day* day : *_days) delete day;
 
     delete _days;
+    delete _aggregate;
+    delete _sketch;
 }
 
 /**
@@ -39,4 +43,22 @@ int Month::GetMonth() const {
  */
 vector<Day*>& Month::GetDays() const {
     return *_days;
+}
+
+/**
+ * @brief Zwraca agregat danych miesiąca.
+ *
+ * @return Referencja do agregatu.
+ */
+Aggregate& Month::GetAggregate() const {
+    return *_aggregate;
+}
+
+/**
+ * @brief Zwraca szkic rozkładu wartości danych miesiąca.
+ *
+ * @return Referencja do szkicu.
+ */
+QuantileSketch& Month::GetSketch() const {
+    return *_sketch;
 }
\ No newline at end of file
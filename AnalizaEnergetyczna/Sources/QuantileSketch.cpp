@@ -0,0 +1,172 @@
+#include "../Headers/QuantileSketch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ * @brief Dodaje wszystkie wartości rekordu do szkicu.
+ *
+ * @param data Rekord do dodania.
+ */
+void QuantileSketch::Add(const Data& data) {
+    for (int i = 0; i < MetricCount; ++i) Update(_histograms[i], data.GetValue(static_cast<Metric>(i)), 1);
+}
+
+/**
+ * @brief Usuwa wartości rekordu dodanego wcześniej do szkicu.
+ *
+ * @param data Rekord do usunięcia.
+ */
+void QuantileSketch::Remove(const Data& data) {
+    for (int i = 0; i < MetricCount; ++i) Update(_histograms[i], data.GetValue(static_cast<Metric>(i)), -1);
+}
+
+/**
+ * @brief Dodaje do szkicu wartości innego szkicu.
+ *
+ * Kubełki obu szkiców mają te same granice, więc liczniki są po prostu sumowane.
+ *
+ * @param other Szkic do dołączenia.
+ */
+void QuantileSketch::Merge(const QuantileSketch& other) {
+    for (int i = 0; i < MetricCount; ++i) {
+        Histogram &histogram = _histograms[i];
+        const Histogram &source = other._histograms[i];
+
+        for (const auto &[store, sourceStore]: {
+                 pair{&histogram.Positive, &source.Positive}, pair{&histogram.Negative, &source.Negative}
+             }) {
+            for (size_t j = 0; j < sourceStore->Counts.size(); ++j) {
+                if (sourceStore->Counts[j] != 0)
+                    store->Add(sourceStore->Offset + static_cast<int32_t>(j), sourceStore->Counts[j]);
+            }
+        }
+
+        histogram.Zeros += source.Zeros;
+        histogram.Count += source.Count;
+    }
+}
+
+/**
+ * @brief Szacuje percentyl wartości wielkości.
+ *
+ * Kubełki są przeglądane od najmniejszych wartości (największych modułów wartości ujemnych),
+ * aż do kubełka zawierającego wartość o randze `GetRank`.
+ *
+ * @param metric Wielkość.
+ * @param percentile Percentyl (0-100).
+ * @return Reprezentant kubełka zawierającego percentyl (NaN dla pustego szkicu).
+ */
+double QuantileSketch::GetPercentile(const Metric metric, const double percentile) const {
+    const Histogram &histogram = _histograms[static_cast<int>(metric)];
+
+    if (histogram.Count == 0) return numeric_limits<double>::quiet_NaN();
+
+    size_t rank = GetRank(percentile, histogram.Count);
+    const Store &negative = histogram.Negative;
+
+    for (size_t i = negative.Counts.size(); i-- > 0;) {
+        if (rank <= negative.Counts[i]) return -GetRepresentative(negative.Offset + static_cast<int32_t>(i));
+
+        rank -= negative.Counts[i];
+    }
+
+    if (rank <= histogram.Zeros) return 0;
+
+    rank -= histogram.Zeros;
+
+    const Store &positive = histogram.Positive;
+
+    for (size_t i = 0; i < positive.Counts.size(); ++i) {
+        if (rank <= positive.Counts[i]) return GetRepresentative(positive.Offset + static_cast<int32_t>(i));
+
+        rank -= positive.Counts[i];
+    }
+
+    return numeric_limits<double>::quiet_NaN();
+}
+
+/**
+ * @brief Zwraca liczbę wartości wielkości w szkicu.
+ *
+ * @param metric Wielkość.
+ * @return Liczba wartości.
+ */
+size_t QuantileSketch::GetCount(const Metric metric) const {
+    return _histograms[static_cast<int>(metric)].Count;
+}
+
+/**
+ * @brief Wyznacza rangę percentyla metodą najbliższej rangi.
+ *
+ * Iloczyn jest liczony przed dzieleniem, aby percentyle całkowite dawały dokładną rangę.
+ *
+ * @param percentile Percentyl (0-100).
+ * @param count Liczba wartości.
+ * @return Numer (od 1) wartości w ciągu posortowanym rosnąco.
+ */
+size_t QuantileSketch::GetRank(const double percentile, const size_t count) {
+    const auto rank = static_cast<size_t>(ceil(percentile * static_cast<double>(count) / 100));
+
+    return clamp<size_t>(rank, 1, count);
+}
+
+/**
+ * @brief Zmienia licznik kubełka, rozszerzając w razie potrzeby tablicę.
+ *
+ * @param index Numer kubełka.
+ * @param delta Zmiana licznika.
+ */
+void QuantileSketch::Store::Add(const int32_t index, const int64_t delta) {
+    if (Counts.empty()) {
+        Offset = index;
+        Counts.assign(1, 0);
+    } else if (index < Offset) {
+        Counts.insert(Counts.begin(), Offset - index, 0);
+        Offset = index;
+    } else if (static_cast<size_t>(index - Offset) >= Counts.size()) {
+        Counts.resize(index - Offset + 1);
+    }
+
+    Counts[index - Offset] += delta;
+}
+
+/**
+ * @brief Zmienia histogram wielkości o jedną wartość.
+ *
+ * @param histogram Histogram wielkości.
+ * @param value Wartość.
+ * @param delta 1 przy dodawaniu, -1 przy usuwaniu.
+ */
+void QuantileSketch::Update(Histogram& histogram, const double value, const int delta) {
+    if (!isfinite(value)) return;
+
+    if (fabs(value) < MinIndexableValue) histogram.Zeros += delta;
+    else if (value > 0) histogram.Positive.Add(GetIndex(value), delta);
+    else histogram.Negative.Add(GetIndex(-value), delta);
+
+    histogram.Count += delta;
+}
+
+/**
+ * @brief Wyznacza numer kubełka dla modułu wartości.
+ *
+ * @param magnitude Moduł wartości.
+ * @return Numer kubełka `ceil(log_γ magnitude)`.
+ */
+int32_t QuantileSketch::GetIndex(const double magnitude) {
+    static const double logGamma = log(Gamma);
+
+    return static_cast<int32_t>(ceil(log(magnitude) / logGamma));
+}
+
+/**
+ * @brief Zwraca reprezentanta kubełka.
+ *
+ * @param index Numer kubełka.
+ * @return Reprezentant kubełka.
+ */
+double QuantileSketch::GetRepresentative(const int32_t index) {
+    return 2 * pow(Gamma, index) / (Gamma + 1);
+}
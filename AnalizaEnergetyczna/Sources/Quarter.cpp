@@ -1,63 +1,80 @@
 #include "../Headers/Quarter.hpp"
 
-#include <algorithm>
-
 /**
  * @brief Konstruktor klasy Quarter.
  *
- * Tworzy obiekt reprezentujący kwadrans (przedział czasowy) i inicjalizuje wektor danych.
+ * Tworzy obiekt reprezentujący kubełek (przedział czasowy) i inicjalizuje puste sloty danych.
  *
- * @param startHour Godzina rozpoczęcia kwadransa (0-23).
- * @param endHour Godzina zakończenia kwadransa (0-23).
+ * @param startMinute Minuta dnia, od której zaczyna się kubełek (0-1439).
+ * @param lengthMinutes Długość kubełka w minutach.
  */
-Quarter::Quarter(const int startHour, const int endHour) {
-    _startTime = new Time(startHour, 0);
-    _endTime = new Time(endHour, 45);
-    _data = new vector<Data*>();
+Quarter::Quarter(const int startMinute, const int lengthMinutes) {
+    const int endMinute = startMinute + lengthMinutes - SlotMinutes;
+
+    _startTime = new Time(startMinute / 60, startMinute % 60);
+    _endTime = new Time(endMinute / 60, endMinute % 60);
+    _data = new vector<optional<Data>>(lengthMinutes / SlotMinutes);
+    _aggregate = new Aggregate();
 }
 
 /**
  * @brief Destruktor klasy Quarter.
  *
- * Zwalnia pamięć zaalokowaną dla obiektów Time oraz dla obiektów Data przechowywanych w wektorze.
+ * Zwalnia pamięć zaalokowaną dla obiektów Time, dla wektora danych oraz dla agregatu.
  */
 Quarter::~Quarter() {
     delete _startTime;
     delete _endTime;
-
-    for (const Data* data : *_data) delete data;
-
     delete _data;
+    delete _aggregate;
 }
 
 /**
- * @brief Dodaje dane do kwadransa, jeśli czas danych mieści się w przedziale czasowym kwadransa.
+ * @brief Zwraca slot odpowiadający czasowi pomiaru.
  *
- * @param time Czas danych do dodania.
- * @param data Referencja do obiektu Data do dodania.
- * @return true, jeśli dane zostały dodane, false w przeciwnym razie.
+ * Sloty drugiego wystąpienia godziny powtarzanej są tworzone przy pierwszym takim odczycie
+ * i wstawiane za ostatnim slotem pierwszego wystąpienia tej godziny.
+ *
+ * @param time Czas pomiaru.
+ * @return Wskaźnik do slotu lub nullptr, jeśli czas nie należy do kubełka lub leży poza siatką slotów.
  */
-bool Quarter::AddData(const Time& time, Data& data) const {
-    const auto startTime = GetStartTime();
+optional<Data>* Quarter::GetSlot(const Time& time) {
+    constexpr int hourSlots = 60 / SlotMinutes;
+    const int startMinute = _startTime->GetMinuteOfDay();
+    const int endMinute = _endTime->GetMinuteOfDay() + SlotMinutes;
 
-    if (const auto endTime = GetEndTime(); time > endTime || time < startTime) return false;
+    if (time.GetMinute() % SlotMinutes != 0) return nullptr;
 
-    _data->push_back(&data);
+    if (time.IsRepeated()) {
+        // Drugie wystąpienie godziny należy do kubełka, w którym kończy się jej pierwsze wystąpienie.
+        const int hourEnd = (time.GetHour() + 1) * 60;
 
-    return true;
-}
+        if (hourEnd <= startMinute || hourEnd > endMinute || (_repeatedHour >= 0 && _repeatedHour != time.GetHour()))
+            return nullptr;
 
-/**
- * @brief Sortuje dane w kwadransie rosnąco po czasie.
- */
-void Quarter::SortData() const {
-    ranges::sort(*_data, [](const Data* a, const Data* b) {
-        return a->GetTime() < b->GetTime();
-    });
+        const int position = (hourEnd - startMinute) / SlotMinutes;
+
+        if (_repeatedHour < 0) {
+            _data->insert(_data->begin() + position, hourSlots, nullopt);
+            _repeatedHour = time.GetHour();
+        }
+
+        return &(*_data)[position + time.GetMinute() / SlotMinutes];
+    }
+
+    const int offset = time.GetMinuteOfDay() - startMinute;
+
+    if (offset < 0 || time.GetMinuteOfDay() >= endMinute) return nullptr;
+
+    int index = offset / SlotMinutes;
+
+    if (_repeatedHour >= 0 && time.GetHour() > _repeatedHour) index += hourSlots;
+
+    return &(*_data)[index];
 }
 
 /**
- * @brief Zwraca referencję do obiektu Time reprezentującego czas rozpoczęcia kwadransa.
+ * @brief Zwraca referencję do obiektu Time reprezentującego czas rozpoczęcia kubełka.
  *
  * @return Referencja do obiektu Time.
  */
@@ -66,7 +83,7 @@ Time& Quarter::GetStartTime() const {
 }
 
 /**
- * @brief Zwraca referencję do obiektu Time reprezentującego czas zakończenia kwadransa.
+ * @brief Zwraca referencję do obiektu Time reprezentującego początek ostatniego slotu kubełka.
  *
  * @return Referencja do obiektu Time.
  */
@@ -75,10 +92,29 @@ Time& Quarter::GetEndTime() const {
 }
 
 /**
- * @brief Zwraca referencję do wektora przechowującego wskaźniki do obiektów Data.
+ * @brief Zwraca referencję do wektora slotów z danymi.
  *
- * @return Referencja do wektora wskaźników do obiektów Data.
+ * @return Referencja do wektora slotów.
  */
-vector<Data*>& Quarter::GetData() const {
+vector<optional<Data>>& Quarter::GetData() const {
     return *_data;
+}
+
+
+/**
+ * @brief Zwraca agregat danych kubełka.
+ *
+ * @return Referencja do agregatu.
+ */
+Aggregate& Quarter::GetAggregate() const {
+    return *_aggregate;
+}
+
+/**
+ * @brief Zwraca godzinę, której drugie wystąpienie przechowuje kubełek.
+ *
+ * @return Godzina lub -1, jeśli kubełek nie zawiera slotów godziny powtarzanej.
+ */
+int Quarter::GetRepeatedHour() const {
+    return _repeatedHour;
 }
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "../Headers/RecordCodec.hpp"
+
+#include <array>
+#include <cstring>
+
+/**
+ * @brief Dopisuje zakodowany rekord na koniec bufora.
+ *
+ * @param record Rekord do zakodowania.
+ * @param buffer Bufor wyjściowy.
+ */
+void RecordCodec::Encode(const EnergyData &record, string &buffer) {
+    const uint64_t key = record.GetDateTime().GetSortKey();
+    const double values[] = {
+        record.GetAutoConsumption(), record.GetExport(), record.GetImport(), record.GetConsumption(),
+        record.GetGeneration()
+    };
+
+    buffer.append(reinterpret_cast<const char *>(&key), sizeof(key));
+    buffer.append(reinterpret_cast<const char *>(values), sizeof(values));
+}
+
+/**
+ * @brief Dekoduje rekord.
+ *
+ * @param bytes Wskaźnik do bajtów rekordu.
+ * @return Odczytany rekord.
+ */
+EnergyData RecordCodec::Decode(const char *bytes) {
+    uint64_t key;
+    double values[5];
+
+    memcpy(&key, bytes, sizeof(key));
+    memcpy(values, bytes + sizeof(key), sizeof(values));
+
+    return {DateTime::FromSortKey(key), values[0], values[1], values[2], values[3], values[4]};
+}
+
+/**
+ * @brief Oblicza sumę kontrolną CRC-32.
+ *
+ * @param bytes Wskaźnik do danych.
+ * @param size Liczba bajtów.
+ * @return Suma kontrolna.
+ */
+uint32_t RecordCodec::Crc32(const char *bytes, const size_t size) {
+    static constexpr array<uint32_t, 256> table = [] {
+        array<uint32_t, 256> result{};
+
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+
+            for (int bit = 0; bit < 8; ++bit) crc = crc & 1 ? 0xEDB88320u ^ crc >> 1 : crc >> 1;
+
+            result[i] = crc;
+        }
+
+        return result;
+    }();
+
+    uint32_t crc = 0xFFFFFFFFu;
+
+    for (size_t i = 0; i < size; ++i) crc = table[(crc ^ static_cast<uint8_t>(bytes[i])) & 0xFF] ^ crc >> 8;
+
+    return crc ^ 0xFFFFFFFFu;
+}
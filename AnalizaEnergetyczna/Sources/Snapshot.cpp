@@ -0,0 +1,110 @@
+#include "../Headers/Snapshot.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "../Headers/RecordCodec.hpp"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Zapisuje migawkę.
+ *
+ * @param filepath Ścieżka do pliku migawki.
+ * @param generation Numer ostatniego pokolenia dziennika zawartego w migawce.
+ * @param records Rekordy do zapisania.
+ * @throws runtime_error Jeśli zapis się nie powiódł.
+ */
+void Snapshot::Write(const string &filepath, const uint64_t generation, const vector<EnergyData> &records) {
+    string body;
+    body.reserve(records.size() * RecordCodec::RecordSize);
+
+    for (const EnergyData &record: records) RecordCodec::Encode(record, body);
+
+    const uint64_t count = records.size();
+    const uint32_t crc = RecordCodec::Crc32(body.data(), body.size());
+
+    string header;
+    header.append(reinterpret_cast<const char *>(&Magic), sizeof(Magic));
+    header.append(reinterpret_cast<const char *>(&Version), sizeof(Version));
+    header.append(reinterpret_cast<const char *>(&generation), sizeof(generation));
+    header.append(reinterpret_cast<const char *>(&count), sizeof(count));
+    header.append(reinterpret_cast<const char *>(&crc), sizeof(crc));
+
+    const string temporary = filepath + ".tmp";
+    FILE *file = fopen(temporary.c_str(), "wb");
+
+    if (file == nullptr) throw runtime_error("Could not create snapshot: " + temporary);
+
+    bool written = fwrite(header.data(), 1, header.size(), file) == header.size() &&
+                   fwrite(body.data(), 1, body.size(), file) == body.size() && fflush(file) == 0;
+#ifdef _WIN32
+    written = written && _commit(_fileno(file)) == 0;
+#else
+    written = written && fsync(fileno(file)) == 0;
+#endif
+    written = fclose(file) == 0 && written;
+
+    if (!written) {
+        filesystem::remove(temporary);
+        throw runtime_error("Could not write snapshot: " + temporary);
+    }
+
+    filesystem::rename(temporary, filepath);
+}
+
+/**
+ * @brief Wczytuje migawkę.
+ *
+ * @param filepath Ścieżka do pliku migawki.
+ * @param consumer Funkcja wywoływana z wczytanymi rekordami.
+ * @return Numer ostatniego pokolenia dziennika zawartego w migawce.
+ * @throws runtime_error Jeśli plik jest uszkodzony lub ma nieznany format.
+ */
+uint64_t Snapshot::Read(const string &filepath, const function<void(vector<EnergyData> &&)> &consumer) {
+    ifstream inputFile(filepath, ios::binary);
+
+    if (!inputFile.is_open()) throw runtime_error("Could not open snapshot: " + filepath);
+
+    uint32_t magic = 0, version = 0, crc = 0;
+    uint64_t generation = 0, count = 0;
+
+    inputFile.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+    inputFile.read(reinterpret_cast<char *>(&version), sizeof(version));
+    inputFile.read(reinterpret_cast<char *>(&generation), sizeof(generation));
+    inputFile.read(reinterpret_cast<char *>(&count), sizeof(count));
+    inputFile.read(reinterpret_cast<char *>(&crc), sizeof(crc));
+
+    if (!inputFile || magic != Magic || version != Version)
+        throw runtime_error("Unknown snapshot format: " + filepath);
+
+    // Liczba rekordów z uszkodzonego nagłówka nie może wymusić alokacji większej niż sam plik.
+    error_code error;
+    const uintmax_t fileSize = filesystem::file_size(filepath, error);
+    const auto headerSize = static_cast<uintmax_t>(inputFile.tellg());
+
+    if (error || fileSize < headerSize || count > (fileSize - headerSize) / RecordCodec::RecordSize)
+        throw runtime_error("Corrupted snapshot: " + filepath);
+
+    string body(count * RecordCodec::RecordSize, '\0');
+
+    if (!inputFile.read(body.data(), static_cast<streamsize>(body.size())) ||
+        RecordCodec::Crc32(body.data(), body.size()) != crc)
+        throw runtime_error("Corrupted snapshot: " + filepath);
+
+    vector<EnergyData> records;
+    records.reserve(count);
+
+    for (size_t offset = 0; offset < body.size(); offset += RecordCodec::RecordSize)
+        records.push_back(RecordCodec::Decode(body.data() + offset));
+
+    consumer(std::move(records));
+
+    return generation;
+}
@@ -0,0 +1,295 @@
+#include "../Headers/SparseIndex.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+
+#include "../Headers/CompressedInput.hpp"
+#include "../Headers/EnergyData.hpp"
+#include "../Headers/RecordCodec.hpp"
+
+/**
+ * @brief Buduje indeks pliku CSV.
+ *
+ * Linie są parsowane tak samo jak przy wczytywaniu pliku, więc znaczniki czasu wpisów
+ * (także z godziny powtarzanej przy zmianie czasu) odpowiadają rekordom analizatora.
+ *
+ * @param filepath Ścieżka do pliku CSV.
+ * @param stride Liczba rekordów pliku przypadająca na jeden wpis indeksu.
+ * @return Zbudowany indeks.
+ * @throws invalid_argument Jeśli `stride` jest równe 0 lub plik jest skompresowany.
+ * @throws runtime_error Jeśli nie można otworzyć pliku.
+ */
+SparseIndex SparseIndex::Build(const string &filepath, const size_t stride) {
+    if (stride == 0) throw invalid_argument("Sparse index stride must be positive");
+
+    // Pozycje w pliku skompresowanym nie pozwalają przeskoczyć do środka danych.
+    if (CompressedInput::DetectFormat(filepath) != CompressedInput::Format::None)
+        throw invalid_argument("Compressed files cannot be indexed: " + filepath);
+
+    // Czas modyfikacji jest odczytywany przed plikiem - zmiana w trakcie budowy unieważni indeks.
+    error_code error;
+    const filesystem::file_time_type writeTime = filesystem::last_write_time(filepath, error);
+
+    ifstream inputFile(filepath);
+
+    if (error || !inputFile.is_open()) throw runtime_error("Could not open file");
+
+    SparseIndex index;
+    string line;
+
+    getline(inputFile, line); // Pomiń pierwszy wiersz (nagłówek)
+
+    const EnergyData::LineParser parser = EnergyData::GetLineParser(CsvDialect::DetectFile(filepath));
+    optional<DateTime> previous;
+    uint64_t lastKey = 0;
+    size_t records = 0;
+    streamoff offset = inputFile.tellg();
+
+    index._dataBegin = offset;
+
+    while (getline(inputFile, line)) {
+        const streamoff lineBegin = offset;
+
+        if (inputFile.eof()) break; // Linia bez znaku końca linii może być jeszcze dopisywana.
+        offset = inputFile.tellg();
+
+        // Niepoprawne linie są pomijane również przy wczytywaniu pliku.
+        if (const optional<EnergyData> record = parser(line, previous, AllColumns, nullptr)) {
+            const uint64_t key = record->GetDateTime().GetSortKey();
+
+            if (key < lastKey) index._ordered = false;
+            lastKey = max(lastKey, key);
+
+            if (records++ % stride == 0) index._entries.push_back({key, lineBegin});
+        }
+    }
+
+    index._fileSize = offset;
+    index._writeTime = writeTime.time_since_epoch().count();
+
+    const optional<uint32_t> tailCrc = GetTailCrc(filepath, index._dataBegin, index._fileSize);
+
+    if (!tailCrc) throw runtime_error("Could not open file");
+
+    index._tailCrc = *tailCrc;
+
+    return index;
+}
+
+/**
+ * @brief Wczytuje indeks z pliku obok pliku CSV, a jeśli go nie ma lub jest nieaktualny - buduje go i zapisuje.
+ *
+ * @param filepath Ścieżka do pliku CSV.
+ * @param stride Liczba rekordów pliku przypadająca na jeden wpis budowanego indeksu.
+ * @return Indeks pliku.
+ * @throws runtime_error Jeśli nie można otworzyć pliku CSV lub zapisać indeksu.
+ */
+SparseIndex SparseIndex::Open(const string &filepath, const size_t stride) {
+    const string indexPath = GetIndexPath(filepath);
+
+    if (filesystem::exists(indexPath)) {
+        try {
+            if (SparseIndex index = Load(indexPath); index.IsCurrent(filepath)) return index;
+        } catch (runtime_error &) {
+            // Uszkodzony indeks jest budowany od nowa.
+        }
+    }
+
+    SparseIndex index = Build(filepath, stride);
+    index.Save(indexPath);
+
+    return index;
+}
+
+/**
+ * @brief Zwraca ścieżkę pliku indeksu dla pliku CSV.
+ *
+ * @param filepath Ścieżka do pliku CSV.
+ * @return Ścieżka pliku indeksu.
+ */
+string SparseIndex::GetIndexPath(const string &filepath) {
+    return filepath + ".idx";
+}
+
+/**
+ * @brief Zapisuje indeks do pliku.
+ *
+ * Plik zawiera nagłówek (sygnatura, wersja, rozmiar i czas modyfikacji pliku CSV, CRC-32 końcówki
+ * pliku CSV, pozycja pierwszej linii danych, znacznik uporządkowania, liczba wpisów, CRC-32 wpisów)
+ * i wpisy w natywnej kolejności bajtów.
+ *
+ * @param filepath Ścieżka do pliku indeksu.
+ * @throws runtime_error Jeśli zapis się nie powiódł.
+ */
+void SparseIndex::Save(const string &filepath) const {
+    const auto *body = reinterpret_cast<const char *>(_entries.data());
+    const size_t bodySize = _entries.size() * sizeof(Entry);
+    const uint64_t count = _entries.size();
+    const uint8_t ordered = _ordered;
+    const uint32_t crc = RecordCodec::Crc32(body, bodySize);
+
+    const string temporary = filepath + ".tmp";
+    ofstream outputFile(temporary, ios::binary | ios::trunc);
+
+    outputFile.write(reinterpret_cast<const char *>(&Magic), sizeof(Magic));
+    outputFile.write(reinterpret_cast<const char *>(&Version), sizeof(Version));
+    outputFile.write(reinterpret_cast<const char *>(&_fileSize), sizeof(_fileSize));
+    outputFile.write(reinterpret_cast<const char *>(&_writeTime), sizeof(_writeTime));
+    outputFile.write(reinterpret_cast<const char *>(&_tailCrc), sizeof(_tailCrc));
+    outputFile.write(reinterpret_cast<const char *>(&_dataBegin), sizeof(_dataBegin));
+    outputFile.write(reinterpret_cast<const char *>(&ordered), sizeof(ordered));
+    outputFile.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    outputFile.write(reinterpret_cast<const char *>(&crc), sizeof(crc));
+    outputFile.write(body, static_cast<streamsize>(bodySize));
+    outputFile.close();
+
+    if (!outputFile) {
+        filesystem::remove(temporary);
+        throw runtime_error("Could not write sparse index: " + temporary);
+    }
+
+    filesystem::rename(temporary, filepath);
+}
+
+/**
+ * @brief Wczytuje indeks zapisany metodą `Save`.
+ *
+ * @param filepath Ścieżka do pliku indeksu.
+ * @return Wczytany indeks.
+ * @throws runtime_error Jeśli plik jest uszkodzony lub ma nieznany format.
+ */
+SparseIndex SparseIndex::Load(const string &filepath) {
+    ifstream inputFile(filepath, ios::binary);
+
+    if (!inputFile.is_open()) throw runtime_error("Could not open sparse index: " + filepath);
+
+    SparseIndex index;
+    uint32_t magic = 0, version = 0, crc = 0;
+    uint64_t count = 0;
+    uint8_t ordered = 0;
+
+    inputFile.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+    inputFile.read(reinterpret_cast<char *>(&version), sizeof(version));
+    inputFile.read(reinterpret_cast<char *>(&index._fileSize), sizeof(index._fileSize));
+    inputFile.read(reinterpret_cast<char *>(&index._writeTime), sizeof(index._writeTime));
+    inputFile.read(reinterpret_cast<char *>(&index._tailCrc), sizeof(index._tailCrc));
+    inputFile.read(reinterpret_cast<char *>(&index._dataBegin), sizeof(index._dataBegin));
+    inputFile.read(reinterpret_cast<char *>(&ordered), sizeof(ordered));
+    inputFile.read(reinterpret_cast<char *>(&count), sizeof(count));
+    inputFile.read(reinterpret_cast<char *>(&crc), sizeof(crc));
+
+    if (!inputFile || magic != Magic || version != Version)
+        throw runtime_error("Unknown sparse index format: " + filepath);
+
+    if (count > index._fileSize) throw runtime_error("Corrupted sparse index: " + filepath);
+
+    index._ordered = ordered != 0;
+    index._entries.resize(count);
+
+    auto *body = reinterpret_cast<char *>(index._entries.data());
+    const size_t bodySize = count * sizeof(Entry);
+
+    if (!inputFile.read(body, static_cast<streamsize>(bodySize)) || RecordCodec::Crc32(body, bodySize) != crc)
+        throw runtime_error("Corrupted sparse index: " + filepath);
+
+    return index;
+}
+
+/**
+ * @brief Sprawdza, czy indeks opisuje aktualną zawartość pliku CSV.
+ *
+ * Sam rozmiar nie wystarcza - plik zapisany od nowa może być nie krótszy niż poprzedni.
+ * Po zmianie czasu modyfikacji plik musi więc urosnąć, a końcówka indeksowanej części
+ * pozostać bez zmian (dopisanie linii).
+ *
+ * @param filepath Ścieżka do pliku CSV.
+ * @return true, jeśli plik jest taki jak w chwili budowy indeksu lub tylko do niego dopisano, false w przeciwnym razie.
+ */
+bool SparseIndex::IsCurrent(const string &filepath) const {
+    error_code error;
+    const uintmax_t size = filesystem::file_size(filepath, error);
+
+    if (error || size < _fileSize) return false;
+
+    const filesystem::file_time_type writeTime = filesystem::last_write_time(filepath, error);
+
+    if (error) return false;
+
+    if (writeTime.time_since_epoch().count() == _writeTime) return true;
+
+    return size > _fileSize && GetTailCrc(filepath, _dataBegin, _fileSize) == _tailCrc;
+}
+
+/**
+ * @brief Oblicza sumę kontrolną końcówki indeksowanej części pliku.
+ *
+ * @param filepath Ścieżka do pliku CSV.
+ * @param dataBegin Pozycja pierwszej linii za nagłówkiem pliku.
+ * @param fileSize Koniec indeksowanej części pliku.
+ * @return CRC-32 końcówki lub nullopt, jeśli nie można jej odczytać.
+ */
+optional<uint32_t> SparseIndex::GetTailCrc(const string &filepath, const int64_t dataBegin, const uint64_t fileSize) {
+    const uint64_t begin = max<uint64_t>(dataBegin, fileSize > TailBytes ? fileSize - TailBytes : 0);
+    string tail(fileSize > begin ? fileSize - begin : 0, '\0');
+    ifstream inputFile(filepath, ios::binary);
+
+    inputFile.seekg(static_cast<streamoff>(begin));
+
+    if (!inputFile.read(tail.data(), static_cast<streamsize>(tail.size()))) return nullopt;
+
+    return RecordCodec::Crc32(tail.data(), tail.size());
+}
+
+/**
+ * @brief Wyznacza fragment pliku zawierający wszystkie rekordy z przedziału czasowego.
+ *
+ * Przedział jest rozszerzany do pełnych dni - klucze jednego dnia tworzą ciągły zakres
+ * (patrz `DateTime::GetSortKey`), a zapytania na brzegach przedziału mogą sięgać do godziny
+ * powtarzanej przy zmianie czasu. Fragment zaczyna się od ostatniego wpisu wcześniejszego
+ * niż przedział i kończy na pierwszym wpisie późniejszym od niego.
+ *
+ * @param start Wskaźnik do obiektu DateTime określającego początek przedziału czasowego.
+ * @param end Wskaźnik do obiektu DateTime określającego koniec przedziału czasowego.
+ * @return Fragment pliku do wczytania.
+ */
+SparseIndex::Slice SparseIndex::Locate(const DateTime *start, const DateTime *end) const {
+    if (!_ordered) return {_dataBegin, -1, nullopt};
+
+    constexpr uint64_t dayMask = (1ull << 12) - 1;
+    const uint64_t low = start->GetSortKey() & ~dayMask;
+    const uint64_t high = end->GetSortKey() | dayMask;
+
+    const auto first = lower_bound(_entries.begin(), _entries.end(), low,
+                                   [](const Entry &entry, const uint64_t key) { return entry.Key < key; });
+    const auto last = upper_bound(_entries.begin(), _entries.end(), high,
+                                  [](const uint64_t key, const Entry &entry) { return key < entry.Key; });
+
+    Slice slice{_dataBegin, last == _entries.end() ? -1 : last->Offset, nullopt};
+
+    if (first != _entries.begin()) {
+        const Entry &entry = *prev(first);
+        const DateTime dateTime = DateTime::FromSortKey(entry.Key);
+
+        slice.Begin = entry.Offset;
+
+        // Linia z godziny powtarzanej jest rozpoznawana po poprzednim znaczniku czasu -
+        // wystarczy podać jej własny znacznik, który też należy do tej godziny.
+        if (dateTime.IsRepeated()) slice.Previous = dateTime;
+    }
+
+    if (low > high) slice.End = slice.Begin;
+
+    return slice;
+}
+
+/**
+ * @brief Zwraca liczbę wpisów indeksu.
+ *
+ * @return Liczba wpisów.
+ */
+size_t SparseIndex::GetEntryCount() const {
+    return _entries.size();
+}
@@ -0,0 +1,197 @@
+#include "../Headers/StreamingAggregator.hpp"
+
+#include <iostream>
+
+#include "../Headers/CommandParser.hpp"
+
+/**
+ * @brief Konstruktor klasy StreamingAggregator.
+ *
+ * @param duplicatePolicy Sposób rozstrzygania sąsiadujących odczytów o tym samym znaczniku czasu.
+ */
+StreamingAggregator::StreamingAggregator(const DuplicatePolicy duplicatePolicy) : _duplicatePolicy(duplicatePolicy) {
+}
+
+/**
+ * @brief Parsuje komendę i dodaje ją do listy obliczanych komend.
+ *
+ * @param command Komenda `SUMA`, `SREDNIA` lub `POROWNAJ`.
+ * @return true, jeśli komenda została dodana, false w przeciwnym razie.
+ */
+bool StreamingAggregator::AddCommand(const string &command) {
+    const vector<string> tokens = CommandParser::Tokenize(command);
+
+    if (tokens.empty()) {
+        cerr << "Pusta komenda." << endl;
+        return false;
+    }
+
+    const string &name = tokens[0];
+
+    if (name != "SUMA" && name != "SREDNIA" && name != "POROWNAJ") {
+        cerr << "Komenda nie jest obsługiwana w trybie strumieniowym: " << name << endl;
+        return false;
+    }
+
+    if (tokens.size() < (name == "POROWNAJ" ? 15 : 8)) {
+        cerr << "Błąd: Nieprawidłowa liczba argumentów dla komendy " << name << "." << endl;
+        return false;
+    }
+
+    const optional<Metric> metric = CommandParser::ParseMetric(tokens[1]);
+    Query query{name, tokens[1], metric.value_or(Metric::AutoConsumption), {}};
+
+    size_t index = 2;
+
+    if (!ParseRange(tokens, index, query.Ranges)) return false;
+
+    if (name == "POROWNAJ") {
+        if (tokens[index++] != "Z") {
+            cerr << "Błąd: Brak słowa kluczowego Z" << endl;
+            return false;
+        }
+
+        if (!ParseRange(tokens, index, query.Ranges)) return false;
+    }
+
+    if (!metric) {
+        cerr << "Błąd: Nieznany typ dla komendy " << name << ": " << query.Type << endl;
+        return false;
+    }
+
+    _columns |= ColumnOf(query.Quantity);
+    _queries.push_back(std::move(query));
+
+    return true;
+}
+
+/**
+ * @brief Wczytuje plik CSV i dodaje jego rekordy do liczników komend.
+ *
+ * Rekordy przechodzą przez `DuplicateResolver`, który pamięta najwyżej jeden oczekujący
+ * rekord, więc pamięć nie zależy od rozmiaru pliku.
+ *
+ * @param filepath Ścieżka do pliku CSV.
+ * @return Liczba rekordów dodanych do liczników.
+ * @throws runtime_error Jeśli nie można otworzyć pliku.
+ */
+size_t StreamingAggregator::Run(const string &filepath) {
+    size_t records = 0;
+
+    DuplicateResolver resolver(_duplicatePolicy, [this, &records](EnergyData &&record, int) {
+        Accumulate(record);
+        ++records;
+    });
+
+    // Log każdej sparsowanej linii podwoiłby na dysku plik większy niż pamięć - zapisywane są tylko błędy.
+    EnergyData::ReadEnergyData(filepath, [&resolver](EnergyData &&record) {
+        resolver.Push(std::move(record));
+    }, _columns, LineLogging::ErrorsOnly);
+
+    resolver.Flush();
+
+    return records;
+}
+
+/**
+ * @brief Wypisuje wyniki wszystkich komend w kolejności ich dodania.
+ */
+void StreamingAggregator::PrintResults() const {
+    for (const Query &query: _queries) {
+        const Range &range = query.Ranges[0];
+
+        if (query.Name == "POROWNAJ") {
+            const Range &other = query.Ranges[1];
+
+            cout << "Wywołano komendę POROWNAJ dla " << query.Type << " w przedziałach od " << range.Start.ToString()
+                    << " do " << range.End.ToString() << " oraz od " << other.Start.ToString() << " do "
+                    << other.End.ToString() << endl;
+
+            CommandParser::PrintComparison(query.Quantity, range.Start, range.End, range.Sum, other.Start, other.End,
+                                           other.Sum);
+
+            continue;
+        }
+
+        cout << "Wywołano komendę " << query.Name << " dla " << query.Type << " w przedziale od " << range.Start.ToString() << " do " << range.End.ToString() << endl;
+
+        if (query.Name == "SUMA")
+            CommandParser::PrintSum(query.Quantity, range.Sum);
+        else
+            CommandParser::PrintAverage(query.Quantity, range.Count == 0 ? 0 : range.Sum / range.Count);
+    }
+}
+
+/**
+ * @brief Dodaje rekord do liczników wszystkich przedziałów, do których należy.
+ *
+ * @param record Rekord.
+ */
+void StreamingAggregator::Accumulate(const EnergyData &record) {
+    const int64_t minute = GetMinuteKey(record.GetDateTime());
+    const double values[MetricCount] = {
+        record.GetAutoConsumption(), record.GetExport(), record.GetImport(), record.GetConsumption(),
+        record.GetGeneration()
+    };
+
+    for (Query &query: _queries) {
+        const double value = values[static_cast<int>(query.Quantity)];
+
+        for (Range &range: query.Ranges) {
+            if (minute < range.FirstMinute || minute > range.LastMinute) continue;
+
+            range.Sum += value;
+            ++range.Count;
+        }
+    }
+}
+
+/**
+ * @brief Zwraca klucz porządkujący datę i minutę doby.
+ *
+ * @param dateTime Data i godzina.
+ * @return Klucz minuty.
+ */
+int64_t StreamingAggregator::GetMinuteKey(const DateTime &dateTime) {
+    const int64_t date = (static_cast<int64_t>(dateTime.GetYear()) * 12 + dateTime.GetMonth()) * 31 + dateTime.GetDay();
+
+    return date * 24 * 60 + dateTime.GetHour() * 60 + dateTime.GetMinute();
+}
+
+/**
+ * @brief Parsuje przedział `OD <data> DO <data>`.
+ *
+ * @param tokens Tokeny komendy.
+ * @param index Indeks tokenu `OD` (przesuwany za przedział).
+ * @param ranges Wektor, do którego dodawany jest przedział.
+ * @return true, jeśli przedział jest poprawny, false w przeciwnym razie.
+ */
+bool StreamingAggregator::ParseRange(const vector<string> &tokens, size_t &index, vector<Range> &ranges) {
+    if (tokens[index++] != "OD") {
+        cerr << "Błąd: Brak słowa kluczowego OD" << endl;
+        return false;
+    }
+
+    const DateTime *start = CommandParser::ParseDateTime(tokens, index);
+
+    if (tokens[index++] != "DO") {
+        cerr << "Błąd: Brak słowa kluczowego DO" << endl;
+        delete start;
+        return false;
+    }
+
+    const DateTime *end = CommandParser::ParseDateTime(tokens, index);
+
+    if (start == nullptr || end == nullptr) {
+        delete start;
+        delete end;
+        return false;
+    }
+
+    ranges.push_back({*start, *end, GetMinuteKey(*start), GetMinuteKey(*end)});
+
+    delete start;
+    delete end;
+
+    return true;
+}
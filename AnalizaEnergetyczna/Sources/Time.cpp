@@ -1,8 +1,9 @@
 #include "../Headers/Time.hpp"
 
-Time::Time(const int hour, const int minute) {
+Time::Time(const int hour, const int minute, const bool repeated) {
     _hour = hour;
     _minute = minute;
+    _repeated = repeated;
 }
 
 
@@ -14,12 +15,22 @@ int Time::GetMinute() const {
     return _minute;
 }
 
+int Time::GetMinuteOfDay() const {
+    return _hour * 60 + _minute;
+}
+
+bool Time::IsRepeated() const {
+    return _repeated;
+}
+
 bool Time::operator<(const Time& other) const {
     if (_hour != other._hour) return _hour < other._hour;
+    if (_repeated != other._repeated) return other._repeated;
     return _minute < other._minute;
 }
 
 bool Time::operator>(const Time& other) const {
     if (_hour != other._hour) return _hour > other._hour;
+    if (_repeated != other._repeated) return _repeated;
     return _minute > other._minute;
 }
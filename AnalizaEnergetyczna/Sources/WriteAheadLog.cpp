@@ -0,0 +1,203 @@
+#include "../Headers/WriteAheadLog.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "../Headers/RecordCodec.hpp"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Konstruktor klasy WriteAheadLog.
+ *
+ * @param filepath Ścieżka do pliku dziennika.
+ * @throws runtime_error Jeśli nie można otworzyć pliku.
+ */
+WriteAheadLog::WriteAheadLog(const string &filepath) {
+    _file = fopen(filepath.c_str(), "ab");
+
+    if (_file == nullptr) throw runtime_error("Could not open write-ahead log: " + filepath);
+
+    error_code error;
+    _size = filesystem::file_size(filepath, error);
+    if (error) _size = 0;
+}
+
+/**
+ * @brief Destruktor klasy WriteAheadLog.
+ *
+ * Zapisuje oczekujące wpisy i zamyka plik.
+ */
+WriteAheadLog::~WriteAheadLog() {
+    try {
+        Flush();
+    } catch (exception &) {
+        // Wpisy, których nie udało się zapisać, nie były potwierdzone żadnemu wywołującemu.
+    }
+
+    fclose(_file);
+}
+
+/**
+ * @brief Dodaje wpis do bufora grupowego zapisu.
+ *
+ * @param operation Rodzaj operacji.
+ * @param records Rekordy partii.
+ * @return Numer kolejny wpisu.
+ */
+uint64_t WriteAheadLog::Enqueue(const Operation operation, const vector<EnergyData> &records) {
+    string payload;
+    payload.reserve(1 + records.size() * RecordCodec::RecordSize);
+    payload.push_back(static_cast<char>(operation));
+
+    for (const EnergyData &record: records) RecordCodec::Encode(record, payload);
+
+    const auto size = static_cast<uint32_t>(payload.size());
+    const uint32_t crc = RecordCodec::Crc32(payload.data(), payload.size());
+
+    lock_guard lock(_mutex);
+
+    _pending.append(reinterpret_cast<const char *>(&size), sizeof(size));
+    _pending.append(reinterpret_cast<const char *>(&crc), sizeof(crc));
+    _pending.append(payload);
+    _size += sizeof(size) + sizeof(crc) + payload.size();
+
+    return ++_lastQueued;
+}
+
+/**
+ * @brief Czeka, aż wpis zostanie zapisany na dysku.
+ *
+ * Pierwszy wątek, który zastanie niezapisane wpisy, zabiera cały bufor, zapisuje go
+ * i wywołuje fsync poza blokadą; pozostałe wątki w tym czasie dokładają kolejne wpisy
+ * do nowego bufora albo czekają na zakończenie zapisu obejmującego ich wpis.
+ *
+ * @param sequence Numer wpisu.
+ * @throws runtime_error Jeśli zapis do pliku się nie powiódł.
+ */
+void WriteAheadLog::WaitDurable(const uint64_t sequence) {
+    unique_lock lock(_mutex);
+
+    while (_lastDurable < sequence) {
+        if (_failed) throw runtime_error("Write-ahead log write failed");
+
+        if (_writing) {
+            _durableChanged.wait(lock);
+            continue;
+        }
+
+        _writing = true;
+
+        const string buffer = std::move(_pending);
+        const uint64_t covered = _lastQueued;
+        _pending.clear();
+
+        lock.unlock();
+        const bool written = fwrite(buffer.data(), 1, buffer.size(), _file) == buffer.size() && fflush(_file) == 0 &&
+                             Sync();
+        lock.lock();
+
+        _writing = false;
+        if (written) _lastDurable = covered;
+        else _failed = true;
+
+        _durableChanged.notify_all();
+    }
+}
+
+/**
+ * @brief Zapisuje na dysku wszystkie dotąd zgłoszone wpisy.
+ */
+void WriteAheadLog::Flush() {
+    uint64_t last;
+
+    {
+        lock_guard lock(_mutex);
+        last = _lastQueued;
+    }
+
+    WaitDurable(last);
+}
+
+/**
+ * @brief Zwraca rozmiar dziennika w bajtach.
+ *
+ * @return Rozmiar dziennika.
+ */
+uintmax_t WriteAheadLog::GetSize() const {
+    lock_guard lock(_mutex);
+
+    return _size;
+}
+
+/**
+ * @brief Odtwarza wpisy z pliku dziennika.
+ *
+ * @param filepath Ścieżka do pliku dziennika.
+ * @param consumer Funkcja wywoływana dla każdego poprawnego wpisu.
+ * @return Liczba odtworzonych wpisów.
+ */
+size_t WriteAheadLog::Replay(const string &filepath,
+                             const function<void(Operation, vector<EnergyData> &&)> &consumer) {
+    ifstream inputFile(filepath, ios::binary);
+
+    if (!inputFile.is_open()) return 0;
+
+    size_t count = 0;
+    streamoff validEnd = 0;
+    string payload;
+
+    while (true) {
+        uint32_t size, crc;
+
+        if (!inputFile.read(reinterpret_cast<char *>(&size), sizeof(size)) ||
+            !inputFile.read(reinterpret_cast<char *>(&crc), sizeof(crc)))
+            break;
+
+        if (size == 0 || (size - 1) % RecordCodec::RecordSize != 0) break;
+
+        payload.resize(size);
+        if (!inputFile.read(payload.data(), size) || RecordCodec::Crc32(payload.data(), size) != crc) break;
+
+        const auto operation = static_cast<Operation>(payload[0]);
+        if (operation != Operation::Append && operation != Operation::Upsert) break;
+
+        vector<EnergyData> records;
+        records.reserve((size - 1) / RecordCodec::RecordSize);
+
+        for (size_t offset = 1; offset < size; offset += RecordCodec::RecordSize)
+            records.push_back(RecordCodec::Decode(payload.data() + offset));
+
+        consumer(operation, std::move(records));
+
+        validEnd = inputFile.tellg();
+        ++count;
+    }
+
+    inputFile.close();
+
+    // Odetnij niedokończony wpis, aby kolejne wpisy nie zostały dopisane za uszkodzonymi danymi.
+    if (error_code error; static_cast<streamoff>(filesystem::file_size(filepath, error)) > validEnd && !error)
+        filesystem::resize_file(filepath, validEnd, error);
+
+    return count;
+}
+
+/**
+ * @brief Wymusza zapis buforów pliku na dysku.
+ *
+ * @return true, jeśli się udało, false w przeciwnym razie.
+ */
+bool WriteAheadLog::Sync() const {
+#ifdef _WIN32
+    return _commit(_fileno(_file)) == 0;
+#else
+    return fsync(fileno(_file)) == 0;
+#endif
+}
@@ -10,17 +10,21 @@
 Year::Year(const int year) {
     _year = year;
     _months = new vector<Month*>();
+    _aggregate = new Aggregate();
+    _sketch = new QuantileSketch();
 }
 
 /**
  * @brief Destruktor klasy Year.
  * 
- * Zwalnia pamięć zaalokowaną dla obiektów Month przechowywanych w wektorze oraz dla samego wektora.
+ * Zwalnia pamięć zaalokowaną dla obiektów Month przechowywanych w wektorze, dla samego wektora, dla agregatu oraz dla szkicu.
  */
 Year::~Year() {
     for (const Month* month : *_months) delete month;
 
     delete _months;
+    delete _aggregate;
+    delete _sketch;
 }
 
 /**
@@ -39,4 +43,22 @@ int Year::GetYear() const {
  */
 vector<Month*>& Year::GetMonths() const {
     return *_months;
+}
+
+/**
+ * @brief Zwraca agregat danych roku.
+ *
+ * @return Referencja do agregatu.
+ */
+Aggregate& Year::GetAggregate() const {
+    return *_aggregate;
+}
+
+/**
+ * @brief Zwraca szkic rozkładu wartości danych roku.
+ *
+ * @return Referencja do szkicu.
+ */
+QuantileSketch& Year::GetSketch() const {
+    return *_sketch;
 }
\ No newline at end of file